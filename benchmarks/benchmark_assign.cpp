@@ -0,0 +1,46 @@
+#include <uni20/level1/assign.hpp>
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+using namespace uni20;
+
+namespace
+{
+
+using extents_2d = stdex::dextents<std::ptrdiff_t, 2>;
+using strided_matrix = stdex::mdspan<double, extents_2d, stdex::layout_stride>;
+
+strided_matrix make_view(std::vector<double>& data, std::ptrdiff_t rows, std::ptrdiff_t cols, bool transposed)
+{
+  std::array<std::ptrdiff_t, 2> strides = transposed ? std::array<std::ptrdiff_t, 2>{1, rows}
+                                                     : std::array<std::ptrdiff_t, 2>{cols, 1};
+  return strided_matrix(data.data(), stdex::layout_stride::mapping<extents_2d>(extents_2d(rows, cols), strides));
+}
+
+/// Copy an n×n matrix into a destination of the same layout (\p transposed = false) or the opposite layout.
+void AssignCopy(benchmark::State& state, bool transposed)
+{
+  auto const n = std::ptrdiff_t(state.range(0));
+  std::vector<double> src_data(std::size_t(n * n), 1.0), dst_data(std::size_t(n * n));
+  auto src = make_view(src_data, n, n, false);
+  auto dst = make_view(dst_data, n, n, transposed);
+
+  for (auto _ : state)
+  {
+    assign(src, dst);
+    benchmark::DoNotOptimize(dst_data.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 2 * n * n * int64_t(sizeof(double)));
+}
+
+void AssignContiguous(benchmark::State& state) { AssignCopy(state, false); }
+void AssignTransposed(benchmark::State& state) { AssignCopy(state, true); }
+
+} // namespace
+
+BENCHMARK(AssignContiguous)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(AssignTransposed)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,170 @@
+#include <uni20/core/types.hpp>
+#include <uni20/kernel/contract.hpp>
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+namespace
+{
+
+template <std::size_t R> using view_extents = stdex::dextents<std::ptrdiff_t, R>;
+
+template <typename T, std::size_t R> using strided_view = stdex::mdspan<T, view_extents<R>, stdex::layout_stride>;
+
+/// Dense tensor whose legs are laid out in memory in the order given by \p order (first entry slowest).
+template <typename T, std::size_t R> struct dense_tensor
+{
+    std::vector<T> data;
+    strided_view<T, R> view;
+
+    dense_tensor(std::array<std::size_t, R> extents, std::array<std::size_t, R> order)
+    {
+      std::array<std::ptrdiff_t, R> strides{};
+      std::ptrdiff_t size = 1;
+      for (std::size_t i = R; i-- > 0;)
+      {
+        strides[order[i]] = size;
+        size *= static_cast<std::ptrdiff_t>(extents[order[i]]);
+      }
+      data.resize(static_cast<std::size_t>(size));
+      for (std::size_t x = 0; x < data.size(); ++x)
+        data[x] = T(static_cast<float>(x % 17) / 16 - 0.5f);
+      view = strided_view<T, R>(
+          data.data(), typename stdex::layout_stride::mapping<view_extents<R>>(view_extents<R>(extents), strides));
+    }
+
+    std::size_t bytes() const noexcept { return data.size() * sizeof(T); }
+};
+
+template <typename T, std::size_t R> dense_tensor<T, R> row_major(std::array<std::size_t, R> extents)
+{
+  std::array<std::size_t, R> order{};
+  for (std::size_t i = 0; i < R; ++i)
+    order[i] = i;
+  return dense_tensor<T, R>(extents, order);
+}
+
+/// Real floating-point operations per multiply-add.
+template <typename T> constexpr double flops_per_madd = is_complex<T> ? 8.0 : 2.0;
+
+/// Report GFLOP/s for an m·n·k contraction and the effective bandwidth of reading A and B and updating C.
+template <typename T>
+void set_counters(benchmark::State& state, double madds, std::size_t a_bytes, std::size_t b_bytes, std::size_t c_bytes)
+{
+  state.counters["GFLOP"] =
+      benchmark::Counter(madds * flops_per_madd<T> * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["GB"] = benchmark::Counter(static_cast<double>(a_bytes + b_bytes + 2 * c_bytes) * 1e-9,
+                                            benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/// C(i,j) = A(i,k)·B(k,j) with all operands row-major and extents n×n×n.
+template <typename T, typename Tag> void ContractMatrix(benchmark::State& state)
+{
+  auto const n = static_cast<std::size_t>(state.range(0));
+  auto A = row_major<T, 2>({n, n});
+  auto B = row_major<T, 2>({n, n});
+  auto C = row_major<T, 2>({n, n});
+  for (auto _ : state)
+  {
+    contract(T(1), A.view, B.view, {{1, 0}}, T(0), C.view, Tag{});
+    benchmark::DoNotOptimize(C.data.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters<T>(state, double(n) * n * n, A.bytes(), B.bytes(), C.bytes());
+}
+
+/// C(i,j) = A(p,i,q)·B(q,j,p) with n×n output and two contracted legs of extent s, so no operand is a matrix.
+template <typename T, typename Tag> void ContractPermuted(benchmark::State& state)
+{
+  auto const n = static_cast<std::size_t>(state.range(0));
+  auto const s = static_cast<std::size_t>(state.range(1));
+  auto A = row_major<T, 3>({s, n, s});
+  auto B = row_major<T, 3>({s, n, s});
+  auto C = dense_tensor<T, 2>({n, n}, {1, 0});
+  std::array<std::pair<std::size_t, std::size_t>, 2> dims{{{0, 2}, {2, 0}}};
+  for (auto _ : state)
+  {
+    contract(T(1), A.view, B.view, dims, T(0), C.view, Tag{});
+    benchmark::DoNotOptimize(C.data.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters<T>(state, double(n) * n * s * s, A.bytes(), B.bytes(), C.bytes());
+}
+
+/// Rank-6 operands with small extent d, three legs contracted and the open legs interleaved in C.
+template <typename T, typename Tag> void ContractHighRank(benchmark::State& state)
+{
+  auto const d = static_cast<std::size_t>(state.range(0));
+  // A(i0,k0,i1,k1,i2,k2), B(k2,j0,k1,j1,k0,j2), C(i0,j0,i1,j1,i2,j2)
+  auto A = row_major<T, 6>({d, d, d, d, d, d});
+  auto B = row_major<T, 6>({d, d, d, d, d, d});
+  auto C = dense_tensor<T, 6>({d, d, d, d, d, d}, {0, 2, 4, 1, 3, 5});
+  std::array<std::pair<std::size_t, std::size_t>, 3> dims{{{1, 4}, {3, 2}, {5, 0}}};
+  for (auto _ : state)
+  {
+    contract(T(1), A.view, B.view, dims, T(0), C.view, Tag{});
+    benchmark::DoNotOptimize(C.data.data());
+    benchmark::ClobberMemory();
+  }
+  double const d3 = double(d) * d * d;
+  set_counters<T>(state, d3 * d3 * d3, A.bytes(), B.bytes(), C.bytes());
+}
+
+/// C(b,i,j) = A(b,i,k)·B(k,b,j): nb independent n×n×n products sharing the batch leg.
+template <typename T, typename Tag> void ContractBatched(benchmark::State& state)
+{
+  auto const nb = static_cast<std::size_t>(state.range(0));
+  auto const n = static_cast<std::size_t>(state.range(1));
+  auto A = row_major<T, 3>({nb, n, n});
+  auto B = row_major<T, 3>({n, nb, n});
+  auto C = row_major<T, 3>({nb, n, n});
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{2, 0}}};
+  std::array<std::pair<std::size_t, std::size_t>, 1> batch{{{0, 1}}};
+  for (auto _ : state)
+  {
+    contract_batched(T(1), A.view, B.view, dims, batch, T(0), C.view, Tag{});
+    benchmark::DoNotOptimize(C.data.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters<T>(state, double(nb) * n * n * n, A.bytes(), B.bytes(), C.bytes());
+}
+
+void ContractMatrixArgs(benchmark::internal::Benchmark* b) { b->ArgName("n")->RangeMultiplier(4)->Range(16, 1024); }
+
+void ContractPermutedArgs(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"n", "s"})->Args({64, 8})->Args({256, 16})->Args({512, 16});
+}
+
+void ContractHighRankArgs(benchmark::internal::Benchmark* b) { b->ArgName("d")->DenseRange(2, 6, 2); }
+
+void ContractBatchedArgs(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"batch", "n"})->Args({256, 8})->Args({64, 32})->Args({16, 128});
+}
+
+} // namespace
+
+#define UNI20_CONTRACT_BENCHMARK(Pattern, Tag)                                                                        \
+  BENCHMARK_TEMPLATE(Pattern, float, Tag)->Apply(Pattern##Args)->Unit(benchmark::kMicrosecond);                      \
+  BENCHMARK_TEMPLATE(Pattern, double, Tag)->Apply(Pattern##Args)->Unit(benchmark::kMicrosecond);                     \
+  BENCHMARK_TEMPLATE(Pattern, cfloat, Tag)->Apply(Pattern##Args)->Unit(benchmark::kMicrosecond);                     \
+  BENCHMARK_TEMPLATE(Pattern, cdouble, Tag)->Apply(Pattern##Args)->Unit(benchmark::kMicrosecond)
+
+UNI20_CONTRACT_BENCHMARK(ContractMatrix, cpu_tag);
+UNI20_CONTRACT_BENCHMARK(ContractPermuted, cpu_tag);
+UNI20_CONTRACT_BENCHMARK(ContractHighRank, cpu_tag);
+UNI20_CONTRACT_BENCHMARK(ContractBatched, cpu_tag);
+
+#if UNI20_BACKEND_BLAS
+UNI20_CONTRACT_BENCHMARK(ContractMatrix, blas_tag);
+UNI20_CONTRACT_BENCHMARK(ContractPermuted, blas_tag);
+UNI20_CONTRACT_BENCHMARK(ContractHighRank, blas_tag);
+UNI20_CONTRACT_BENCHMARK(ContractBatched, blas_tag);
+#endif
@@ -0,0 +1,104 @@
+#include <uni20/level1/assign.hpp>
+#include <uni20/level1/permute.hpp>
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+using namespace uni20;
+
+namespace
+{
+
+template <std::size_t R> using view_extents = stdex::dextents<std::ptrdiff_t, R>;
+
+template <typename T, std::size_t R>
+stdex::mdspan<T, view_extents<R>, stdex::layout_stride> row_major_view(std::vector<T>& data,
+                                                                       std::array<std::ptrdiff_t, R> extents)
+{
+  std::array<std::ptrdiff_t, R> strides{};
+  std::ptrdiff_t size = 1;
+  for (std::size_t i = R; i-- > 0;)
+  {
+    strides[i] = size;
+    size *= extents[i];
+  }
+  data.resize(std::size_t(size));
+  return {data.data(), stdex::layout_stride::mapping<view_extents<R>>(view_extents<R>(extents), strides)};
+}
+
+/// Report the bandwidth of reading the source and writing the destination once.
+template <typename T> void set_bytes(benchmark::State& state, std::size_t elements)
+{
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(2 * elements * sizeof(T)));
+}
+
+/// n×n matrix transpose.
+template <typename T> void PermuteTranspose(benchmark::State& state)
+{
+  auto const n = std::ptrdiff_t(state.range(0));
+  std::vector<T> a, b;
+  auto src = row_major_view<T, 2>(a, {n, n});
+  auto dst = row_major_view<T, 2>(b, {n, n});
+  for (auto& x : a)
+    x = T(1);
+
+  for (auto _ : state)
+  {
+    permute(src, std::array<std::size_t, 2>{1, 0}, dst);
+    benchmark::ClobberMemory();
+  }
+  set_bytes<T>(state, a.size());
+}
+
+/// Rank-4 permutation (3, 1, 2, 0) of a tensor with extents n×8×8×n, as in the reshaping of an MPS tensor.
+template <typename T> void PermuteRank4(benchmark::State& state)
+{
+  auto const n = std::ptrdiff_t(state.range(0));
+  std::vector<T> a, b;
+  auto src = row_major_view<T, 4>(a, {n, 8, 8, n});
+  auto dst = row_major_view<T, 4>(b, {n, 8, 8, n});
+  for (auto& x : a)
+    x = T(1);
+
+  for (auto _ : state)
+  {
+    permute(src, std::array<std::size_t, 4>{3, 1, 2, 0}, dst);
+    benchmark::ClobberMemory();
+  }
+  set_bytes<T>(state, a.size());
+}
+
+/// The same transpose as a plain copy with permuted strides, for comparison.
+template <typename T> void AssignTranspose(benchmark::State& state)
+{
+  auto const n = std::ptrdiff_t(state.range(0));
+  std::vector<T> a, b;
+  auto src = row_major_view<T, 2>(a, {n, n});
+  auto dst = row_major_view<T, 2>(b, {n, n});
+  for (auto& x : a)
+    x = T(1);
+  stdex::mdspan<T, view_extents<2>, stdex::layout_stride> transposed(
+      dst.data_handle(),
+      stdex::layout_stride::mapping<view_extents<2>>(view_extents<2>(n, n), std::array<std::ptrdiff_t, 2>{1, n}));
+
+  for (auto _ : state)
+  {
+    assign(src, transposed);
+    benchmark::ClobberMemory();
+  }
+  set_bytes<T>(state, a.size());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(PermuteTranspose, float)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(PermuteTranspose, double)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(PermuteTranspose, std::complex<double>)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(AssignTranspose, double)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(PermuteRank4, double)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,42 @@
+#include <uni20/storage/buffer_pool.hpp>
+#include <uni20/tensor/basic_tensor.hpp>
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+using namespace uni20;
+
+namespace
+{
+
+using extents_2d = stdex::dextents<index_type, 2>;
+
+/// Allocate an n×n output tensor, write every element once and release it: the pattern of a contraction with
+/// beta = 0 into a fresh tensor.
+template <typename StoragePolicy, typename... Tag> void AllocateAndFill(benchmark::State& state, Tag... tag)
+{
+  auto const n = index_type(state.range(0));
+  for (auto _ : state)
+  {
+    BasicTensor<double, extents_2d, StoragePolicy> t(tag..., extents_2d(n, n));
+    double* p = t.storage().data();
+    for (index_type i = 0; i < n * n; ++i)
+      p[i] = 1.0;
+    benchmark::DoNotOptimize(p);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * n * n * int64_t(sizeof(double)));
+}
+
+void AllocateVector(benchmark::State& state) { AllocateAndFill<VectorStorage>(state); }
+void AllocateUninitialized(benchmark::State& state)
+{
+  AllocateAndFill<UninitializedStorage>(state, uninitialized);
+}
+void AllocatePooled(benchmark::State& state) { AllocateAndFill<PooledStorage>(state, uninitialized); }
+
+} // namespace
+
+BENCHMARK(AllocateVector)->Arg(256)->Arg(2048);
+BENCHMARK(AllocateUninitialized)->Arg(256)->Arg(2048);
+BENCHMARK(AllocatePooled)->Arg(256)->Arg(2048);
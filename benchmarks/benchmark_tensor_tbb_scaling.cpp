@@ -11,12 +11,13 @@ using namespace uni20::async;
 namespace
 {
 using extents_type = stdex::dextents<index_type, 2>;
-using tensor_type = BasicTensor<float, extents_type>;
+// Inputs are handed to the tasks by value; SharedStorage makes that a reference-count increment.
+using tensor_type = BasicTensor<float, extents_type, SharedStorage>;
 
-AsyncTask row_scale_add(tensor_type const* lhs, tensor_type const* rhs, tensor_type* out, std::size_t row, float scale)
+AsyncTask row_scale_add(tensor_type lhs, tensor_type rhs, tensor_type* out, std::size_t row, float scale)
 {
-  auto lhs_view = lhs->mdspan();
-  auto rhs_view = rhs->mdspan();
+  auto lhs_view = lhs.mdspan();
+  auto rhs_view = rhs.mdspan();
   auto out_view = out->mutable_mdspan();
   auto const cols = static_cast<std::size_t>(out_view.extents().extent(1));
 
@@ -28,9 +29,9 @@ AsyncTask row_scale_add(tensor_type const* lhs, tensor_type const* rhs, tensor_t
   co_return;
 }
 
-AsyncTask row_sum_task(tensor_type const* tensor, WriteBuffer<float> out, std::size_t row)
+AsyncTask row_sum_task(tensor_type tensor, WriteBuffer<float> out, std::size_t row)
 {
-  auto view = tensor->mdspan();
+  auto view = tensor.mdspan();
   auto const cols = static_cast<std::size_t>(view.extents().extent(1));
   float accum = 0.0F;
 
@@ -71,7 +72,7 @@ static void TensorScaleAddTbb(benchmark::State& state)
   for (auto _ : state)
   {
     for (std::size_t row = 0; row < rows; ++row)
-      sched.schedule(row_scale_add(&lhs, &rhs, &out, row, 1.5F));
+      sched.schedule(row_scale_add(lhs, rhs, &out, row, 1.5F));
 
     sched.run_all();
     benchmark::DoNotOptimize(out);
@@ -103,7 +104,7 @@ static void TensorRowReductionTbb(benchmark::State& state)
   {
     std::vector<Async<float>> partials(rows);
     for (std::size_t row = 0; row < rows; ++row)
-      sched.schedule(row_sum_task(&tensor, partials[row].write(), row));
+      sched.schedule(row_sum_task(tensor, partials[row].write(), row));
 
     sched.run_all();
 
@@ -103,6 +103,10 @@ class TbbScheduler final : public IScheduler {
       }
     }
 
+    /// \brief Access the task arena whose worker threads run this scheduler's tasks.
+    /// \note Useful for running data-parallel kernels (e.g. kernel::contract_parallel) on the same threads.
+    oneapi::tbb::task_arena& arena() noexcept { return arena_; }
+
     void help_while_waiting(const WaitPredicate& is_ready) override { this->wait_for(is_ready); }
 
     void wait_for(const WaitPredicate& is_ready) override
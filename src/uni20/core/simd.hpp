@@ -0,0 +1,222 @@
+#pragma once
+
+/**
+ * \file simd.hpp
+ * \ingroup core_math
+ * \brief Portable SIMD layer for contiguous elementwise loops.
+ * \details When `<experimental/simd>` is available, a loop over an arithmetic element type whose functor is
+ *          wrapped in simd::simd_op runs on native-width SIMD registers, followed by a scalar remainder loop.
+ *          Otherwise the loop runs over raw pointers, free of the accessor and tuple indirection that tends to
+ *          defeat the auto-vectoriser.
+ */
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_lib_experimental_parallel_simd)
+#define UNI20_HAS_STD_SIMD 1
+#else
+#define UNI20_HAS_STD_SIMD 0
+#endif
+
+/// \brief Hint that the following loop carries no dependency between iterations.
+/// \ingroup core_math
+#if defined(__clang__)
+#define UNI20_VECTORIZE_LOOP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define UNI20_VECTORIZE_LOOP _Pragma("GCC ivdep")
+#else
+#define UNI20_VECTORIZE_LOOP
+#endif
+
+namespace uni20::simd
+{
+
+#if UNI20_HAS_STD_SIMD
+namespace stdx = std::experimental;
+
+/// \brief Native-width SIMD vector of \p T.
+/// \ingroup core_math
+template <typename T> using native = stdx::native_simd<T>;
+
+/// \brief True if \p T can be held in a native SIMD vector.
+/// \ingroup core_math
+template <typename T> inline constexpr bool vectorizable = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+#else
+template <typename T> inline constexpr bool vectorizable = false;
+#endif
+
+/// \brief Alignment in bytes of a native SIMD vector of \p T, or alignof(T) if \p T is not vectorizable.
+/// \details Loads and stores of a vector at an address with this alignment never split a cache line.
+/// \ingroup core_math
+template <typename T> consteval std::size_t vector_alignment_of()
+{
+#if UNI20_HAS_STD_SIMD
+  if constexpr (vectorizable<T>) return stdx::memory_alignment_v<native<T>>;
+#endif
+  return alignof(T);
+}
+
+/// \brief Alignment in bytes of a native SIMD vector of \p T; see vector_alignment_of().
+/// \ingroup core_math
+template <typename T> inline constexpr std::size_t vector_alignment = vector_alignment_of<T>();
+
+/// \brief True if \p p is aligned to \p Align bytes.
+/// \ingroup core_math
+template <std::size_t Align, typename T> bool is_aligned(T const* p) noexcept
+{
+  return reinterpret_cast<std::uintptr_t>(p) % Align == 0;
+}
+
+/// \brief Marks a functor as callable on native SIMD vectors as well as on scalars.
+/// \details Elementwise kernels only pass SIMD vectors to functors wrapped in simd_op, since calling an
+///          arbitrary generic lambda with a SIMD argument can fail to compile inside its body.
+/// \tparam F Functor whose call operator accepts both scalars and simd::native vectors.
+/// \ingroup core_math
+template <typename F> struct simd_op
+{
+    F f;
+
+    template <typename... Args> constexpr decltype(auto) operator()(Args&&... args)
+    {
+      return f(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args> constexpr decltype(auto) operator()(Args&&... args) const
+    {
+      return f(std::forward<Args>(args)...);
+    }
+};
+
+template <typename F> simd_op(F) -> simd_op<F>;
+
+/// \brief True if \p Op is a functor wrapped in simd_op.
+/// \ingroup core_math
+template <typename Op> inline constexpr bool is_simd_op = false;
+
+template <typename F> inline constexpr bool is_simd_op<simd_op<F>> = true;
+
+/// \brief Replace each of \p n contiguous elements by op(element).
+/// \details The SIMD path uses aligned loads and stores if \p p is aligned to vector_alignment, which is checked
+///          at run time.
+/// \tparam T Element type.
+/// \tparam Op Unary functor.
+/// \param p Pointer to the first element.
+/// \param n Number of elements.
+/// \param op Functor applied to each element.
+/// \ingroup core_math
+template <typename T, typename Op> void transform_inplace(T* p, std::ptrdiff_t n, Op& op)
+{
+  std::ptrdiff_t i = 0;
+#if UNI20_HAS_STD_SIMD
+  if constexpr (vectorizable<T> && is_simd_op<std::remove_cvref_t<Op>>)
+  {
+    using V = native<T>;
+    constexpr std::ptrdiff_t W = V::size();
+    auto const run = [&](auto flag) {
+      for (; i + W <= n; i += W)
+      {
+        V v(p + i, flag);
+        V(op(v)).copy_to(p + i, flag);
+      }
+    };
+    if (is_aligned<vector_alignment<T>>(p))
+      run(stdx::vector_aligned);
+    else
+      run(stdx::element_aligned);
+  }
+#endif
+  UNI20_VECTORIZE_LOOP
+  for (; i < n; ++i)
+    p[i] = op(p[i]);
+}
+
+/// \brief Set dst[i] = op(src[i]...) for \p n contiguous elements.
+/// \details The SIMD path reads a full vector of every source before it writes \p dst, so \p dst may coincide
+///          with a source but must not partially overlap one. It uses aligned loads and stores if every pointer is
+///          aligned to vector_alignment, which is checked at run time.
+/// \tparam T Element type of the destination.
+/// \tparam Op N-ary functor.
+/// \tparam U Element types of the sources.
+/// \param n Number of elements.
+/// \param op Functor applied to each tuple of source elements.
+/// \param dst Pointer to the first destination element.
+/// \param src Pointers to the first element of each source.
+/// \ingroup core_math
+template <typename T, typename Op, typename... U> void transform(std::ptrdiff_t n, Op& op, T* dst, U const*... src)
+{
+  std::ptrdiff_t i = 0;
+#if UNI20_HAS_STD_SIMD
+  if constexpr (vectorizable<T> && (std::is_same_v<U, T> && ...) && is_simd_op<std::remove_cvref_t<Op>>)
+  {
+    using V = native<T>;
+    constexpr std::ptrdiff_t W = V::size();
+    constexpr std::size_t A = vector_alignment<T>;
+    auto const run = [&](auto flag) {
+      for (; i + W <= n; i += W)
+        V(op(V(src + i, flag)...)).copy_to(dst + i, flag);
+    };
+    if (is_aligned<A>(dst) && (is_aligned<A>(src) && ...))
+      run(stdx::vector_aligned);
+    else
+      run(stdx::element_aligned);
+  }
+#endif
+  for (; i < n; ++i)
+    dst[i] = op(src[i]...);
+}
+
+/// \brief Set dst[i] = op(src[i]...) for \p n contiguous elements, where each source flagged in \p broadcast
+///        is a single element used for every \c i.
+/// \details The broadcast elements are loaded, and on the SIMD path splatted into a vector, once before the loop.
+///          The other sources are read as by transform().
+/// \tparam T Element type of the destination.
+/// \tparam Op N-ary functor.
+/// \tparam U Element types of the sources.
+/// \param n Number of elements.
+/// \param op Functor applied to each tuple of source elements.
+/// \param broadcast True for each source that stays on one element.
+/// \param dst Pointer to the first destination element.
+/// \param src Pointers to the first element of each source.
+/// \ingroup core_math
+template <typename T, typename Op, typename... U>
+void transform_broadcast(std::ptrdiff_t n, Op& op, std::array<bool, sizeof...(U)> const& broadcast, T* dst,
+                         U const*... src)
+{
+  std::ptrdiff_t i = 0;
+  std::array<std::ptrdiff_t, sizeof...(U)> step{};
+  for (std::size_t k = 0; k < sizeof...(U); ++k)
+    step[k] = broadcast[k] ? 0 : 1;
+#if UNI20_HAS_STD_SIMD
+  if constexpr (vectorizable<T> && (std::is_same_v<U, T> && ...) && is_simd_op<std::remove_cvref_t<Op>>)
+  {
+    using V = native<T>;
+    constexpr std::ptrdiff_t W = V::size();
+    [&]<std::size_t... K>(std::index_sequence<K...>)
+    {
+      std::array<V, sizeof...(U)> const splat{V(*src)...};
+      auto const load = [&](std::size_t k, T const* p) {
+        return broadcast[k] ? splat[k] : V(p + i, stdx::element_aligned);
+      };
+      for (; i + W <= n; i += W)
+        V(op(load(K, src)...)).copy_to(dst + i, stdx::element_aligned);
+    }
+    (std::index_sequence_for<U...>{});
+  }
+#endif
+  [&]<std::size_t... K>(std::index_sequence<K...>)
+  {
+    for (; i < n; ++i)
+      dst[i] = op(src[i * step[K]]...);
+  }
+  (std::index_sequence_for<U...>{});
+}
+
+} // namespace uni20::simd
@@ -2,13 +2,639 @@
 
 #include <uni20/backend/blas/backend_blas.hpp>
 #include "blas.hpp"
+#include <uni20/common/aligned_buffer.hpp>
 #include <uni20/core/types.hpp>
+#include <uni20/kernel/contract_epilogue.hpp>
+#include <uni20/kernel/cpu/batched_contract.hpp>
+#include <uni20/kernel/cpu/contract.hpp>
+#include <uni20/kernel/cpu/parallel_contract.hpp>
+#include <uni20/mdspan/strides.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
 
 namespace uni20::kernel
 {
 
+namespace blas
+{
+
+/// \brief Transposition flag and leading dimension describing one column-major BLAS operand.
+/// \ingroup kernel_blas
+struct gemm_operand
+{
+    char trans;
+    blas_int ld;
+};
+
+/// \brief Argument bundle for a single column-major `gemm` call that realises a contraction.
+/// \details When \c swap_operands is set the call computes Cᵀ = Bᵀ·Aᵀ, so the A and B pointers
+///          are passed to `gemm` in reverse order.
+/// \ingroup kernel_blas
+struct gemm_params
+{
+    gemm_operand a;
+    gemm_operand b;
+    blas_int m;
+    blas_int n;
+    blas_int k;
+    blas_int ldc;
+    bool swap_operands;
+};
+
+/// \brief Check that an extent or stride is representable as a BLAS integer.
+/// \param v Value to check.
+/// \return True when \p v fits in \c blas_int.
+/// \ingroup internal
+constexpr bool fits_blas_int(std::ptrdiff_t v) noexcept
+{
+  return v >= 0 && v <= static_cast<std::ptrdiff_t>(std::numeric_limits<blas_int>::max());
+}
+
+/// \brief Leading dimension of a rows×cols matrix stored column-major with the given strides.
+/// \details Dimensions of extent ≤ 1 do not constrain the layout, so their stride is ignored.
+/// \param rows Number of rows.
+/// \param cols Number of columns.
+/// \param row_stride Element stride between consecutive rows.
+/// \param col_stride Element stride between consecutive columns.
+/// \return The leading dimension, or std::nullopt if the matrix is not column-major compatible.
+/// \ingroup internal
+constexpr std::optional<blas_int> column_major_ld(index_type rows, index_type cols, std::ptrdiff_t row_stride,
+                                                  std::ptrdiff_t col_stride) noexcept
+{
+  if (rows > 1 && row_stride != 1) return std::nullopt;
+  std::ptrdiff_t const min_ld = std::max<std::ptrdiff_t>(1, rows);
+  std::ptrdiff_t const ld = cols > 1 ? col_stride : min_ld;
+  if (ld < min_ld || !fits_blas_int(ld)) return std::nullopt;
+  return static_cast<blas_int>(ld);
+}
+
+/// \brief Express a strided rows×cols matrix as a BLAS operand, transposing if required.
+/// \param rows Number of rows of the logical operand.
+/// \param cols Number of columns of the logical operand.
+/// \param row_stride Element stride between consecutive rows.
+/// \param col_stride Element stride between consecutive columns.
+/// \return The operand description, or std::nullopt if neither the matrix nor its transpose is column-major.
+/// \ingroup internal
+constexpr std::optional<gemm_operand> make_gemm_operand(index_type rows, index_type cols, std::ptrdiff_t row_stride,
+                                                        std::ptrdiff_t col_stride) noexcept
+{
+  if (auto ld = column_major_ld(rows, cols, row_stride, col_stride)) return gemm_operand{'N', *ld};
+  if (auto ld = column_major_ld(cols, rows, col_stride, row_stride)) return gemm_operand{'T', *ld};
+  return std::nullopt;
+}
+
+/// \brief Stride of a group viewed as a single dimension of operand \p J.
+/// \details The group is linear for operand \p J when, in group order, every dimension's stride equals the
+///          stride times extent of the next inner dimension. Unit-extent dimensions are ignored because their
+///          strides never contribute to an offset.
+/// \tparam J Operand index within the group strides.
+/// \tparam R Capacity of the stride group.
+/// \param grp Merged group as produced by extract_strides.
+/// \return The stride of the innermost dimension, or std::nullopt if the group is not linear for \p J.
+/// \ingroup internal
+template <std::size_t J, std::size_t R>
+std::optional<std::ptrdiff_t> linear_stride(static_vector<extent_strides<2>, R> const& grp) noexcept
+{
+  std::optional<std::ptrdiff_t> stride;
+  for (auto const& d : grp)
+  {
+    if (d.extent == 0) return 0;
+    if (d.extent == 1) continue;
+    if (stride && *stride != d.strides[J] * d.extent) return std::nullopt;
+    stride = d.strides[J];
+  }
+  return stride.value_or(0);
+}
+
+/// \brief Assemble column-major `gemm` arguments from matrix strides of the three operands.
+/// \param m Number of rows of A and C.
+/// \param n Number of columns of B and C.
+/// \param k Contracted extent.
+/// \param sA Row and column strides of the m×k matrix A.
+/// \param sB Row and column strides of the k×n matrix B.
+/// \param sC Row and column strides of the m×n matrix C.
+/// \return The gemm arguments, or std::nullopt if the strides are not expressible as one GEMM.
+/// \ingroup internal
+inline std::optional<gemm_params> make_gemm_params(index_type m, index_type n, index_type k,
+                                                   std::array<std::ptrdiff_t, 2> sA, std::array<std::ptrdiff_t, 2> sB,
+                                                   std::array<std::ptrdiff_t, 2> sC)
+{
+  if (!fits_blas_int(m) || !fits_blas_int(n) || !fits_blas_int(k)) return std::nullopt;
+
+  // C is column-major: C = A·B
+  if (auto ldc = column_major_ld(m, n, sC[0], sC[1]))
+  {
+    auto a = make_gemm_operand(m, k, sA[0], sA[1]);
+    auto b = make_gemm_operand(k, n, sB[0], sB[1]);
+    if (a && b)
+      return gemm_params{*a, *b, static_cast<blas_int>(m), static_cast<blas_int>(n), static_cast<blas_int>(k), *ldc,
+                         false};
+  }
+
+  // C is row-major: Cᵀ = Bᵀ·Aᵀ
+  if (auto ldc = column_major_ld(n, m, sC[1], sC[0]))
+  {
+    auto a = make_gemm_operand(n, k, sB[1], sB[0]);
+    auto b = make_gemm_operand(k, m, sA[1], sA[0]);
+    if (a && b)
+      return gemm_params{*a, *b, static_cast<blas_int>(n), static_cast<blas_int>(m), static_cast<blas_int>(k), *ldc,
+                         true};
+  }
+
+  return std::nullopt;
+}
+
+/// \brief Execution plan for a Transpose-Transpose-GEMM-Transpose (TTGT) contraction.
+/// \details Operands whose stride pattern is not directly usable by BLAS are packed into column-major
+///          scratch (A as m×k, B as k×n, C as m×n). When C is packed, `gemm` writes into the scratch with a
+///          zero beta and the result is scattered back into C with the caller's beta. A conjugated operand is
+///          passed to `gemm` as 'C' when it is transposed, and is otherwise conjugated while it is packed.
+/// \ingroup kernel_blas
+struct ttgt_plan
+{
+    index_type m;
+    index_type n;
+    index_type k;
+    bool pack_a;
+    bool pack_b;
+    bool pack_c;
+    gemm_params gemm;
+    bool conj_a = false; ///< Conjugate A while packing it.
+    bool conj_b = false; ///< Conjugate B while packing it.
+
+    /// \brief True if no operand requires packing, so the contraction is a single in-place `gemm`.
+    constexpr bool is_direct() const noexcept { return !pack_a && !pack_b && !pack_c; }
+
+    /// \brief Number of elements moved through scratch buffers; C counts twice (pack and scatter).
+    constexpr index_type packed_elements() const noexcept
+    {
+      return (pack_a ? m * k : 0) + (pack_b ? k * n : 0) + (pack_c ? 2 * m * n : 0);
+    }
+};
+
+/// \brief Minimum m·n·k volume below which TTGT packing is never used.
+/// \ingroup kernel_blas
+inline constexpr index_type ttgt_min_volume = 4096;
+
+/// \brief Cost of moving one element through scratch, relative to one multiply-add in the loop engine.
+/// \ingroup kernel_blas
+inline constexpr index_type ttgt_pack_cost = 4;
+
+/// \brief Decide whether a TTGT plan is expected to beat the direct CPU loop.
+/// \details Packing is memory-bound and scales with the operand sizes, whereas the contraction itself scales
+///          with m·n·k. Packing pays off once the volume is large and dominates the weighted packing traffic.
+/// \param plan Candidate TTGT plan.
+/// \return True if the plan should be executed through BLAS.
+/// \ingroup kernel_blas
+constexpr bool prefer_ttgt(ttgt_plan const& plan) noexcept
+{
+  if (plan.is_direct()) return true;
+  index_type const volume = plan.m * plan.n * plan.k;
+  return volume >= ttgt_min_volume && plan.packed_elements() * ttgt_pack_cost <= volume;
+}
+
+/// \brief Build a TTGT plan for fused M/N/K groups.
+/// \details Each operand is used in place when both of its groups are linear and it has a unit stride along one
+///          of its two matrix legs; otherwise it is marked for packing into column-major scratch. BLAS can only
+///          conjugate a transposed operand ('C'), so a conjugated operand that would be passed untransposed is
+///          packed (and conjugated) instead. C can be forced through scratch so that a scaled epilogue is
+///          applied while the result is scattered back.
+/// \tparam MR Capacity of the M group.
+/// \tparam NR Capacity of the N group.
+/// \tparam KR Capacity of the K group.
+/// \param Mgrp Fused M dimensions, strides ordered as {A, C}.
+/// \param Ngrp Fused N dimensions, strides ordered as {B, C}.
+/// \param Kgrp Fused K dimensions, strides ordered as {A, B}.
+/// \param conj_a Contract with the complex conjugate of A.
+/// \param conj_b Contract with the complex conjugate of B.
+/// \param force_pack_c Pack C even if it could be written in place.
+/// \return The plan, or std::nullopt if the extents exceed the BLAS integer range.
+/// \ingroup kernel_blas
+template <std::size_t MR, std::size_t NR, std::size_t KR>
+std::optional<ttgt_plan> make_ttgt_plan(static_vector<extent_strides<2>, MR> const& Mgrp,
+                                        static_vector<extent_strides<2>, NR> const& Ngrp,
+                                        static_vector<extent_strides<2>, KR> const& Kgrp, bool conj_a = false,
+                                        bool conj_b = false, bool force_pack_c = false)
+{
+  index_type const m = cpu::group_extent(Mgrp);
+  index_type const n = cpu::group_extent(Ngrp);
+  index_type const k = cpu::group_extent(Kgrp);
+  if (!fits_blas_int(m) || !fits_blas_int(n) || !fits_blas_int(k) || !fits_blas_int(m * k) ||
+      !fits_blas_int(k * n) || !fits_blas_int(m * n))
+    return std::nullopt;
+
+  auto const sAm = linear_stride<0>(Mgrp);
+  auto const sCm = linear_stride<1>(Mgrp);
+  auto const sBn = linear_stride<0>(Ngrp);
+  auto const sCn = linear_stride<1>(Ngrp);
+  auto const sAk = linear_stride<0>(Kgrp);
+  auto const sBk = linear_stride<1>(Kgrp);
+
+  ttgt_plan plan{m, n, k, true, true, true, {}};
+  std::array<std::ptrdiff_t, 2> sA{1, std::max<index_type>(1, m)};
+  std::array<std::ptrdiff_t, 2> sB{1, std::max<index_type>(1, k)};
+  std::array<std::ptrdiff_t, 2> sC{1, std::max<index_type>(1, m)};
+
+  if (sAm && sAk && make_gemm_operand(m, k, *sAm, *sAk))
+  {
+    plan.pack_a = false;
+    sA = {*sAm, *sAk};
+  }
+  if (sBk && sBn && make_gemm_operand(k, n, *sBk, *sBn))
+  {
+    plan.pack_b = false;
+    sB = {*sBk, *sBn};
+  }
+  if (!force_pack_c && sCm && sCn && (column_major_ld(m, n, *sCm, *sCn) || column_major_ld(n, m, *sCn, *sCm)))
+  {
+    plan.pack_c = false;
+    sC = {*sCm, *sCn};
+  }
+
+  auto build = [&] {
+    auto gemm = make_gemm_params(m, n, k, sA, sB, sC);
+    CHECK(gemm, "packed operands must always be expressible as a single gemm");
+    plan.gemm = *gemm;
+  };
+  auto op_a = [&]() -> gemm_operand& { return plan.gemm.swap_operands ? plan.gemm.b : plan.gemm.a; };
+  auto op_b = [&]() -> gemm_operand& { return plan.gemm.swap_operands ? plan.gemm.a : plan.gemm.b; };
+
+  build();
+  // packing an untransposed conjugated operand can change the gemm form, so repeat until it is stable
+  for (bool changed = true; changed;)
+  {
+    changed = false;
+    if (conj_a && !plan.pack_a && op_a().trans == 'N')
+    {
+      plan.pack_a = changed = true;
+      sA = {1, std::max<index_type>(1, m)};
+    }
+    if (conj_b && !plan.pack_b && op_b().trans == 'N')
+    {
+      plan.pack_b = changed = true;
+      sB = {1, std::max<index_type>(1, k)};
+    }
+    if (changed) build();
+  }
+  if (conj_a)
+  {
+    if (op_a().trans == 'T')
+      op_a().trans = 'C';
+    else
+      plan.conj_a = true;
+  }
+  if (conj_b)
+  {
+    if (op_b().trans == 'T')
+      op_b().trans = 'C';
+    else
+      plan.conj_b = true;
+  }
+  return plan;
+}
+
+/// \brief Attempt to lower fused M/N/K groups onto a single in-place column-major `gemm` call.
+/// \tparam MR Capacity of the M group.
+/// \tparam NR Capacity of the N group.
+/// \tparam KR Capacity of the K group.
+/// \param Mgrp Fused M dimensions, strides ordered as {A, C}.
+/// \param Ngrp Fused N dimensions, strides ordered as {B, C}.
+/// \param Kgrp Fused K dimensions, strides ordered as {A, B}.
+/// \return The gemm arguments, or std::nullopt if the stride pattern is not expressible as one GEMM.
+/// \ingroup kernel_blas
+template <std::size_t MR, std::size_t NR, std::size_t KR>
+std::optional<gemm_params> make_gemm_params(static_vector<extent_strides<2>, MR> const& Mgrp,
+                                            static_vector<extent_strides<2>, NR> const& Ngrp,
+                                            static_vector<extent_strides<2>, KR> const& Kgrp)
+{
+  auto plan = make_ttgt_plan(Mgrp, Ngrp, Kgrp);
+  if (!plan || !plan->is_direct()) return std::nullopt;
+  return plan->gemm;
+}
+
+/// \brief Issue a planned `gemm` call, optionally split into independent M×N tiles run on a task arena.
+/// \details Each tile is a separate `gemm` on a sub-matrix of C, so the BLAS library itself should be
+///          single-threaded when this is used in parallel mode.
+/// \tparam T BLAS-compatible scalar type.
+/// \param g Column-major gemm arguments.
+/// \param alpha Scaling factor applied to the product.
+/// \param lhs First gemm operand.
+/// \param rhs Second gemm operand.
+/// \param beta Scaling factor applied to the existing contents of \p C.
+/// \param C Column-major destination.
+/// \param parallel Whether to partition the call into tiles.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup internal
+template <BlasScalar T>
+void gemm_call(gemm_params const& g, T alpha, T const* lhs, T const* rhs, T beta, T* C, bool parallel,
+               oneapi::tbb::task_arena* arena)
+{
+  constexpr index_type gemm_tile = 64;
+  cpu::contract_partition part{g.m, g.n, 1};
+  if (parallel)
+  {
+    int const concurrency = arena ? arena->max_concurrency() : oneapi::tbb::this_task_arena::max_concurrency();
+    part = cpu::partition_contraction(g.m, g.n, g.k, concurrency, gemm_tile, gemm_tile, g.k, false);
+  }
+  if (part.is_serial(g.m, g.n))
+  {
+    ::uni20::blas::gemm(g.a.trans, g.b.trans, g.m, g.n, g.k, alpha, lhs, g.a.ld, rhs, g.b.ld, beta, C, g.ldc);
+    return;
+  }
+
+  index_type const tiles_m = (g.m + part.tile_m - 1) / part.tile_m;
+  index_type const tiles_n = (g.n + part.tile_n - 1) / part.tile_n;
+  cpu::execute_in(arena, [&] {
+    oneapi::tbb::parallel_for(index_type(0), tiles_m * tiles_n, [&](index_type t) {
+      index_type const i0 = (t % tiles_m) * part.tile_m;
+      index_type const j0 = (t / tiles_m) * part.tile_n;
+      auto const mb = static_cast<blas_int>(std::min<index_type>(part.tile_m, g.m - i0));
+      auto const nb = static_cast<blas_int>(std::min<index_type>(part.tile_n, g.n - j0));
+      T const* a = lhs + (g.a.trans == 'N' ? i0 : i0 * g.a.ld);
+      T const* b = rhs + (g.b.trans == 'N' ? j0 * g.b.ld : j0);
+      ::uni20::blas::gemm(g.a.trans, g.b.trans, mb, nb, g.k, alpha, a, g.a.ld, b, g.b.ld, beta, C + i0 + j0 * g.ldc,
+                          g.ldc);
+    }, oneapi::tbb::simple_partitioner{});
+  });
+}
+
+/// \brief Value stored in TTGT scratch, conjugated if requested.
+/// \ingroup internal
+template <BlasScalar T> T pack_value(T const& x, bool conj) noexcept
+{
+  if constexpr (BlasComplex<T>)
+  {
+    if (conj) return std::conj(x);
+  }
+  return x;
+}
+
+/// \brief Offset tables through which a TTGT plan packs its operands and scatters C, built by
+///        make_ttgt_offsets(). Tables an execution does not need are left empty.
+/// \ingroup kernel_blas
+struct ttgt_offsets
+{
+    detail::aligned_buf_t<std::ptrdiff_t> a_m, a_k; ///< M and K offsets into A, if A is packed.
+    detail::aligned_buf_t<std::ptrdiff_t> b_k, b_n; ///< K and N offsets into B, if B is packed.
+    detail::aligned_buf_t<std::ptrdiff_t> c_m, c_n; ///< M and N offsets into C, if C is packed or post-processed.
+};
+
+/// \brief Build the offset tables used by run_ttgt_prepared() for a plan.
+/// \param plan Plan built from the same groups by make_ttgt_plan.
+/// \param Mgrp Fused M dimensions, strides ordered as {A, C}.
+/// \param Ngrp Fused N dimensions, strides ordered as {B, C}.
+/// \param Kgrp Fused K dimensions, strides ordered as {A, B}.
+/// \param need_c Build the C tables even if C is not packed, for an epilogue functor applied in place.
+/// \ingroup kernel_blas
+template <std::size_t MR, std::size_t NR, std::size_t KR>
+ttgt_offsets make_ttgt_offsets(ttgt_plan const& plan, static_vector<extent_strides<2>, MR> const& Mgrp,
+                               static_vector<extent_strides<2>, NR> const& Ngrp,
+                               static_vector<extent_strides<2>, KR> const& Kgrp, bool need_c = false)
+{
+  ttgt_offsets off;
+  if (plan.pack_a)
+  {
+    off.a_m = cpu::make_group_offsets<0>(Mgrp);
+    off.a_k = cpu::make_group_offsets<0>(Kgrp);
+  }
+  if (plan.pack_b)
+  {
+    off.b_k = cpu::make_group_offsets<1>(Kgrp);
+    off.b_n = cpu::make_group_offsets<0>(Ngrp);
+  }
+  if (plan.pack_c || need_c)
+  {
+    off.c_m = cpu::make_group_offsets<1>(Mgrp);
+    off.c_n = cpu::make_group_offsets<1>(Ngrp);
+  }
+  return off;
+}
+
+/// \brief Number of elements of scratch that run_ttgt_prepared() needs for a plan: the packed copies of A, B
+///        and C, in that order.
+/// \ingroup kernel_blas
+constexpr index_type ttgt_workspace_size(ttgt_plan const& plan) noexcept
+{
+  return (plan.pack_a ? plan.m * plan.k : 0) + (plan.pack_b ? plan.k * plan.n : 0) +
+         (plan.pack_c ? plan.m * plan.n : 0);
+}
+
+/// \brief Execute a contraction according to a TTGT plan, with prebuilt offset tables and caller-provided
+///        scratch.
+/// \details An epilogue functor is applied while a packed C is scattered back, or in a pass over C after an
+///          in-place `gemm`. Scaling by the epilogue requires a plan that packs C.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam F Elementwise epilogue functor.
+/// \param plan Plan built by make_ttgt_plan.
+/// \param off Offset tables built from the same groups by make_ttgt_offsets, with \c need_c if \p ep has a
+///            functor.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param workspace Scratch of at least ttgt_workspace_size(plan) elements.
+/// \param parallel Whether the `gemm` call is split into tiles run on \p arena.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \param ep Epilogue indexed by the flattened M and N indices of the groups.
+/// \ingroup kernel_blas
+template <BlasScalar T, typename F = identity_epilogue>
+void run_ttgt_prepared(ttgt_plan const& plan, ttgt_offsets const& off, T alpha, T const* A, T const* B, T beta,
+                       T* C, T* workspace, bool parallel = false, oneapi::tbb::task_arena* arena = nullptr,
+                       flat_epilogue<T, F> const& ep = {})
+{
+  index_type const m = plan.m, n = plan.n, k = plan.k;
+  if (m == 0 || n == 0) return;
+  CHECK(plan.pack_c || !ep.scaled(), "a scaled epilogue requires a TTGT plan that packs C");
+
+  if (plan.pack_a)
+  {
+    T* Abuf = workspace;
+    workspace += m * k;
+    for (index_type kk = 0; kk < k; ++kk)
+      for (index_type i = 0; i < m; ++i)
+        Abuf[i + kk * m] = pack_value(A[off.a_m[i] + off.a_k[kk]], plan.conj_a);
+    A = Abuf;
+  }
+  if (plan.pack_b)
+  {
+    T* Bbuf = workspace;
+    workspace += k * n;
+    for (index_type j = 0; j < n; ++j)
+      for (index_type kk = 0; kk < k; ++kk)
+        Bbuf[kk + j * k] = pack_value(B[off.b_k[kk] + off.b_n[j]], plan.conj_b);
+    B = Bbuf;
+  }
+
+  T* Cdst = plan.pack_c ? workspace : C;
+  T const gemm_beta = plan.pack_c ? T{} : beta;
+
+  auto const& g = plan.gemm;
+  T const* lhs = g.swap_operands ? B : A;
+  T const* rhs = g.swap_operands ? A : B;
+  gemm_call(g, alpha, lhs, rhs, gemm_beta, Cdst, parallel, arena);
+
+  if (plan.pack_c)
+  {
+    T const* Cbuf = Cdst;
+    if (ep.scaled())
+    {
+      for (index_type j = 0; j < n; ++j)
+        for (index_type i = 0; i < m; ++i)
+        {
+          T& c = C[off.c_m[i] + off.c_n[j]];
+          T const value = ep.scale(i, j) * Cbuf[i + j * m];
+          c = ep.op(beta == T{} ? value : (beta * c) + value);
+        }
+    }
+    else
+    {
+      for (index_type j = 0; j < n; ++j)
+        for (index_type i = 0; i < m; ++i)
+        {
+          T& c = C[off.c_m[i] + off.c_n[j]];
+          c = ep.op(beta == T{} ? Cbuf[i + j * m] : (beta * c) + Cbuf[i + j * m]);
+        }
+    }
+  }
+  else if constexpr (flat_epilogue<T, F>::has_op)
+  {
+    for (index_type j = 0; j < n; ++j)
+      for (index_type i = 0; i < m; ++i)
+      {
+        T& c = C[off.c_m[i] + off.c_n[j]];
+        c = ep.op(c);
+      }
+  }
+}
+
+/// \brief Execute a contraction according to a TTGT plan.
+/// \details Builds the offset tables and scratch for one call and forwards to run_ttgt_prepared(); see there.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam MR Capacity of the M group.
+/// \tparam NR Capacity of the N group.
+/// \tparam KR Capacity of the K group.
+/// \tparam F Elementwise epilogue functor.
+/// \param plan Plan built from the same groups by make_ttgt_plan.
+/// \param Mgrp Fused M dimensions, strides ordered as {A, C}.
+/// \param Ngrp Fused N dimensions, strides ordered as {B, C}.
+/// \param Kgrp Fused K dimensions, strides ordered as {A, B}.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param parallel Whether the `gemm` call is split into tiles run on \p arena.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \param ep Epilogue indexed by the flattened M and N indices of the groups.
+/// \ingroup kernel_blas
+template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR, typename F = identity_epilogue>
+void run_ttgt(ttgt_plan const& plan, static_vector<extent_strides<2>, MR> const& Mgrp,
+              static_vector<extent_strides<2>, NR> const& Ngrp, static_vector<extent_strides<2>, KR> const& Kgrp,
+              T alpha, T const* A, T const* B, T beta, T* C, bool parallel = false,
+              oneapi::tbb::task_arena* arena = nullptr, flat_epilogue<T, F> const& ep = {})
+{
+  if (plan.m == 0 || plan.n == 0) return;
+  auto const off = make_ttgt_offsets(plan, Mgrp, Ngrp, Kgrp, flat_epilogue<T, F>::has_op);
+  detail::aligned_buf_t<T> workspace;
+  if (index_type const size = ttgt_workspace_size(plan); size > 0) workspace = allocate_uninitialized_buffer<T>(size);
+  run_ttgt_prepared(plan, off, alpha, A, B, beta, C, workspace.get(), parallel, arena, ep);
+}
+
+} // namespace blas
+
+template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR, typename Acc>
+/// \brief Execute a tensor contraction through BLAS `gemm` when the stride groups permit it.
+/// \details The contraction is lowered to a single `gemm` call when the fused M, N and K groups each
+///          collapse to one dimension with a unit stride in a compatible position. Otherwise the operands
+///          that are not GEMM-compatible are packed into scratch (TTGT) when prefer_ttgt() predicts that
+///          packing pays off, and the remaining cases fall back to the CPU engines. Conjugated operands use
+///          the 'C' transposition where possible; an accumulator type other than \p T is not available in
+///          BLAS and always runs on the CPU engines.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \tparam Acc Requested accumulator type, or void for \p T.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param opts Conjugation flags and accumulator type.
+/// \ingroup kernel_blas
+void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
+                      static_vector<extent_strides<2>, NR> const& Ngrp,
+                      static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
+                      blas_tag tag, contract_options<Acc> opts)
+{
+  static_cast<void>(tag);
+  if constexpr (std::is_same_v<contract_accumulator_t<T, Acc>, T>)
+  {
+    bool const conj_a = BlasComplex<T> && opts.conj_a;
+    bool const conj_b = BlasComplex<T> && opts.conj_b;
+    if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp, conj_a, conj_b); plan && blas::prefer_ttgt(*plan))
+    {
+      blas::run_ttgt(*plan, Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C);
+      return;
+    }
+  }
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{}, opts);
+}
+
+template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR, typename Acc, typename F>
+/// \brief Execute a tensor contraction through BLAS `gemm` with a fused epilogue, C = f(β·C + α·(A ⋅ B)·D).
+/// \details The epilogue is applied after `gemm`: when it scales the product, C is always routed through
+///          TTGT scratch so that the scaling, β·C and f are combined in the scatter pass; otherwise f is applied
+///          in one pass over C. Cases that do not lower to `gemm` use the CPU engines, which apply the epilogue
+///          while each output tile is written.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \tparam Acc Requested accumulator type, or void for \p T.
+/// \tparam F Elementwise epilogue functor.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param opts Conjugation flags and accumulator type.
+/// \param ep Epilogue indexed by the flattened M and N indices of the groups.
+/// \ingroup kernel_blas
+void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
+                      static_vector<extent_strides<2>, NR> const& Ngrp,
+                      static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
+                      blas_tag tag, contract_options<Acc> opts, flat_epilogue<T, F> const& ep)
+{
+  static_cast<void>(tag);
+  if constexpr (std::is_same_v<contract_accumulator_t<T, Acc>, T>)
+  {
+    bool const conj_a = BlasComplex<T> && opts.conj_a;
+    bool const conj_b = BlasComplex<T> && opts.conj_b;
+    if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp, conj_a, conj_b, ep.scaled());
+        plan && blas::prefer_ttgt(*plan))
+    {
+      blas::run_ttgt(*plan, Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, false, nullptr, ep);
+      return;
+    }
+  }
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{}, opts, ep);
+}
+
 template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR>
-/// \brief Delegate tensor contraction to the CPU fallback when using a BLAS backend.
+/// \brief Execute a tensor contraction through BLAS `gemm` when the stride groups permit it.
 /// \tparam T BLAS-compatible scalar type stored in the tensors.
 /// \tparam MR Number of fused M dimensions.
 /// \tparam NR Number of fused N dimensions.
@@ -27,9 +653,137 @@ void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
                       static_vector<extent_strides<2>, NR> const& Ngrp,
                       static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
                       blas_tag tag)
+{
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, tag, contract_options<>{});
+}
+
+template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute a tensor contraction through BLAS on multiple threads.
+/// \details Contractions lowered to `gemm` (directly or through TTGT) split the `gemm` call into M×N tiles;
+///          the remaining cases use the multithreaded CPU engine.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup kernel_blas
+void contract_strided_parallel(static_vector<extent_strides<2>, MR> const& Mgrp,
+                               static_vector<extent_strides<2>, NR> const& Ngrp,
+                               static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B,
+                               T beta, T* C, blas_tag tag, oneapi::tbb::task_arena* arena)
+{
+  static_cast<void>(tag);
+  if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp); plan && blas::prefer_ttgt(*plan))
+  {
+    blas::run_ttgt(*plan, Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, true, arena);
+    return;
+  }
+  contract_strided_parallel(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{}, arena);
+}
+
+template <BlasScalar T, std::size_t BR, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute a batched tensor contraction through BLAS.
+/// \details The `gemm` (or TTGT) plan, its offset tables and its scratch are built once and issued for every
+///          batch index, i.e. a strided-batched `gemm` loop; contractions that do not lower to `gemm` use the CPU
+///          batched engine.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam BR Number of fused batch dimensions.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Bgrp Metadata describing extents and strides {A, B, C} for the fused batch dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \ingroup kernel_blas
+void contract_strided_batched(static_vector<extent_strides<3>, BR> const& Bgrp,
+                              static_vector<extent_strides<2>, MR> const& Mgrp,
+                              static_vector<extent_strides<2>, NR> const& Ngrp,
+                              static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B,
+                              T beta, T* C, blas_tag tag)
+{
+  static_cast<void>(tag);
+  if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp); plan && blas::prefer_ttgt(*plan))
+  {
+    auto const off = blas::make_ttgt_offsets(*plan, Mgrp, Ngrp, Kgrp);
+    detail::aligned_buf_t<T> workspace;
+    if (index_type const size = blas::ttgt_workspace_size(*plan); size > 0)
+      workspace = allocate_uninitialized_buffer<T>(size);
+    cpu::for_each_batch(Bgrp, false, nullptr, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+      blas::run_ttgt_prepared(*plan, off, alpha, A + a, B + b, beta, C + c, workspace.get());
+    });
+    return;
+  }
+  contract_strided_batched(Bgrp, Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{});
+}
+
+template <BlasScalar T, std::size_t BR, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute a batched tensor contraction through BLAS on multiple threads.
+/// \details Independent `gemm` calls run concurrently over the batch index when cpu::parallel_over_batches()
+///          allows it, each thread packing into its own scratch; otherwise each batch issues a tiled parallel
+///          `gemm` with one shared scratch. The plan and its offset tables are built once for all batches.
+/// \tparam T BLAS-compatible scalar type stored in the tensors.
+/// \tparam BR Number of fused batch dimensions.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Bgrp Metadata describing extents and strides {A, B, C} for the fused batch dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup kernel_blas
+void contract_strided_batched_parallel(static_vector<extent_strides<3>, BR> const& Bgrp,
+                                       static_vector<extent_strides<2>, MR> const& Mgrp,
+                                       static_vector<extent_strides<2>, NR> const& Ngrp,
+                                       static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A,
+                                       T const* B, T beta, T* C, blas_tag tag, oneapi::tbb::task_arena* arena)
 {
   static_cast<void>(tag);
-  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{});
+  if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp); plan && blas::prefer_ttgt(*plan))
+  {
+    bool const over_batches = cpu::parallel_over_batches(cpu::group_extent(Bgrp), plan->m * plan->n * plan->k, arena);
+    auto const off = blas::make_ttgt_offsets(*plan, Mgrp, Ngrp, Kgrp);
+    index_type const size = blas::ttgt_workspace_size(*plan);
+    if (over_batches)
+    {
+      // a serial TTGT call runs no other task, so the thread's scratch is not reused while it is packed
+      std::size_t const bytes = static_cast<std::size_t>(size) * sizeof(T);
+      cpu::for_each_batch(Bgrp, true, arena, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+        T* workspace = reinterpret_cast<T*>(cpu::contraction_scratch(bytes));
+        blas::run_ttgt_prepared(*plan, off, alpha, A + a, B + b, beta, C + c, workspace);
+      });
+      return;
+    }
+    detail::aligned_buf_t<T> workspace;
+    if (size > 0) workspace = allocate_uninitialized_buffer<T>(size);
+    cpu::for_each_batch(Bgrp, false, arena, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+      blas::run_ttgt_prepared(*plan, off, alpha, A + a, B + b, beta, C + c, workspace.get(), true, arena);
+    });
+    return;
+  }
+  contract_strided_batched_parallel(Bgrp, Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, cpu_tag{}, arena);
 }
 
 } // namespace uni20::kernel
@@ -2,15 +2,23 @@
 
 #include <uni20/common/mdspan.hpp>
 #include <uni20/core/scalar_concepts.hpp>
+#include <uni20/kernel/contract_epilogue.hpp>
+#include <uni20/kernel/contract_options.hpp>
 #include <uni20/mdspan/strides.hpp>
 
+#include <algorithm>
+#include <span>
+#include <vector>
+
 /**
  * \defgroup kernel Tensor kernel dispatch
  * \ingroup kernel_ops
  * \brief Front-end dispatchers that route tensor contractions to backend kernels.
  */
 
+#include <uni20/kernel/cpu/batched_contract.hpp>
 #include <uni20/kernel/cpu/contract.hpp> // always available fallback
+#include <uni20/kernel/cpu/parallel_contract.hpp>
 
 #if UNI20_BACKEND_BLAS
 #include <uni20/kernel/blas/contract.hpp>
@@ -79,4 +87,339 @@ void contract(T const& alpha, AType A, BType B,
   contract(alpha, A, B, std::to_array(dims), beta, C, tag);
 }
 
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, typename U, MutableStridedMdspan CType,
+          typename TagType, typename Acc>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N)
+    /// \brief Dispatch a tensor contraction with conjugation or accumulator options.
+    /// \details Computes C = β·C + α·(op(A) ⋅ op(B)), where op conjugates the operands selected in \p opts,
+    ///          accumulating the products in the type selected by \p opts.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \tparam Acc Requested accumulator type, or void for the tensor scalar type.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \param opts Conjugation flags and accumulator type.
+    /// \ingroup kernel_ops
+    void contract(T const& alpha, AType A, BType B,
+                  std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, U const& beta, CType C,
+                  TagType tag, contract_options<Acc> opts)
+{
+  using S = std::remove_const_t<typename CType::element_type>;
+  auto [Mgroup, Ngroup, Kgroup] = extract_strides(A, B, contractDims, C);
+  contract_strided(Mgroup, Ngroup, Kgroup, S(alpha), A.data_handle(), B.data_handle(), S(beta), C.data_handle(), tag,
+                   opts);
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, typename U, MutableStridedMdspan CType,
+          typename TagType, std::size_t N, typename Acc>
+/// \brief Overload forwarding compile-time dimension pairs to the dispatcher with contraction options.
+/// \tparam T Scalar used for scaling the contraction inputs and output.
+/// \tparam AType Strided mdspan describing the left-hand tensor operand.
+/// \tparam BType Strided mdspan describing the right-hand tensor operand.
+/// \tparam U Scalar type used to scale the destination tensor.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \tparam N Number of contracted index pairs.
+/// \tparam Acc Requested accumulator type, or void for the tensor scalar type.
+/// \param alpha Scaling factor for the contraction result.
+/// \param A Left-hand tensor operand.
+/// \param B Right-hand tensor operand.
+/// \param dims Compile-time array reference listing contracted dimension pairs.
+/// \param beta Scaling factor applied to the pre-existing contents of \p C.
+/// \param C Destination tensor.
+/// \param tag Backend selector instance.
+/// \param opts Conjugation flags and accumulator type.
+/// \ingroup kernel_ops
+void contract(T const& alpha, AType A, BType B, const std::pair<std::size_t, std::size_t> (&dims)[N], U const& beta,
+              CType C, TagType tag, contract_options<Acc> opts)
+{
+  contract(alpha, A, B, std::to_array(dims), beta, C, tag, opts);
+}
+
+namespace detail
+{
+
+/// \brief Tabulate the diagonal scaling of an epilogue over the flattened index of a merged M or N group.
+/// \details The output legs [first, last) of \p C form the group. The product of their scale factors is
+///          tabulated against the C offset of each element, and then read back in the order of the offsets of
+///          the merged group, which is the order in which the contraction engines enumerate it.
+/// \tparam T Scalar type of the output tensor.
+/// \tparam R Rank of the output tensor.
+/// \tparam GR Capacity of the stride group.
+/// \tparam CType Strided mdspan describing the output tensor.
+/// \param C Output tensor.
+/// \param scale Diagonal per output leg, empty for no scaling.
+/// \param first First output leg of the group.
+/// \param last One past the last output leg of the group.
+/// \param grp Merged group, strides ordered as {operand, C}.
+/// \return Scale factor per flattened group index, or an empty vector if no leg of the group is scaled.
+/// \ingroup internal
+template <typename T, std::size_t R, std::size_t GR, StridedMdspan CType>
+std::vector<T> flat_leg_scale(CType const& C, std::array<std::span<T const>, R> const& scale, std::size_t first,
+                              std::size_t last, static_vector<extent_strides<2>, GR> const& grp)
+{
+  bool scaled = false;
+  for (std::size_t l = first; l < last; ++l)
+  {
+    if (scale[l].empty()) continue;
+    ERROR_IF(scale[l].size() != static_cast<std::size_t>(C.extent(l)),
+             "Epilogue scale does not match the extent of its output leg", l);
+    scaled = true;
+  }
+  if (!scaled) return {};
+
+  std::vector<std::pair<std::ptrdiff_t, T>> table{{0, T(1)}};
+  for (std::size_t l = first; l < last; ++l)
+  {
+    std::vector<std::pair<std::ptrdiff_t, T>> next;
+    next.reserve(table.size() * C.extent(l));
+    for (auto const& [offset, factor] : table)
+      for (index_type e = 0; e < static_cast<index_type>(C.extent(l)); ++e)
+        next.emplace_back(offset + e * C.stride(l), scale[l].empty() ? factor : factor * scale[l][e]);
+    table = std::move(next);
+  }
+  std::ranges::sort(table, {}, &std::pair<std::ptrdiff_t, T>::first);
+
+  std::vector<T> out(table.size());
+  auto offsets = cpu::make_group_offsets<1>(grp);
+  for (std::size_t i = 0; i < out.size(); ++i)
+    out[i] = std::ranges::lower_bound(table, offsets[i], {}, &std::pair<std::ptrdiff_t, T>::first)->second;
+  return out;
+}
+
+} // namespace detail
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, typename U, MutableStridedMdspan CType,
+          typename TagType, std::size_t R, typename F, typename Acc>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N && R == CType::rank())
+    /// \brief Dispatch a tensor contraction with a fused epilogue and contraction options.
+    /// \details Computes C = f(β·C + α·(op(A) ⋅ op(B))·D), where D is the diagonal scaling of \p ep per output
+    ///          leg and f its elementwise functor. Both are applied as the output is written, rather than in a
+    ///          separate pass over C.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \tparam R Rank of the output tensor.
+    /// \tparam F Elementwise epilogue functor.
+    /// \tparam Acc Requested accumulator type, or void for the tensor scalar type.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \param ep Diagonal scaling per output leg and elementwise functor.
+    /// \param opts Conjugation flags and accumulator type.
+    /// \ingroup kernel_ops
+    void contract(T const& alpha, AType A, BType B,
+                  std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, U const& beta, CType C,
+                  TagType tag, contract_epilogue<std::remove_const_t<typename CType::element_type>, R, F> const& ep,
+                  contract_options<Acc> opts)
+{
+  using S = std::remove_const_t<typename CType::element_type>;
+  constexpr std::size_t MR = AType::rank() - N;
+  auto [Mgroup, Ngroup, Kgroup] = extract_strides(A, B, contractDims, C);
+  auto const rows = detail::flat_leg_scale(C, ep.scale, 0, MR, Mgroup);
+  auto const cols = detail::flat_leg_scale(C, ep.scale, MR, R, Ngroup);
+  flat_epilogue<S, F> const flat{rows.empty() ? nullptr : rows.data(), cols.empty() ? nullptr : cols.data(), ep.op};
+  contract_strided(Mgroup, Ngroup, Kgroup, S(alpha), A.data_handle(), B.data_handle(), S(beta), C.data_handle(), tag,
+                   opts, flat);
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, typename U, MutableStridedMdspan CType,
+          typename TagType, std::size_t R, typename F>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N && R == CType::rank())
+    /// \brief Dispatch a tensor contraction with a fused epilogue, C = f(β·C + α·(A ⋅ B)·D).
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \tparam R Rank of the output tensor.
+    /// \tparam F Elementwise epilogue functor.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \param ep Diagonal scaling per output leg and elementwise functor.
+    /// \ingroup kernel_ops
+    void contract(T const& alpha, AType A, BType B,
+                  std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, U const& beta, CType C,
+                  TagType tag, contract_epilogue<std::remove_const_t<typename CType::element_type>, R, F> const& ep)
+{
+  contract(alpha, A, B, contractDims, beta, C, tag, ep, contract_options<>{});
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, typename U, MutableStridedMdspan CType,
+          typename TagType, std::size_t N, std::size_t R, typename F>
+/// \brief Overload forwarding compile-time dimension pairs to the dispatcher with a fused epilogue.
+/// \tparam T Scalar used for scaling the contraction inputs and output.
+/// \tparam AType Strided mdspan describing the left-hand tensor operand.
+/// \tparam BType Strided mdspan describing the right-hand tensor operand.
+/// \tparam U Scalar type used to scale the destination tensor.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \tparam N Number of contracted index pairs.
+/// \tparam R Rank of the output tensor.
+/// \tparam F Elementwise epilogue functor.
+/// \param alpha Scaling factor for the contraction result.
+/// \param A Left-hand tensor operand.
+/// \param B Right-hand tensor operand.
+/// \param dims Compile-time array reference listing contracted dimension pairs.
+/// \param beta Scaling factor applied to the pre-existing contents of \p C.
+/// \param C Destination tensor.
+/// \param tag Backend selector instance.
+/// \param ep Diagonal scaling per output leg and elementwise functor.
+/// \ingroup kernel_ops
+void contract(T const& alpha, AType A, BType B, const std::pair<std::size_t, std::size_t> (&dims)[N], U const& beta,
+              CType C, TagType tag, contract_epilogue<std::remove_const_t<typename CType::element_type>, R, F> const& ep)
+{
+  contract(alpha, A, B, std::to_array(dims), beta, C, tag, ep, contract_options<>{});
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, typename U, MutableStridedMdspan CType,
+          typename TagType>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N)
+    /// \brief Dispatch a multithreaded tensor contraction to the backend associated with \p TagType.
+    /// \details The flattened output is partitioned into tiles (and, for small outputs, chunks of the contracted
+    ///          extent) that run on \p arena. Contractions too small to benefit run serially.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \param arena Arena providing the worker threads (e.g. async::TbbScheduler::arena()), or null to use the
+    ///              arena of the calling thread.
+    /// \ingroup kernel_ops
+    void contract_parallel(T const& alpha, AType A, BType B,
+                           std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, U const& beta,
+                           CType C, TagType tag, oneapi::tbb::task_arena* arena = nullptr)
+{
+  auto [Mgroup, Ngroup, Kgroup] = extract_strides(A, B, contractDims, C);
+  contract_strided_parallel(Mgroup, Ngroup, Kgroup, alpha, A.data_handle(), B.data_handle(), beta, C.data_handle(),
+                            tag, arena);
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, typename U, MutableStridedMdspan CType,
+          typename TagType, std::size_t N>
+/// \brief Overload forwarding compile-time dimension pairs to the multithreaded dispatcher.
+/// \tparam T Scalar used for scaling the contraction inputs and output.
+/// \tparam AType Strided mdspan describing the left-hand tensor operand.
+/// \tparam BType Strided mdspan describing the right-hand tensor operand.
+/// \tparam U Scalar type used to scale the destination tensor.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \tparam N Number of contracted index pairs.
+/// \param alpha Scaling factor for the contraction result.
+/// \param A Left-hand tensor operand.
+/// \param B Right-hand tensor operand.
+/// \param dims Compile-time array reference listing contracted dimension pairs.
+/// \param beta Scaling factor applied to the pre-existing contents of \p C.
+/// \param C Destination tensor.
+/// \param tag Backend selector instance.
+/// \param arena Arena providing the worker threads, or null to use the arena of the calling thread.
+/// \ingroup kernel_ops
+void contract_parallel(T const& alpha, AType A, BType B, const std::pair<std::size_t, std::size_t> (&dims)[N],
+                       U const& beta, CType C, TagType tag, oneapi::tbb::task_arena* arena = nullptr)
+{
+  contract_parallel(alpha, A, B, std::to_array(dims), beta, C, tag, arena);
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, std::size_t NB, typename U,
+          MutableStridedMdspan CType, typename TagType>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N + NB)
+    /// \brief Dispatch a batched tensor contraction to the backend associated with \p TagType.
+    /// \details Batch legs are shared by A, B and C: for every batch index an independent contraction
+    ///          C_b = β·C_b + α·(A_b ⋅ B_b) is performed. The leading legs of \p C are the batch legs, in the order
+    ///          of \p batchDims, followed by the uncontracted legs of \p A and then of \p B.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam NB Number of batch index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param batchDims Pairing of batch dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \ingroup kernel_ops
+    void contract_batched(T const& alpha, AType A, BType B,
+                          std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims,
+                          std::array<std::pair<std::size_t, std::size_t>, NB> const& batchDims, U const& beta,
+                          CType C, TagType tag)
+{
+  auto [Bgroup, Mgroup, Ngroup, Kgroup] = extract_strides_batched(A, B, contractDims, batchDims, C);
+  contract_strided_batched(Bgroup, Mgroup, Ngroup, Kgroup, alpha, A.data_handle(), B.data_handle(), beta,
+                           C.data_handle(), tag);
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, std::size_t NB, typename U,
+          MutableStridedMdspan CType, typename TagType>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N + NB)
+    /// \brief Dispatch a multithreaded batched tensor contraction to the backend associated with \p TagType.
+    /// \details Independent batches run concurrently when there are enough of them to occupy \p arena;
+    ///          otherwise each batch is contracted in turn by the multithreaded kernel.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam NB Number of batch index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param batchDims Pairing of batch dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \param arena Arena providing the worker threads, or null to use the arena of the calling thread.
+    /// \ingroup kernel_ops
+    void contract_batched_parallel(T const& alpha, AType A, BType B,
+                                   std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims,
+                                   std::array<std::pair<std::size_t, std::size_t>, NB> const& batchDims,
+                                   U const& beta, CType C, TagType tag, oneapi::tbb::task_arena* arena = nullptr)
+{
+  auto [Bgroup, Mgroup, Ngroup, Kgroup] = extract_strides_batched(A, B, contractDims, batchDims, C);
+  contract_strided_batched_parallel(Bgroup, Mgroup, Ngroup, Kgroup, alpha, A.data_handle(), B.data_handle(), beta,
+                                    C.data_handle(), tag, arena);
+}
+
 } // namespace uni20::kernel
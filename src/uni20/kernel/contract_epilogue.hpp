@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * \file contract_epilogue.hpp
+ * \ingroup kernel_ops
+ * \brief Elementwise epilogues fused into the write-back of a tensor contraction.
+ * \details An epilogue turns C = β·C + α·(A ⋅ B) into C = f(β·C + α·(A ⋅ B)·D), where D is a product of
+ *          diagonal matrices, one per output leg, and f is an elementwise functor. Both are applied while an
+ *          output tile is written, so neither costs a second pass over C in the CPU engines.
+ */
+
+#include <uni20/core/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace uni20::kernel
+{
+
+/// \brief Epilogue functor that leaves every output element unchanged.
+/// \ingroup kernel_ops
+struct identity_epilogue
+{
+    template <typename T> constexpr T operator()(T const& x) const noexcept { return x; }
+};
+
+/// \brief Epilogue of a contraction into a rank-\p R output: per-leg diagonal scaling and an elementwise functor.
+/// \details Entry \c scale[l] holds the diagonal applied along output leg \c l and must have the extent of that
+///          leg; an empty span leaves the leg unscaled. The scaling multiplies the product term only, i.e.
+///          C = f(β·C + α·(A ⋅ B)·D), which is the contraction with a diagonal tensor such as a set of singular
+///          values.
+/// \tparam T Scalar type of the output tensor.
+/// \tparam R Rank of the output tensor.
+/// \tparam F Elementwise functor invoked as `T f(T)`.
+/// \ingroup kernel_ops
+template <typename T, std::size_t R, typename F = identity_epilogue> struct contract_epilogue
+{
+    std::array<std::span<T const>, R> scale{}; ///< Diagonal per output leg; empty for no scaling.
+    F op{};                                    ///< Elementwise functor applied to every output element.
+
+    /// \brief True if at least one output leg is scaled.
+    constexpr bool scaled() const noexcept
+    {
+      for (auto const& s : scale)
+        if (!s.empty()) return true;
+      return false;
+    }
+};
+
+/// \brief Epilogue lowered onto the flattened M×N index space of a contraction engine.
+/// \details The scale tables are indexed by the flattened M and N indices in the order of the merged stride
+///          groups, and either may be null.
+/// \tparam T Scalar type of the output tensor.
+/// \tparam F Elementwise functor invoked as `T f(T)`.
+/// \ingroup internal
+template <typename T, typename F = identity_epilogue> struct flat_epilogue
+{
+    static constexpr bool has_op = !std::is_same_v<F, identity_epilogue>;
+
+    T const* row_scale = nullptr; ///< Scale factor per flattened M index, or null.
+    T const* col_scale = nullptr; ///< Scale factor per flattened N index, or null.
+    F op{};                       ///< Elementwise functor applied to every output element.
+
+    /// \brief True if the product term is scaled.
+    constexpr bool scaled() const noexcept { return row_scale || col_scale; }
+
+    /// \brief Scale factor of output element (i, j).
+    constexpr T scale(index_type i, index_type j) const noexcept
+    {
+      T s(1);
+      if (row_scale) s *= row_scale[i];
+      if (col_scale) s *= col_scale[j];
+      return s;
+    }
+};
+
+} // namespace uni20::kernel
@@ -0,0 +1,618 @@
+#pragma once
+
+/**
+ * \file contract_network.hpp
+ * \ingroup kernel_ops
+ * \brief Einsum-like contraction of tensor networks with automatic pairwise ordering.
+ * \details A network is described by a specification such as `"ab,bc,cd->ad"`: one label string per input
+ *          tensor and one for the output, each character naming a leg. Every label must occur exactly twice
+ *          over the inputs and the output, so each label is either contracted between two inputs or is an
+ *          open leg of one input that appears in the output.
+ *
+ *          plan_network() chooses a pairwise contraction order, either exhaustively (dynamic programming over
+ *          subsets, for small networks) or greedily. The objective is the total number of multiply-adds, with
+ *          the largest intermediate as a tie-break. contract_network() executes the order with
+ *          contract_strided(); intermediates are row-major and their buffers are recycled once consumed.
+ */
+
+#include "contract.hpp"
+#include <uni20/common/namedenum.hpp>
+#include <uni20/common/static_vector.hpp>
+#include <uni20/common/trace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace uni20::kernel
+{
+
+/// \brief Maximum rank of any tensor, including intermediates, in a contracted network.
+/// \ingroup kernel_ops
+inline constexpr std::size_t network_max_rank = 16;
+
+/// \brief Largest number of inputs for which NetworkOrder::Auto uses the exhaustive search.
+/// \ingroup kernel_ops
+inline constexpr std::size_t network_optimal_limit = 10;
+
+/// \brief Largest number of inputs accepted by the exhaustive order search, which takes time and memory
+///        exponential in the number of inputs.
+/// \ingroup kernel_ops
+inline constexpr std::size_t network_optimal_max_inputs = 16;
+
+/// \brief Traits for the NetworkOrder enumeration.
+/// \ingroup kernel_ops
+struct NetworkOrderTraits
+{
+    enum Enum
+    {
+      Auto,
+      Greedy,
+      Optimal
+    };
+    inline static constexpr Enum Default = Auto;
+    inline static constexpr const char* StaticName = "network contraction order search";
+    inline static constexpr std::array<const char*, 3> Names = {"auto", "greedy", "optimal"};
+};
+
+/// \brief Strategy used by plan_network(): exhaustive for up to network_optimal_limit inputs, otherwise greedy.
+/// \ingroup kernel_ops
+using NetworkOrder = NamedEnumeration<NetworkOrderTraits>;
+
+/// \brief Parsed network specification.
+/// \ingroup kernel_ops
+struct network_spec
+{
+    std::vector<std::string> inputs; ///< Leg labels of each input tensor.
+    std::string output;              ///< Leg labels of the output tensor.
+};
+
+/// \brief Pairwise contraction order for a network.
+/// \details Operands are numbered in static single assignment form: inputs are 0..N-1 and step s produces
+///          operand N+s. The last step produces the output.
+/// \ingroup kernel_ops
+struct network_path
+{
+    std::vector<std::pair<std::size_t, std::size_t>> steps; ///< Operand ids contracted at each step.
+    double flops = 0;                                       ///< Total multiply-adds over all steps.
+    double peak_size = 0;                                   ///< Elements in the largest intermediate or output.
+};
+
+/// \brief Parse an einsum-like specification `"lhs0,lhs1,...->out"`.
+/// \param spec Specification string; spaces are ignored.
+/// \return The parsed label strings.
+/// \ingroup kernel_ops
+inline network_spec parse_network_spec(std::string_view spec)
+{
+  auto arrow = spec.find("->");
+  ERROR_IF(arrow == std::string_view::npos, "network specification requires '->'", spec);
+  network_spec result;
+  std::string current;
+  for (char c : spec.substr(0, arrow))
+  {
+    if (c == ' ') continue;
+    if (c == ',')
+    {
+      result.inputs.push_back(std::move(current));
+      current.clear();
+    }
+    else
+      current.push_back(c);
+  }
+  result.inputs.push_back(std::move(current));
+  for (char c : spec.substr(arrow + 2))
+  {
+    if (c != ' ') result.output.push_back(c);
+  }
+
+  for (auto const& labels : result.inputs)
+  {
+    for (char l : labels)
+    {
+      ERROR_IF(std::ranges::count(labels, l) != 1, "repeated label within a network input (traces are not supported)",
+               spec, l);
+      std::size_t count = std::ranges::count(result.output, l);
+      for (auto const& other : result.inputs)
+        count += std::ranges::count(other, l);
+      ERROR_IF(count != 2, "each network label must appear exactly twice over the inputs and output", spec, l);
+    }
+  }
+  for (char l : result.output)
+  {
+    ERROR_IF(std::ranges::count(result.output, l) != 1, "repeated output label", spec, l);
+    std::size_t count = 0;
+    for (auto const& labels : result.inputs)
+      count += std::ranges::count(labels, l);
+    ERROR_IF(count != 1, "each network output label must appear in exactly one input", spec, l);
+  }
+  return result;
+}
+
+namespace detail
+{
+
+/// \brief Label bookkeeping shared by the order searches.
+/// \ingroup internal
+class network_labels {
+  public:
+    network_labels(network_spec const& spec, std::vector<std::vector<index_type>> const& extents) : spec_(spec)
+    {
+      // subsets of the inputs are bit masks
+      ERROR_IF(spec.inputs.size() >= std::size_t(std::numeric_limits<std::size_t>::digits),
+               "too many inputs for a network contraction", spec.inputs.size());
+      ERROR_IF(extents.size() != spec.inputs.size(), "wrong number of extent lists for the network", extents.size(),
+               spec.inputs.size());
+      for (std::size_t t = 0; t < spec.inputs.size(); ++t)
+      {
+        ERROR_IF(extents[t].size() != spec.inputs[t].size(), "network operand rank does not match its labels", t);
+        for (std::size_t i = 0; i < extents[t].size(); ++i)
+        {
+          char l = spec.inputs[t][i];
+          auto it = std::ranges::find(labels_, l);
+          if (it == labels_.end())
+          {
+            labels_.push_back(l);
+            extent_.push_back(extents[t][i]);
+          }
+          else
+          {
+            ERROR_IF(extent_[it - labels_.begin()] != extents[t][i], "inconsistent extent for network label", l);
+          }
+        }
+      }
+    }
+
+    std::size_t num_inputs() const noexcept { return spec_.inputs.size(); }
+
+    /// \brief Labels of the tensor formed by contracting the input subset \p mask.
+    std::string result_labels(std::size_t mask) const
+    {
+      std::string out;
+      for (std::size_t t = 0; t < num_inputs(); ++t)
+      {
+        if (!(mask & (std::size_t(1) << t))) continue;
+        for (char l : spec_.inputs[t])
+        {
+          if (this->is_open(l, mask)) out.push_back(l);
+        }
+      }
+      return out;
+    }
+
+    /// \brief Number of elements of a tensor with the given labels.
+    double size(std::string const& labels) const
+    {
+      double s = 1;
+      for (char l : labels)
+        s *= static_cast<double>(this->extent(l));
+      return s;
+    }
+
+    /// \brief Multiply-adds needed to contract tensors with labels \p a and \p b.
+    double flops(std::string const& a, std::string const& b) const
+    {
+      std::string all = a;
+      for (char l : b)
+      {
+        if (all.find(l) == std::string::npos) all.push_back(l);
+      }
+      return this->size(all);
+    }
+
+    index_type extent(char l) const
+    {
+      auto it = std::ranges::find(labels_, l);
+      CHECK(it != labels_.end(), "unknown network label", l);
+      return extent_[it - labels_.begin()];
+    }
+
+  private:
+    network_spec const& spec_;
+    std::string labels_;
+    std::vector<index_type> extent_;
+
+    // a label of the subset stays open if it appears in the output or in an input outside the subset
+    bool is_open(char l, std::size_t mask) const
+    {
+      if (spec_.output.find(l) != std::string::npos) return true;
+      for (std::size_t t = 0; t < num_inputs(); ++t)
+      {
+        if (!(mask & (std::size_t(1) << t)) && spec_.inputs[t].find(l) != std::string::npos) return true;
+      }
+      return false;
+    }
+};
+
+/// \brief Exhaustive order search by dynamic programming over subsets of the inputs.
+/// \ingroup internal
+inline network_path optimal_network_path(network_labels const& net)
+{
+  std::size_t const n = net.num_inputs();
+  ERROR_IF(n > network_optimal_max_inputs, "too many network inputs for the exhaustive order search", n,
+           network_optimal_max_inputs);
+  std::size_t const full = (std::size_t(1) << n) - 1;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> cost(full + 1, inf), peak(full + 1, 0);
+  std::vector<std::size_t> split(full + 1, 0);
+  std::vector<std::string> labels(full + 1);
+  for (std::size_t mask = 1; mask <= full; ++mask)
+  {
+    labels[mask] = net.result_labels(mask);
+    if (std::has_single_bit(mask)) cost[mask] = 0;
+  }
+
+  for (std::size_t mask = 1; mask <= full; ++mask)
+  {
+    if (std::has_single_bit(mask)) continue;
+    double const size = net.size(labels[mask]);
+    // enumerate each unordered split once by requiring the lowest set bit to be in `sub`
+    std::size_t const low = mask & (~mask + 1);
+    for (std::size_t sub = (mask - 1) & mask; sub; sub = (sub - 1) & mask)
+    {
+      if (!(sub & low)) continue;
+      std::size_t const rest = mask ^ sub;
+      double const c = cost[sub] + cost[rest] + net.flops(labels[sub], labels[rest]);
+      double const p = std::max({peak[sub], peak[rest], size});
+      if (c < cost[mask] || (c == cost[mask] && p < peak[mask]))
+      {
+        cost[mask] = c;
+        peak[mask] = p;
+        split[mask] = sub;
+      }
+    }
+  }
+
+  network_path path;
+  path.flops = cost[full];
+  path.peak_size = peak[full];
+  // emit the steps in post-order, assigning SSA ids as intermediates are produced
+  auto emit = [&](auto&& self, std::size_t mask) -> std::size_t {
+    if (std::has_single_bit(mask)) return static_cast<std::size_t>(std::countr_zero(mask));
+    std::size_t a = self(self, split[mask]);
+    std::size_t b = self(self, mask ^ split[mask]);
+    path.steps.emplace_back(a, b);
+    return n + path.steps.size() - 1;
+  };
+  emit(emit, full);
+  return path;
+}
+
+/// \brief Greedy order search: repeatedly contract the pair that most reduces the total stored size.
+/// \details Pairs sharing a label are preferred over outer products; ties are broken by fewer multiply-adds.
+/// \ingroup internal
+inline network_path greedy_network_path(network_labels const& net)
+{
+  std::size_t const n = net.num_inputs();
+  struct live
+  {
+      std::size_t id;
+      std::size_t mask;
+      std::string labels;
+  };
+  std::vector<live> nodes;
+  for (std::size_t t = 0; t < n; ++t)
+    nodes.push_back({t, std::size_t(1) << t, net.result_labels(std::size_t(1) << t)});
+
+  network_path path;
+  while (nodes.size() > 1)
+  {
+    std::size_t best_i = 0, best_j = 1;
+    bool best_shared = false;
+    double best_delta = std::numeric_limits<double>::infinity(), best_flops = best_delta;
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      for (std::size_t j = i + 1; j < nodes.size(); ++j)
+      {
+        bool const shared = std::ranges::any_of(nodes[i].labels, [&](char l) {
+          return nodes[j].labels.find(l) != std::string::npos;
+        });
+        std::string const result = net.result_labels(nodes[i].mask | nodes[j].mask);
+        double const delta = net.size(result) - net.size(nodes[i].labels) - net.size(nodes[j].labels);
+        double const f = net.flops(nodes[i].labels, nodes[j].labels);
+        if (std::tuple(!shared, delta, f) < std::tuple(!best_shared, best_delta, best_flops))
+        {
+          best_i = i;
+          best_j = j;
+          best_shared = shared;
+          best_delta = delta;
+          best_flops = f;
+        }
+      }
+    }
+    live merged{n + path.steps.size(), nodes[best_i].mask | nodes[best_j].mask, {}};
+    merged.labels = net.result_labels(merged.mask);
+    path.steps.emplace_back(nodes[best_i].id, nodes[best_j].id);
+    path.flops += best_flops;
+    path.peak_size = std::max(path.peak_size, net.size(merged.labels));
+    nodes.erase(nodes.begin() + best_j);
+    nodes.erase(nodes.begin() + best_i);
+    nodes.push_back(std::move(merged));
+  }
+  return path;
+}
+
+/// \brief A runtime-rank operand of a network contraction.
+/// \ingroup internal
+template <typename P> struct labeled_operand
+{
+    P* data;
+    std::string labels;
+    std::vector<index_type> extents;
+    std::vector<std::ptrdiff_t> strides;
+
+    std::ptrdiff_t stride_of(char l) const { return strides[labels.find(l)]; }
+};
+
+/// \brief Build a labeled operand from an mdspan.
+/// \ingroup internal
+template <StridedMdspan Span>
+auto make_labeled_operand(Span const& s, std::string labels)
+{
+  labeled_operand<typename Span::element_type> op{s.data_handle(), std::move(labels), {}, {}};
+  for (std::size_t i = 0; i < Span::rank(); ++i)
+  {
+    op.extents.push_back(static_cast<index_type>(s.extent(i)));
+    op.strides.push_back(static_cast<std::ptrdiff_t>(s.stride(i)));
+  }
+  return op;
+}
+
+/// \brief Contract two labeled operands into a labeled destination, matching legs by label.
+/// \details Labels shared by \p A and \p B are contracted; all other labels must appear in \p C.
+/// \ingroup internal
+template <typename T, typename TagType>
+void contract_labeled(T alpha, labeled_operand<T const> const& A, labeled_operand<T const> const& B, T beta,
+                      labeled_operand<T> const& C, TagType tag)
+{
+  static_vector<extent_strides<2>, network_max_rank> Mgrp, Ngrp, Kgrp;
+  for (std::size_t i = 0; i < A.labels.size(); ++i)
+  {
+    char l = A.labels[i];
+    if (auto j = B.labels.find(l); j != std::string::npos)
+      Kgrp.push_back(extent_strides<2>(A.extents[i], {A.strides[i], B.strides[j]}));
+    else
+      Mgrp.push_back(extent_strides<2>(A.extents[i], {A.strides[i], C.stride_of(l)}));
+  }
+  for (std::size_t j = 0; j < B.labels.size(); ++j)
+  {
+    char l = B.labels[j];
+    if (A.labels.find(l) == std::string::npos)
+      Ngrp.push_back(extent_strides<2>(B.extents[j], {B.strides[j], C.stride_of(l)}));
+  }
+  merge_strides_right(Mgrp);
+  merge_strides_right(Ngrp);
+  merge_strides_right(Kgrp);
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A.data, B.data, beta, C.data, tag);
+}
+
+/// \brief Recycles intermediate buffers between the steps of a network contraction.
+/// \ingroup internal
+template <typename T> class network_buffer_pool {
+  public:
+    /// \brief Obtain a zero-filled buffer of \p size elements, reusing the best-fitting free buffer.
+    std::size_t acquire(std::size_t size)
+    {
+      // prefer the smallest free buffer that is large enough, otherwise grow the largest one
+      std::size_t best = free_.size();
+      for (std::size_t i = 0; i < free_.size(); ++i)
+      {
+        if (best == free_.size() || this->better_fit(free_[i], free_[best], size)) best = i;
+      }
+      std::size_t id;
+      if (best < free_.size())
+      {
+        id = free_[best];
+        free_.erase(free_.begin() + best);
+      }
+      else
+      {
+        id = buffers_.size();
+        buffers_.emplace_back();
+      }
+      buffers_[id].assign(size, T{});
+      return id;
+    }
+
+    void release(std::size_t id) { free_.push_back(id); }
+
+    T* data(std::size_t id) { return buffers_[id].data(); }
+
+    /// \brief Number of distinct buffers ever allocated.
+    std::size_t allocated() const noexcept { return buffers_.size(); }
+
+  private:
+    std::vector<std::vector<T>> buffers_;
+    std::vector<std::size_t> free_;
+    bool better_fit(std::size_t a, std::size_t b, std::size_t size) const
+    {
+      std::size_t const ca = buffers_[a].capacity(), cb = buffers_[b].capacity();
+      if ((ca >= size) != (cb >= size)) return ca >= size;
+      return ca >= size ? ca < cb : ca > cb;
+    }
+};
+
+} // namespace detail
+
+/// \brief Choose a pairwise contraction order for a network.
+/// \param spec Network specification, e.g. `"ab,bc,cd->ad"`.
+/// \param extents Extents of each input tensor, in label order.
+/// \param method Search strategy.
+/// \return The contraction order with its multiply-add count and largest intermediate size.
+/// \ingroup kernel_ops
+inline network_path plan_network(std::string_view spec, std::vector<std::vector<index_type>> const& extents,
+                                 NetworkOrder method = NetworkOrder::Auto)
+{
+  network_spec parsed = parse_network_spec(spec);
+  ERROR_IF(parsed.inputs.size() < 2, "a network contraction needs at least two inputs", spec);
+  detail::network_labels net(parsed, extents);
+  if (method == NetworkOrder::Optimal ||
+      (method == NetworkOrder::Auto && parsed.inputs.size() <= network_optimal_limit))
+    return detail::optimal_network_path(net);
+  return detail::greedy_network_path(net);
+}
+
+/// \brief Execute a network contraction along a given order: C = β·C + α·(network).
+/// \details The path is checked before anything is computed: it must contract each operand and intermediate
+///          exactly once, so that the last step combines everything into the output, and the extents of the
+///          operands and of \p C must agree for every label.
+/// \tparam U Scalar type of the scaling factors.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \tparam Ops Strided mdspans describing the input tensors.
+/// \param spec Network specification, e.g. `"ab,bc,cd->ad"`.
+/// \param path Pairwise order, e.g. from plan_network().
+/// \param alpha Scaling factor for the network result.
+/// \param beta Scaling factor applied to the pre-existing contents of \p C.
+/// \param C Destination tensor, with legs ordered as the output labels.
+/// \param tag Backend selector instance.
+/// \param operands Input tensors, with legs ordered as their labels.
+/// \ingroup kernel_ops
+template <typename U, MutableStridedMdspan CType, typename TagType, StridedMdspan... Ops>
+void execute_network(std::string_view spec, network_path const& path, U const& alpha, U const& beta, CType C,
+                     TagType tag, Ops const&... operands)
+{
+  using T = std::remove_const_t<typename CType::element_type>;
+  network_spec parsed = parse_network_spec(spec);
+  constexpr std::size_t n = sizeof...(Ops);
+  ERROR_IF(n < 2, "a network contraction needs at least two inputs", spec);
+  ERROR_IF(parsed.inputs.size() != n, "number of network operands does not match the specification", spec, n);
+  ERROR_IF(path.steps.size() + 1 != n, "network path has the wrong number of steps", path.steps.size(), n);
+  ERROR_IF(parsed.output.size() != CType::rank(), "network output rank does not match the specification", spec);
+
+  std::vector<detail::labeled_operand<T const>> nodes;
+  std::vector<std::ptrdiff_t> buffer_of;
+  std::size_t t = 0;
+  (
+      [&] {
+        ERROR_IF(parsed.inputs[t].size() != Ops::rank(), "network operand rank does not match its labels", t);
+        auto op = detail::make_labeled_operand(operands, parsed.inputs[t]);
+        nodes.push_back({op.data, std::move(op.labels), std::move(op.extents), std::move(op.strides)});
+        buffer_of.push_back(-1);
+        ++t;
+      }(),
+      ...);
+
+  std::vector<std::vector<index_type>> extents;
+  for (auto const& node : nodes)
+    extents.push_back(node.extents);
+  detail::network_labels net(parsed, extents);
+  auto output = detail::make_labeled_operand(C, parsed.output);
+  for (std::size_t i = 0; i < output.labels.size(); ++i)
+  {
+    char l = output.labels[i];
+    ERROR_IF(output.extents[i] != net.extent(l), "network output extent does not match its label", l,
+             output.extents[i], net.extent(l));
+  }
+
+  // every operand and intermediate is consumed by exactly one step, so the last step consumes the last two
+  std::vector<bool> consumed(n + path.steps.size(), false);
+  for (std::size_t s = 0; s < path.steps.size(); ++s)
+  {
+    auto [ia, ib] = path.steps[s];
+    ERROR_IF(ia >= n + s || ib >= n + s || ia == ib, "invalid network path step", s, ia, ib);
+    ERROR_IF(consumed[ia] || consumed[ib], "network path step uses an operand that was already contracted", s, ia,
+             ib);
+    consumed[ia] = consumed[ib] = true;
+  }
+
+  detail::network_buffer_pool<T> pool;
+  for (std::size_t s = 0; s < path.steps.size(); ++s)
+  {
+    auto [ia, ib] = path.steps[s];
+    auto const& A = nodes[ia];
+    auto const& B = nodes[ib];
+
+    if (s + 1 == path.steps.size())
+    {
+      std::string open;
+      for (char l : A.labels)
+      {
+        if (B.labels.find(l) == std::string::npos) open.push_back(l);
+      }
+      for (char l : B.labels)
+      {
+        if (A.labels.find(l) == std::string::npos) open.push_back(l);
+      }
+      ERROR_IF(!std::ranges::is_permutation(open, parsed.output), "network path does not produce the output labels",
+               open, parsed.output);
+      detail::contract_labeled(T(alpha), A, B, T(beta), output, tag);
+      break;
+    }
+
+    // intermediate: A's open legs then B's open legs, row-major
+    detail::labeled_operand<T> R{nullptr, {}, {}, {}};
+    for (std::size_t i = 0; i < A.labels.size(); ++i)
+    {
+      if (B.labels.find(A.labels[i]) == std::string::npos)
+      {
+        R.labels.push_back(A.labels[i]);
+        R.extents.push_back(A.extents[i]);
+      }
+    }
+    for (std::size_t j = 0; j < B.labels.size(); ++j)
+    {
+      if (A.labels.find(B.labels[j]) == std::string::npos)
+      {
+        R.labels.push_back(B.labels[j]);
+        R.extents.push_back(B.extents[j]);
+      }
+    }
+    ERROR_IF(R.labels.size() > network_max_rank, "network intermediate exceeds network_max_rank", R.labels.size());
+    R.strides.resize(R.labels.size());
+    std::ptrdiff_t size = 1;
+    for (std::size_t i = R.labels.size(); i-- > 0;)
+    {
+      R.strides[i] = size;
+      size *= R.extents[i];
+    }
+    std::size_t id = pool.acquire(static_cast<std::size_t>(size));
+    R.data = pool.data(id);
+
+    detail::contract_labeled(T(1), A, B, T(0), R, tag);
+
+    for (auto i : {ia, ib})
+    {
+      if (buffer_of[i] >= 0) pool.release(static_cast<std::size_t>(buffer_of[i]));
+    }
+    nodes.push_back({R.data, std::move(R.labels), std::move(R.extents), std::move(R.strides)});
+    buffer_of.push_back(static_cast<std::ptrdiff_t>(id));
+  }
+}
+
+/// \brief Contract a tensor network, choosing the pairwise order automatically: C = β·C + α·(network).
+/// \tparam U Scalar type of the scaling factors.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \tparam Ops Strided mdspans describing the input tensors.
+/// \param spec Network specification, e.g. `"ab,bc,cd->ad"`.
+/// \param alpha Scaling factor for the network result.
+/// \param beta Scaling factor applied to the pre-existing contents of \p C.
+/// \param C Destination tensor, with legs ordered as the output labels.
+/// \param tag Backend selector instance.
+/// \param operands Input tensors, with legs ordered as their labels.
+/// \ingroup kernel_ops
+template <typename U, MutableStridedMdspan CType, typename TagType, StridedMdspan... Ops>
+void contract_network(std::string_view spec, U const& alpha, U const& beta, CType C, TagType tag,
+                      Ops const&... operands)
+{
+  std::vector<std::vector<index_type>> extents;
+  (
+      [&] {
+        std::vector<index_type> e;
+        for (std::size_t i = 0; i < Ops::rank(); ++i)
+          e.push_back(static_cast<index_type>(operands.extent(i)));
+        extents.push_back(std::move(e));
+      }(),
+      ...);
+  auto path = plan_network(spec, extents);
+  execute_network(spec, path, alpha, beta, C, tag, operands...);
+}
+
+} // namespace uni20::kernel
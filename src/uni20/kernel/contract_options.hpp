@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * \file contract_options.hpp
+ * \ingroup kernel_ops
+ * \brief Per-call options for tensor contractions: operand conjugation and accumulator precision.
+ */
+
+#include <type_traits>
+
+namespace uni20::kernel
+{
+
+/// \brief Options modifying a tensor contraction.
+/// \details Setting \c conj_a or \c conj_b contracts with the complex conjugate of that operand without
+///          materialising it; the flags have no effect on real scalars. \p Acc selects the type in which
+///          products are accumulated, e.g. `double` for `float` tensors over a long contracted extent.
+/// \tparam Acc Accumulator type, or `void` to accumulate in the scalar type of the tensors.
+/// \ingroup kernel_ops
+template <typename Acc = void> struct contract_options
+{
+    using accumulator_type = Acc;
+
+    bool conj_a = false; ///< Contract with conj(A).
+    bool conj_b = false; ///< Contract with conj(B).
+};
+
+/// \brief Accumulator type used for tensors of scalar type \p T under the accumulator request \p Acc.
+/// \ingroup kernel_ops
+template <typename T, typename Acc> using contract_accumulator_t = std::conditional_t<std::is_void_v<Acc>, T, Acc>;
+
+} // namespace uni20::kernel
@@ -0,0 +1,419 @@
+#pragma once
+
+/**
+ * \file contraction_plan.hpp
+ * \ingroup kernel_ops
+ * \brief Reusable contraction plans and a process-wide LRU cache of plans.
+ * \details A ContractionPlan captures everything that kernel::contract() derives from the operand layouts:
+ *          the merged M/N/K stride groups (which also fix the loop order, outermost first), the backend
+ *          selected for the stride pattern, the backend's offset tables, and the size of the scratch memory it
+ *          packs operands into. Building the plan once and executing it many times avoids repeating that
+ *          analysis and those allocations for contractions of a fixed shape; the scratch is kept per thread
+ *          and reused by every plan executed on that thread.
+ */
+
+#include "contract.hpp"
+#include <uni20/common/aligned_buffer.hpp>
+#include <uni20/common/namedenum.hpp>
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+
+namespace uni20::kernel
+{
+
+/// \brief Traits for the ContractionBackend enumeration.
+/// \ingroup kernel_ops
+struct ContractionBackendTraits
+{
+    enum Enum
+    {
+      Loop,
+      Blocked,
+      Gemm,
+      TTGT
+    };
+    inline static constexpr Enum Default = Loop;
+    inline static constexpr const char* StaticName = "contraction backend";
+    inline static constexpr std::array<const char*, 4> Names = {"loop", "blocked", "gemm", "ttgt"};
+};
+
+/// \brief Algorithm chosen by a ContractionPlan: recursive loop, cache-blocked engine, a single BLAS `gemm`,
+///        or BLAS after packing (TTGT).
+/// \ingroup kernel_ops
+using ContractionBackend = NamedEnumeration<ContractionBackendTraits>;
+
+namespace detail
+{
+
+/// \brief Cache-blocked engine held by a ContractionPlan for scalar type \p T, if it has one.
+/// \ingroup internal
+template <typename T> struct plan_engine
+{
+    using type = std::monostate;
+};
+
+template <BlasScalar T> struct plan_engine<T>
+{
+    using type = std::optional<cpu::BlockedGemm<T>>;
+};
+
+} // namespace detail
+
+/// \brief A contraction analysed once and executable many times on operands with the same layout.
+/// \details The plan owns the offset tables of its backend. A plan is not copyable, and execute() may be called
+///          concurrently from several threads.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam MR Capacity of the M group.
+/// \tparam NR Capacity of the N group.
+/// \tparam KR Capacity of the K group.
+/// \ingroup kernel_ops
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class ContractionPlan {
+  public:
+    using m_group_type = static_vector<extent_strides<2>, MR>;
+    using n_group_type = static_vector<extent_strides<2>, NR>;
+    using k_group_type = static_vector<extent_strides<2>, KR>;
+
+    /// \brief Plan a contraction for the CPU backend.
+    /// \param Mgrp Merged M dimensions, strides ordered as {A, C}.
+    /// \param Ngrp Merged N dimensions, strides ordered as {B, C}.
+    /// \param Kgrp Merged K dimensions, strides ordered as {A, B}.
+    /// \param tag Backend selector tag.
+    ContractionPlan(m_group_type const& Mgrp, n_group_type const& Ngrp, k_group_type const& Kgrp, cpu_tag tag)
+        : Mgrp_(Mgrp), Ngrp_(Ngrp), Kgrp_(Kgrp)
+    {
+      static_cast<void>(tag);
+      this->select_cpu();
+    }
+
+#if UNI20_BACKEND_BLAS
+    /// \brief Plan a contraction for the BLAS backend, falling back to the CPU engines.
+    /// \param Mgrp Merged M dimensions, strides ordered as {A, C}.
+    /// \param Ngrp Merged N dimensions, strides ordered as {B, C}.
+    /// \param Kgrp Merged K dimensions, strides ordered as {A, B}.
+    /// \param tag Backend selector tag.
+    ContractionPlan(m_group_type const& Mgrp, n_group_type const& Ngrp, k_group_type const& Kgrp, blas_tag tag)
+    requires BlasScalar<T>
+        : Mgrp_(Mgrp), Ngrp_(Ngrp), Kgrp_(Kgrp)
+    {
+      static_cast<void>(tag);
+      if (auto plan = blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp); plan && blas::prefer_ttgt(*plan))
+      {
+        ttgt_ = *plan;
+        ttgt_offsets_ = blas::make_ttgt_offsets(*plan, Mgrp, Ngrp, Kgrp);
+        backend_ = plan->is_direct() ? ContractionBackend::Gemm : ContractionBackend::TTGT;
+        scratch_bytes_ = static_cast<std::size_t>(blas::ttgt_workspace_size(*plan)) * sizeof(T);
+        return;
+      }
+      this->select_cpu();
+    }
+#endif
+
+    /// \brief Backend selected for this contraction.
+    ContractionBackend backend() const noexcept { return backend_; }
+
+    /// \brief Bytes of scratch into which one execution packs its operands.
+    std::size_t scratch_bytes() const noexcept { return scratch_bytes_; }
+
+    /// \brief Merged M dimensions, outermost loop first.
+    m_group_type const& m_group() const noexcept { return Mgrp_; }
+
+    /// \brief Merged N dimensions, outermost loop first.
+    n_group_type const& n_group() const noexcept { return Ngrp_; }
+
+    /// \brief Merged K dimensions, outermost loop first.
+    k_group_type const& k_group() const noexcept { return Kgrp_; }
+
+    /// \brief Perform C = β·C + α·(A ⋅ B) with the planned backend.
+    /// \details Uses the offset tables built with the plan and scratch_bytes() of scratch owned by the calling
+    ///          thread, so it allocates nothing once that scratch has grown to size.
+    /// \param alpha Scaling factor applied to the contraction output.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+    /// \param C Pointer to the base of the destination tensor.
+    void execute(T alpha, T const* A, T const* B, T beta, T* C) const
+    {
+#if UNI20_BACKEND_BLAS
+      if constexpr (BlasScalar<T>)
+      {
+        if (ttgt_)
+        {
+          blas::run_ttgt_prepared(*ttgt_, ttgt_offsets_, alpha, A, B, beta, C, this->scratch());
+          return;
+        }
+      }
+#endif
+      if constexpr (BlasScalar<T>)
+      {
+        if (engine_)
+        {
+          engine_->run(alpha, A, B, beta, C, this->scratch());
+          return;
+        }
+      }
+      cpu::GemmLoop Loop(Mgrp_, Ngrp_, Kgrp_, alpha, beta);
+      Loop.run(A, B, C);
+    }
+
+  private:
+    m_group_type Mgrp_;
+    n_group_type Ngrp_;
+    k_group_type Kgrp_;
+    ContractionBackend backend_ = ContractionBackend::Loop;
+    std::size_t scratch_bytes_ = 0;
+    typename detail::plan_engine<T>::type engine_;
+#if UNI20_BACKEND_BLAS
+    std::optional<blas::ttgt_plan> ttgt_;
+    blas::ttgt_offsets ttgt_offsets_;
+#endif
+
+    /// \brief The calling thread's scratch, grown to scratch_bytes().
+    T* scratch() const { return reinterpret_cast<T*>(cpu::contraction_scratch(scratch_bytes_)); }
+
+    void select_cpu()
+    {
+      if constexpr (BlasScalar<T>)
+      {
+        index_type const m = cpu::group_extent(Mgrp_), n = cpu::group_extent(Ngrp_), k = cpu::group_extent(Kgrp_);
+        if (m * n * k >= cpu::blocked_gemm_min_volume)
+        {
+          backend_ = ContractionBackend::Blocked;
+          engine_.emplace(Mgrp_, Ngrp_, Kgrp_, T(1), T{});
+          scratch_bytes_ = static_cast<std::size_t>(engine_->workspace_size()) * sizeof(T);
+        }
+      }
+    }
+};
+
+/// \brief Build a contraction plan from operand layouts.
+/// \tparam AType Strided mdspan describing the left-hand tensor operand.
+/// \tparam BType Strided mdspan describing the right-hand tensor operand.
+/// \tparam N Number of contracted index pairs.
+/// \tparam CType Mutable strided mdspan describing the output tensor.
+/// \tparam TagType Backend selection tag.
+/// \param A Left-hand tensor operand (only its layout is used).
+/// \param B Right-hand tensor operand (only its layout is used).
+/// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+/// \param C Destination tensor (only its layout is used).
+/// \param tag Backend selector instance.
+/// \return The plan, executable on any operands with the same extents and strides.
+/// \ingroup kernel_ops
+template <StridedMdspan AType, StridedMdspan BType, std::size_t N, MutableStridedMdspan CType, typename TagType>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N)
+auto make_contraction_plan(AType const& A, BType const& B,
+                           std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, CType const& C,
+                           TagType tag)
+{
+  using T = std::remove_const_t<typename CType::element_type>;
+  auto [Mgroup, Ngroup, Kgroup] = extract_strides(A, B, contractDims, C);
+  return ContractionPlan<T, AType::rank() - N, BType::rank() - N, N>(Mgroup, Ngroup, Kgroup, tag);
+}
+
+namespace detail
+{
+
+/// \brief Flattened extents, strides and dimension pairs identifying a contraction layout.
+/// \ingroup internal
+template <std::size_t RA, std::size_t RB, std::size_t RC, std::size_t N>
+using contraction_key = std::array<std::ptrdiff_t, 2 * RA + 2 * RB + RC + 2 * N>;
+
+/// \brief Hash for contraction_key.
+/// \ingroup internal
+struct contraction_key_hash
+{
+    template <std::size_t L> std::size_t operator()(std::array<std::ptrdiff_t, L> const& key) const noexcept
+    {
+      std::size_t h = 14695981039346656037ull;
+      for (auto v : key)
+      {
+        h ^= static_cast<std::size_t>(v);
+        h *= 1099511628211ull;
+      }
+      return h;
+    }
+};
+
+/// \brief Build the cache key for a contraction.
+/// \ingroup internal
+template <StridedMdspan AType, StridedMdspan BType, std::size_t N, StridedMdspan CType>
+auto make_contraction_key(AType const& A, BType const& B,
+                          std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, CType const& C)
+{
+  contraction_key<AType::rank(), BType::rank(), CType::rank(), N> key;
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < AType::rank(); ++i)
+  {
+    key[n++] = A.extent(i);
+    key[n++] = A.stride(i);
+  }
+  for (std::size_t i = 0; i < BType::rank(); ++i)
+  {
+    key[n++] = B.extent(i);
+    key[n++] = B.stride(i);
+  }
+  for (std::size_t i = 0; i < CType::rank(); ++i)
+    key[n++] = C.stride(i);
+  for (auto [a, b] : contractDims)
+  {
+    key[n++] = static_cast<std::ptrdiff_t>(a);
+    key[n++] = static_cast<std::ptrdiff_t>(b);
+  }
+  return key;
+}
+
+} // namespace detail
+
+/// \brief Thread-safe least-recently-used cache mapping contraction layouts to plans.
+/// \tparam Key Layout key type.
+/// \tparam Plan Plan type.
+/// \tparam Hash Hash function for \p Key.
+/// \ingroup kernel_ops
+template <typename Key, typename Plan, typename Hash = detail::contraction_key_hash> class ContractionPlanCache {
+  public:
+    /// \brief Default number of plans retained per cache.
+    static constexpr std::size_t default_capacity = 256;
+
+    explicit ContractionPlanCache(std::size_t capacity = default_capacity) : capacity_(capacity) {}
+
+    /// \brief Look up a plan, building and inserting it with \p make on a miss.
+    /// \param key Layout key.
+    /// \param make Callable returning a Plan; invoked without holding the cache lock.
+    /// \return Shared ownership of the cached plan.
+    template <typename F> std::shared_ptr<Plan const> get_or_create(Key const& key, F&& make)
+    {
+      {
+        std::scoped_lock lock(mutex_);
+        if (auto it = index_.find(key); it != index_.end())
+        {
+          ++hits_;
+          entries_.splice(entries_.begin(), entries_, it->second);
+          return it->second->second;
+        }
+        ++misses_;
+      }
+
+      auto plan = std::make_shared<Plan const>(std::forward<F>(make)());
+
+      std::scoped_lock lock(mutex_);
+      if (auto it = index_.find(key); it != index_.end()) return it->second->second;
+      if (capacity_ == 0) return plan;
+      entries_.emplace_front(key, plan);
+      index_.emplace(key, entries_.begin());
+      while (entries_.size() > capacity_)
+      {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+      return plan;
+    }
+
+    /// \brief Change the maximum number of retained plans, evicting the least recently used as needed.
+    void set_capacity(std::size_t capacity)
+    {
+      std::scoped_lock lock(mutex_);
+      capacity_ = capacity;
+      while (entries_.size() > capacity_)
+      {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+    }
+
+    /// \brief Remove all cached plans and reset the statistics.
+    void clear()
+    {
+      std::scoped_lock lock(mutex_);
+      entries_.clear();
+      index_.clear();
+      hits_ = misses_ = 0;
+    }
+
+    /// \brief Number of cached plans.
+    std::size_t size() const
+    {
+      std::scoped_lock lock(mutex_);
+      return entries_.size();
+    }
+
+    /// \brief Number of lookups that found an existing plan.
+    std::size_t hits() const
+    {
+      std::scoped_lock lock(mutex_);
+      return hits_;
+    }
+
+    /// \brief Number of lookups that had to build a plan.
+    std::size_t misses() const
+    {
+      std::scoped_lock lock(mutex_);
+      return misses_;
+    }
+
+  private:
+    using entry_list = std::list<std::pair<Key, std::shared_ptr<Plan const>>>;
+
+    mutable std::mutex mutex_;
+    std::size_t capacity_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+    entry_list entries_;
+    std::unordered_map<Key, typename entry_list::iterator, Hash> index_;
+};
+
+/// \brief Process-wide plan cache for one combination of scalar type, operand ranks and backend tag.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam RA Rank of the left-hand operand.
+/// \tparam RB Rank of the right-hand operand.
+/// \tparam RC Rank of the output.
+/// \tparam N Number of contracted index pairs.
+/// \tparam TagType Backend selection tag.
+/// \return Reference to the cache instance.
+/// \ingroup kernel_ops
+template <typename T, std::size_t RA, std::size_t RB, std::size_t RC, std::size_t N, typename TagType>
+auto& contraction_plan_cache()
+{
+  using Cache = ContractionPlanCache<detail::contraction_key<RA, RB, RC, N>, ContractionPlan<T, RA - N, RB - N, N>>;
+  static Cache cache;
+  return cache;
+}
+
+template <typename T, StridedMdspan AType, StridedMdspan BType, std::size_t N, typename U, MutableStridedMdspan CType,
+          typename TagType>
+requires(AType::rank() + BType::rank() == CType::rank() + 2 * N)
+    /// \brief Contract through the process-wide plan cache.
+    /// \details Equivalent to contract(), but the layout analysis and backend selection are looked up in
+    ///          contraction_plan_cache() and only performed on the first call for a given layout.
+    /// \tparam T Scalar used for scaling the contraction inputs and output.
+    /// \tparam AType Strided mdspan describing the left-hand tensor operand.
+    /// \tparam BType Strided mdspan describing the right-hand tensor operand.
+    /// \tparam N Number of contracted index pairs.
+    /// \tparam U Scalar type used to scale the destination tensor.
+    /// \tparam CType Mutable strided mdspan describing the output tensor.
+    /// \tparam TagType Backend selection tag.
+    /// \param alpha Scaling factor for the contraction result.
+    /// \param A Left-hand tensor operand.
+    /// \param B Right-hand tensor operand.
+    /// \param contractDims Pairing of contracted dimensions between \p A and \p B.
+    /// \param beta Scaling factor applied to the pre-existing contents of \p C.
+    /// \param C Destination tensor.
+    /// \param tag Backend selector instance.
+    /// \ingroup kernel_ops
+    void contract_cached(T const& alpha, AType A, BType B,
+                         std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims, U const& beta,
+                         CType C, TagType tag)
+{
+  using value_type = std::remove_const_t<typename CType::element_type>;
+  auto& cache = contraction_plan_cache<value_type, AType::rank(), BType::rank(), CType::rank(), N, TagType>();
+  auto plan = cache.get_or_create(detail::make_contraction_key(A, B, contractDims, C),
+                                  [&] { return make_contraction_plan(A, B, contractDims, C, tag); });
+  plan->execute(alpha, A.data_handle(), B.data_handle(), beta, C.data_handle());
+}
+
+} // namespace uni20::kernel
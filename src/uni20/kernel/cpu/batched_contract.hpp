@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * \file batched_contract.hpp
+ * \ingroup kernel_cpu
+ * \brief Batched tensor contraction: independent contractions over legs shared by A, B and C.
+ * \details The contraction engine is set up once from the M/N/K groups and then applied at the offsets of each
+ *          batch index. In parallel mode, batches are distributed over the arena when there are enough of them
+ *          to occupy it; otherwise the batches run in turn and each contraction is itself parallelised.
+ */
+
+#include "blocked_gemm.hpp"
+#include "contract.hpp"
+#include "parallel_contract.hpp"
+
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+namespace uni20::kernel
+{
+
+namespace cpu
+{
+
+/// \brief Invoke \p f(a, b, c) with the A, B and C offsets of every batch index.
+/// \details When \p parallel is set the batches are distributed over \p arena; \p f must then be safe to call
+///          concurrently for distinct batches.
+/// \tparam BR Capacity of the batch group.
+/// \tparam F Callable taking three `std::ptrdiff_t` offsets.
+/// \param Bgrp Fused batch dimensions, strides ordered as {A, B, C}.
+/// \param parallel Whether batches may run concurrently.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \param f Callable applied to each batch.
+/// \ingroup internal
+template <std::size_t BR, typename F>
+void for_each_batch(static_vector<extent_strides<3>, BR> const& Bgrp, bool parallel, oneapi::tbb::task_arena* arena,
+                    F&& f)
+{
+  index_type const batches = group_extent(Bgrp);
+  if (batches == 0) return;
+  auto offA = make_group_offsets<0>(Bgrp);
+  auto offB = make_group_offsets<1>(Bgrp);
+  auto offC = make_group_offsets<2>(Bgrp);
+  if (!parallel || batches == 1)
+  {
+    for (index_type b = 0; b < batches; ++b)
+      f(offA[b], offB[b], offC[b]);
+    return;
+  }
+  execute_in(arena, [&] {
+    oneapi::tbb::parallel_for(index_type(0), batches, [&](index_type b) { f(offA[b], offB[b], offC[b]); });
+  });
+}
+
+/// \brief Decide whether a batched contraction should distribute whole batches over the arena.
+/// \details Batches are distributed when the total work is large enough to parallelise and there are at least
+///          as many batches as threads; otherwise each contraction is parallelised internally.
+/// \param batches Number of batch indices.
+/// \param volume m·n·k volume of a single contraction.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \return True if batches should run concurrently.
+/// \ingroup internal
+inline bool parallel_over_batches(index_type batches, index_type volume, oneapi::tbb::task_arena* arena)
+{
+  int const concurrency = arena ? arena->max_concurrency() : oneapi::tbb::this_task_arena::max_concurrency();
+  if (concurrency <= 1 || batches * volume < contract_parallel_min_volume) return false;
+  return batches >= index_type(concurrency) || volume < contract_parallel_min_volume;
+}
+
+} // namespace cpu
+
+template <typename T, std::size_t BR, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute a batched tensor contraction with the CPU backend.
+/// \details For every batch index, C_b = β·C_b + α·(A_b ⋅ B_b), where the batch offsets come from \p Bgrp.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam BR Number of fused batch dimensions.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Bgrp Metadata describing extents and strides {A, B, C} for the fused batch dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \ingroup kernel_cpu
+void contract_strided_batched(static_vector<extent_strides<3>, BR> const& Bgrp,
+                              static_vector<extent_strides<2>, MR> const& Mgrp,
+                              static_vector<extent_strides<2>, NR> const& Ngrp,
+                              static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B,
+                              T beta, T* C, cpu_tag tag)
+{
+  static_cast<void>(tag);
+  if constexpr (BlasScalar<T>)
+  {
+    if (cpu::group_extent(Mgrp) * cpu::group_extent(Ngrp) * cpu::group_extent(Kgrp) >= cpu::blocked_gemm_min_volume)
+    {
+      cpu::BlockedGemm<T> Engine(Mgrp, Ngrp, Kgrp, alpha, beta);
+      cpu::for_each_batch(Bgrp, false, nullptr, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+        Engine.run(A + a, B + b, C + c);
+      });
+      return;
+    }
+  }
+  cpu::GemmLoop Loop(Mgrp, Ngrp, Kgrp, alpha, beta);
+  cpu::for_each_batch(Bgrp, false, nullptr,
+                      [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) { Loop.run(A + a, B + b, C + c); });
+}
+
+template <typename T, std::size_t BR, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute a batched tensor contraction with the CPU backend on multiple threads.
+/// \details Whole batches run concurrently when cpu::parallel_over_batches() allows it; otherwise each batch
+///          is contracted in turn through contract_strided_parallel().
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam BR Number of fused batch dimensions.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Bgrp Metadata describing extents and strides {A, B, C} for the fused batch dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup kernel_cpu
+void contract_strided_batched_parallel(static_vector<extent_strides<3>, BR> const& Bgrp,
+                                       static_vector<extent_strides<2>, MR> const& Mgrp,
+                                       static_vector<extent_strides<2>, NR> const& Ngrp,
+                                       static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A,
+                                       T const* B, T beta, T* C, cpu_tag tag, oneapi::tbb::task_arena* arena)
+{
+  index_type const volume = cpu::group_extent(Mgrp) * cpu::group_extent(Ngrp) * cpu::group_extent(Kgrp);
+  if (cpu::parallel_over_batches(cpu::group_extent(Bgrp), volume, arena))
+  {
+    if constexpr (BlasScalar<T>)
+    {
+      if (volume >= cpu::blocked_gemm_min_volume)
+      {
+        cpu::BlockedGemm<T> Engine(Mgrp, Ngrp, Kgrp, alpha, beta);
+        cpu::for_each_batch(Bgrp, true, arena, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+          Engine.run(A + a, B + b, C + c);
+        });
+        return;
+      }
+    }
+    cpu::GemmLoop const Loop(Mgrp, Ngrp, Kgrp, alpha, beta);
+    cpu::for_each_batch(Bgrp, true, arena,
+                        [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) { Loop.run(A + a, B + b, C + c); });
+    return;
+  }
+  cpu::for_each_batch(Bgrp, false, nullptr, [&](std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c) {
+    contract_strided_parallel(Mgrp, Ngrp, Kgrp, alpha, A + a, B + b, beta, C + c, tag, arena);
+  });
+}
+
+} // namespace uni20::kernel
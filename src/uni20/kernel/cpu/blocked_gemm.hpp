@@ -0,0 +1,586 @@
+#pragma once
+
+/**
+ * \file blocked_gemm.hpp
+ * \ingroup kernel_cpu
+ * \brief Cache-blocked, packed contraction engine with an MR×NR register micro-kernel.
+ * \details The fused M, N and K groups are flattened through per-operand offset tables, so any strided
+ *          layout is accepted. Panels of A and B are packed into contiguous, zero-padded micro-panels in the
+ *          usual Goto/BLIS order (jc → pc → ic → jr → ir), and each MR×NR tile of C is accumulated in
+ *          registers before a single β·C + α·acc update. An epilogue's diagonal scaling is folded into the
+ *          packing of A and B, and its functor is applied when a tile is stored for the last time.
+ */
+
+#include <uni20/common/aligned_buffer.hpp>
+#include <uni20/common/static_vector.hpp>
+#include <uni20/core/scalar_concepts.hpp>
+#include <uni20/core/types.hpp>
+#include "cpu.hpp"
+#include <uni20/kernel/contract_epilogue.hpp>
+#include <uni20/mdspan/strides.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace uni20::kernel
+{
+
+namespace cpu
+{
+
+/// \brief Scratch of at least \p bytes, 64-byte aligned, owned by the calling thread and reused by every
+///        contraction executed on it (a ContractionPlan, or a batch of a batched contraction). It grows as needed
+///        and is never shrunk, so it must not be held across a call that may run other contractions on the
+///        same thread.
+/// \ingroup internal
+inline std::byte* contraction_scratch(std::size_t bytes)
+{
+  thread_local uni20::detail::aligned_buf_t<std::byte> buffer;
+  thread_local std::size_t capacity = 0;
+  if (bytes > capacity)
+  {
+    buffer = allocate_uninitialized_buffer<std::byte>(bytes);
+    capacity = bytes;
+  }
+  return buffer.get();
+}
+
+/// \brief Total number of elements spanned by a stride group.
+/// \tparam S Number of operands sharing the group.
+/// \tparam R Capacity of the stride group.
+/// \param grp Merged group as produced by extract_strides.
+/// \return Product of the extents (1 for an empty group).
+/// \ingroup internal
+template <std::size_t S, std::size_t R>
+index_type group_extent(static_vector<extent_strides<S>, R> const& grp) noexcept
+{
+  index_type n = 1;
+  for (auto const& d : grp)
+    n *= d.extent;
+  return n;
+}
+
+/// \brief Element offsets of operand \p J for every index of a stride group, in row-major group order.
+/// \tparam J Operand index within the group strides.
+/// \tparam S Number of operands sharing the group.
+/// \tparam R Capacity of the stride group.
+/// \param grp Merged group as produced by extract_strides.
+/// \param out Destination array holding group_extent(grp) offsets.
+/// \ingroup internal
+template <std::size_t J, std::size_t S, std::size_t R>
+requires(J < S)
+void group_offsets(static_vector<extent_strides<S>, R> const& grp, std::ptrdiff_t* out) noexcept
+{
+  out[0] = 0;
+  index_type count = 1;
+  for (auto const& d : grp)
+  {
+    // expand in place from the back, so each source entry is read before it is overwritten
+    for (index_type i = count; i-- > 0;)
+    {
+      std::ptrdiff_t const base = out[i];
+      for (index_type e = d.extent; e-- > 0;)
+        out[i * d.extent + e] = base + e * d.strides[J];
+    }
+    count *= d.extent;
+  }
+}
+
+/// \brief Allocate and fill the offset table of operand \p J for a stride group.
+/// \tparam J Operand index within the group strides.
+/// \tparam S Number of operands sharing the group.
+/// \tparam R Capacity of the stride group.
+/// \param grp Merged group as produced by extract_strides.
+/// \return Buffer holding group_extent(grp) offsets.
+/// \ingroup internal
+template <std::size_t J, std::size_t S, std::size_t R>
+auto make_group_offsets(static_vector<extent_strides<S>, R> const& grp)
+{
+  auto buf = allocate_uninitialized_buffer<std::ptrdiff_t>(std::max<index_type>(1, group_extent(grp)));
+  group_offsets<J>(grp, buf.get());
+  return buf;
+}
+
+/// \brief Register-tile and cache-block sizes for the blocked contraction engine.
+/// \details MR×NR accumulators are held in registers; a KC×NR micro-panel of B is sized for L1 and an
+///          MC×KC panel of A for L2. NC bounds the packed B panel so it stays resident in the outer cache.
+/// \tparam T Scalar type of the contraction.
+/// \ingroup kernel_cpu
+template <typename T> struct blocked_gemm_traits;
+
+template <> struct blocked_gemm_traits<float>
+{
+    static constexpr index_type mr = 8, nr = 8, kc = 384, mc = 192, nc = 4096;
+};
+
+template <> struct blocked_gemm_traits<double>
+{
+    static constexpr index_type mr = 4, nr = 8, kc = 256, mc = 128, nc = 4096;
+};
+
+template <> struct blocked_gemm_traits<cfloat>
+{
+    static constexpr index_type mr = 4, nr = 4, kc = 256, mc = 128, nc = 2048;
+};
+
+template <> struct blocked_gemm_traits<cdouble>
+{
+    static constexpr index_type mr = 2, nr = 4, kc = 192, mc = 96, nc = 2048;
+};
+
+/// \brief Minimum m·n·k volume for which packing into the blocked engine pays off.
+/// \ingroup kernel_cpu
+inline constexpr index_type blocked_gemm_min_volume = 4096;
+
+/// \brief MR×NR micro-kernel computing acc = Σₚ Ap[p]·Bp[p]ᵀ over packed micro-panels.
+/// \details Complex products are expanded into real arithmetic so the compiler can vectorise the update
+///          without the NaN/Inf recovery path of `std::complex` multiplication.
+/// \tparam T Scalar type of the contraction.
+/// \param kc Depth of the packed panels.
+/// \param Ap Packed A micro-panel, MR elements per k step.
+/// \param Bp Packed B micro-panel, NR elements per k step.
+/// \param acc Output accumulator tile in row-major MR×NR order.
+/// \ingroup internal
+template <BlasScalar T>
+inline void micro_kernel(index_type kc, T const* __restrict Ap, T const* __restrict Bp,
+                         T* __restrict acc) noexcept
+{
+  constexpr index_type MR = blocked_gemm_traits<T>::mr;
+  constexpr index_type NR = blocked_gemm_traits<T>::nr;
+  if constexpr (BlasReal<T>)
+  {
+    T c[MR][NR] = {};
+    for (index_type p = 0; p < kc; ++p)
+    {
+      T const* a = Ap + p * MR;
+      T const* b = Bp + p * NR;
+      for (index_type i = 0; i < MR; ++i)
+        for (index_type j = 0; j < NR; ++j)
+          c[i][j] += a[i] * b[j];
+    }
+    for (index_type i = 0; i < MR; ++i)
+      for (index_type j = 0; j < NR; ++j)
+        acc[i * NR + j] = c[i][j];
+  }
+  else
+  {
+    using R = typename T::value_type;
+    R cr[MR][NR] = {}, ci[MR][NR] = {};
+    for (index_type p = 0; p < kc; ++p)
+    {
+      R const* a = reinterpret_cast<R const*>(Ap + p * MR);
+      R const* b = reinterpret_cast<R const*>(Bp + p * NR);
+      for (index_type i = 0; i < MR; ++i)
+        for (index_type j = 0; j < NR; ++j)
+        {
+          cr[i][j] += a[2 * i] * b[2 * j] - a[2 * i + 1] * b[2 * j + 1];
+          ci[i][j] += a[2 * i] * b[2 * j + 1] + a[2 * i + 1] * b[2 * j];
+        }
+    }
+    for (index_type i = 0; i < MR; ++i)
+      for (index_type j = 0; j < NR; ++j)
+        acc[i * NR + j] = T(cr[i][j], ci[i][j]);
+  }
+}
+
+/// \brief Cache-blocked contraction engine over arbitrary strided M×N×K groups.
+/// \details Operands are converted to \p Acc (and conjugated if requested) while they are packed, so neither
+///          costs anything in the micro-kernel. When \p Acc differs from \p T, each block is accumulated over
+///          the whole contracted range in an \p Acc scratch tile before it is rounded into C once.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam Acc Scalar type in which products are accumulated.
+/// \ingroup kernel_cpu
+template <BlasScalar T, BlasScalar Acc = T> class BlockedGemm {
+  public:
+    using traits = blocked_gemm_traits<Acc>;
+
+    /// \brief Build the engine for a fused contraction.
+    /// \tparam MR Number of fused M dimensions.
+    /// \tparam NR Number of fused N dimensions.
+    /// \tparam KR Number of fused K dimensions.
+    /// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+    /// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+    /// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+    /// \param alpha Scaling factor applied to the contraction output.
+    /// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+    /// \param conj_a Contract with the complex conjugate of A (ignored for real scalars).
+    /// \param conj_b Contract with the complex conjugate of B (ignored for real scalars).
+    template <std::size_t MR, std::size_t NR, std::size_t KR>
+    BlockedGemm(static_vector<extent_strides<2>, MR> const& Mgrp, static_vector<extent_strides<2>, NR> const& Ngrp,
+                static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T beta, bool conj_a = false,
+                bool conj_b = false)
+        : m_(group_extent(Mgrp)), n_(group_extent(Ngrp)), k_(group_extent(Kgrp)), alpha_(alpha), beta_(beta),
+          conj_a_(BlasComplex<T> && conj_a), conj_b_(BlasComplex<T> && conj_b), offMA_(make_group_offsets<0>(Mgrp)),
+          offMC_(make_group_offsets<1>(Mgrp)), offNB_(make_group_offsets<0>(Ngrp)),
+          offNC_(make_group_offsets<1>(Ngrp)), offKA_(make_group_offsets<0>(Kgrp)),
+          offKB_(make_group_offsets<1>(Kgrp))
+    {}
+
+    /// \brief Destination of a block computation: base pointer plus row (M) and column (N) offset tables.
+    struct output_view
+    {
+        T* data;
+        std::ptrdiff_t const* row_offsets;
+        std::ptrdiff_t const* col_offsets;
+    };
+
+    /// \brief Flattened extent of the fused M dimensions.
+    index_type m() const noexcept { return m_; }
+
+    /// \brief Flattened extent of the fused N dimensions.
+    index_type n() const noexcept { return n_; }
+
+    /// \brief Flattened extent of the fused K dimensions.
+    index_type k() const noexcept { return k_; }
+
+    /// \brief The destination tensor C addressed through its own strides.
+    /// \param C Pointer to the base of the destination tensor.
+    output_view output(T* C) const noexcept { return {C, offMC_.get(), offNC_.get()}; }
+
+    /// \brief Perform C = β·C + α·(A ⋅ B) over all fused M, N, and K dimensions.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param C Pointer to the base of the destination tensor.
+    void run(T const* A, T const* B, T* C) const { this->run_block(A, B, this->output(C), 0, m_, 0, n_, 0, k_, beta_); }
+
+    /// \brief Perform C = β·C + α·(A ⋅ B) with scaling factors given per call and the packed panels in
+    ///        caller-provided scratch, so that one engine can be kept and rerun without allocating.
+    /// \param alpha Scaling factor applied to the contraction output.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param beta Scaling factor applied to the pre-existing contents of C, which are not read if it is zero.
+    /// \param C Pointer to the base of the destination tensor.
+    /// \param workspace Scratch of at least workspace_size() elements.
+    void run(T alpha, T const* A, T const* B, T beta, T* C, Acc* workspace) const
+    {
+      this->run_range(A, B, this->output(C), 0, m_, 0, n_, 0, k_, alpha, beta, flat_epilogue<T>{}, workspace);
+    }
+
+    /// \brief Number of \p Acc elements of scratch used by one run() over the whole index space: the packed panels
+    ///        of A and B, and, when \p Acc differs from \p T, the accumulator tile with its offset tables.
+    index_type workspace_size() const noexcept
+    {
+      if (m_ == 0 || n_ == 0 || k_ == 0) return 0;
+      return scratch_size(0, m_, 0, n_, 0, k_);
+    }
+
+    /// \brief Perform C = f(β·C + α·(A ⋅ B)·D) with the scaling D and functor f of an epilogue.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param C Pointer to the base of the destination tensor.
+    /// \param ep Epilogue indexed by the flattened M and N indices of this engine.
+    template <typename F> void run(T const* A, T const* B, T* C, flat_epilogue<T, F> const& ep) const
+    {
+      this->run_block(A, B, this->output(C), 0, m_, 0, n_, 0, k_, beta_, ep);
+    }
+
+    /// \brief Compute out = β·out + α·(A ⋅ B) restricted to a block of the flattened index space.
+    /// \details Distinct [i0, i1) × [j0, j1) blocks touch disjoint elements of the output, so they may run
+    ///          concurrently. Restricting [p0, p1) yields a partial sum over part of the contracted extent.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param out Destination of the block.
+    /// \param i0 First flattened M index.
+    /// \param i1 One past the last flattened M index.
+    /// \param j0 First flattened N index.
+    /// \param j1 One past the last flattened N index.
+    /// \param p0 First flattened K index.
+    /// \param p1 One past the last flattened K index.
+    /// \param beta Scaling factor applied to the pre-existing contents of the block, which are not read if it is zero.
+    void run_block(T const* A, T const* B, output_view out, index_type i0, index_type i1, index_type j0,
+                   index_type j1, index_type p0, index_type p1, T beta) const
+    {
+      this->run_block(A, B, out, i0, i1, j0, j1, p0, p1, beta, flat_epilogue<T>{});
+    }
+
+    /// \brief Compute out = f(β·out + α·(A ⋅ B)·D) restricted to a block of the flattened index space.
+    /// \details As run_block() above, with the scaling D and functor f of an epilogue. The functor is applied to
+    ///          the final value, so \p p0 and \p p1 must span the whole contracted extent unless it is the
+    ///          identity.
+    /// \param A Pointer to the base of the left-hand operand.
+    /// \param B Pointer to the base of the right-hand operand.
+    /// \param out Destination of the block.
+    /// \param i0 First flattened M index.
+    /// \param i1 One past the last flattened M index.
+    /// \param j0 First flattened N index.
+    /// \param j1 One past the last flattened N index.
+    /// \param p0 First flattened K index.
+    /// \param p1 One past the last flattened K index.
+    /// \param beta Scaling factor applied to the pre-existing contents of the block, which are not read if it is zero.
+    /// \param ep Epilogue indexed by the flattened M and N indices of this engine.
+    template <typename F>
+    void run_block(T const* A, T const* B, output_view out, index_type i0, index_type i1, index_type j0,
+                   index_type j1, index_type p0, index_type p1, T beta, flat_epilogue<T, F> const& ep) const
+    {
+      this->run_range(A, B, out, i0, i1, j0, j1, p0, p1, alpha_, beta, ep, nullptr);
+    }
+
+  private:
+    index_type m_, n_, k_;
+    T alpha_, beta_;
+    bool conj_a_, conj_b_;
+    detail::aligned_buf_t<std::ptrdiff_t> offMA_, offMC_, offNB_, offNC_, offKA_, offKB_;
+
+    static constexpr index_type round_up(index_type x, index_type r) noexcept { return (x + r - 1) / r * r; }
+
+    /// \brief Number of \p Acc elements in the packed A and B panels of blocked_loop() over a block.
+    /// \ingroup internal
+    static constexpr index_type panel_size(index_type i0, index_type i1, index_type j0, index_type j1, index_type p0,
+                                           index_type p1) noexcept
+    {
+      index_type const kc_max = std::min(traits::kc, p1 - p0);
+      index_type const mc_max = std::min(traits::mc, round_up(i1 - i0, traits::mr));
+      index_type const nc_max = std::min(traits::nc, round_up(j1 - j0, traits::nr));
+      return mc_max * kc_max + kc_max * nc_max;
+    }
+
+    /// \brief Offset, in \p Acc elements, of the row and column offset tables of the accumulator tile, which
+    ///        follow the \p panels elements of packed panels and the \p tile elements of the tile itself.
+    /// \ingroup internal
+    static constexpr index_type acc_offsets_start(index_type panels, index_type tile) noexcept
+    {
+      // the tables are std::ptrdiff_t, so they start on a std::ptrdiff_t boundary
+      constexpr index_type step = std::max<index_type>(1, index_type(alignof(std::ptrdiff_t) / sizeof(Acc)));
+      return round_up(panels + tile, step);
+    }
+
+    /// \brief Number of \p Acc elements of scratch used by run_range() over a block: the packed panels and, when
+    ///        \p Acc differs from \p T, the accumulator tile followed by its row and column offset tables.
+    /// \ingroup internal
+    static constexpr index_type scratch_size(index_type i0, index_type i1, index_type j0, index_type j1, index_type p0,
+                                             index_type p1) noexcept
+    {
+      index_type const panels = panel_size(i0, i1, j0, j1, p0, p1);
+      if constexpr (std::is_same_v<Acc, T>)
+        return panels;
+      else
+      {
+        index_type const mb = i1 - i0, nb = j1 - j0;
+        index_type const table_bytes = (mb + nb) * index_type(sizeof(std::ptrdiff_t));
+        return acc_offsets_start(panels, mb * nb) + round_up(table_bytes, index_type(sizeof(Acc))) / index_type(sizeof(Acc));
+      }
+    }
+
+    /// \brief run_block() with the scaling factor α given explicitly and optional scratch.
+    /// \details \p workspace holds the scratch_size() elements of the packed panels followed, when \p Acc
+    ///          differs from \p T, by the accumulator tile and its offset tables; if it is null, the scratch is
+    ///          allocated for this call.
+    /// \ingroup internal
+    template <typename F>
+    void run_range(T const* A, T const* B, output_view out, index_type i0, index_type i1, index_type j0,
+                   index_type j1, index_type p0, index_type p1, T alpha, T beta, flat_epilogue<T, F> const& ep,
+                   Acc* workspace) const
+    {
+      if (i0 >= i1 || j0 >= j1) return;
+      if (p0 >= p1)
+      {
+        for (index_type j = j0; j < j1; ++j)
+          for (index_type i = i0; i < i1; ++i)
+          {
+            T& c = out.data[out.row_offsets[i] + out.col_offsets[j]];
+            c = ep.op(beta == T{} ? T{} : beta * c);
+          }
+        return;
+      }
+
+      if constexpr (std::is_same_v<Acc, T>)
+      {
+        this->blocked_loop(A, B, out.data, out.row_offsets, 0, out.col_offsets, 0, i0, i1, j0, j1, p0, p1, beta,
+                           alpha, ep.row_scale, ep.col_scale, ep.op, workspace);
+      }
+      else
+      {
+        // accumulate the whole K range of the block in Acc, then round into the output once
+        index_type const mb = i1 - i0, nb = j1 - j0;
+        detail::aligned_buf_t<Acc> acc_buf;
+        if (!workspace)
+        {
+          acc_buf = allocate_uninitialized_buffer<Acc>(scratch_size(i0, i1, j0, j1, p0, p1));
+          workspace = acc_buf.get();
+        }
+        index_type const panels = panel_size(i0, i1, j0, j1, p0, p1);
+        Acc* acc = workspace + panels;
+        auto* rows = reinterpret_cast<std::ptrdiff_t*>(workspace + acc_offsets_start(panels, mb * nb));
+        std::ptrdiff_t* cols = rows + mb;
+        std::fill_n(acc, mb * nb, Acc{});
+        for (index_type i = 0; i < mb; ++i)
+          rows[i] = i;
+        for (index_type j = 0; j < nb; ++j)
+          cols[j] = j * mb;
+        this->blocked_loop(A, B, acc, rows, i0, cols, j0, i0, i1, j0, j1, p0, p1, Acc{}, Acc(alpha), ep.row_scale,
+                           ep.col_scale, identity_epilogue{}, workspace);
+        for (index_type j = j0; j < j1; ++j)
+          for (index_type i = i0; i < i1; ++i)
+          {
+            T& c = out.data[out.row_offsets[i] + out.col_offsets[j]];
+            Acc const sum = acc[(i - i0) + (j - j0) * mb];
+            c = ep.op(static_cast<T>(beta == T{} ? sum : (Acc(beta) * Acc(c)) + sum));
+          }
+      }
+    }
+
+    /// \brief Packed GotoBLAS loop nest: out = β·out + α·(A ⋅ B) over a block, with β applied at the first kc
+    ///        panel only. Row i and column j of the block are addressed as rows[i - row0] and cols[j - col0].
+    ///        A and B are scaled by \p row_scale and \p col_scale (if not null) while packing, and \p op is
+    ///        applied when the last kc panel is stored. The panels are packed into the first panel_size()
+    ///        elements of \p workspace, or into scratch allocated here if it is null.
+    /// \ingroup internal
+    template <typename Op>
+    void blocked_loop(T const* A, T const* B, Acc* data, std::ptrdiff_t const* rows, index_type row0,
+                      std::ptrdiff_t const* cols, index_type col0, index_type i0, index_type i1, index_type j0,
+                      index_type j1, index_type p0, index_type p1, Acc beta, Acc alpha, T const* row_scale,
+                      T const* col_scale, Op const& op, Acc* workspace) const
+    {
+      constexpr index_type MR = traits::mr, NR = traits::nr;
+      detail::aligned_buf_t<Acc> panels;
+      if (!workspace)
+      {
+        panels = allocate_uninitialized_buffer<Acc>(panel_size(i0, i1, j0, j1, p0, p1));
+        workspace = panels.get();
+      }
+      Acc* const Apack = workspace;
+      Acc* const Bpack = workspace + std::min(traits::mc, round_up(i1 - i0, MR)) * std::min(traits::kc, p1 - p0);
+
+      for (index_type jc = j0; jc < j1; jc += traits::nc)
+      {
+        index_type const nc = std::min(traits::nc, j1 - jc);
+        for (index_type pc = p0; pc < p1; pc += traits::kc)
+        {
+          index_type const kc = std::min(traits::kc, p1 - pc);
+          Acc const beta_block = pc == p0 ? beta : Acc(1);
+          bool const last = pc + kc >= p1;
+          this->pack_B(B, jc, nc, pc, kc, col_scale, Bpack);
+          for (index_type ic = i0; ic < i1; ic += traits::mc)
+          {
+            index_type const mc = std::min(traits::mc, i1 - ic);
+            this->pack_A(A, ic, mc, pc, kc, row_scale, Apack);
+            for (index_type jr = 0; jr < nc; jr += NR)
+            {
+              for (index_type ir = 0; ir < mc; ir += MR)
+              {
+                Acc acc[MR * NR];
+                micro_kernel<Acc>(kc, Apack + ir * kc, Bpack + jr * kc, acc);
+                index_type const tile_rows = std::min(MR, mc - ir), tile_cols = std::min(NR, nc - jr);
+                std::ptrdiff_t const* tile_row_offsets = rows + (ic + ir - row0);
+                std::ptrdiff_t const* tile_col_offsets = cols + (jc + jr - col0);
+                if (last)
+                  this->store(acc, tile_rows, tile_cols, data, tile_row_offsets, tile_col_offsets, beta_block, alpha,
+                              op);
+                else
+                  this->store(acc, tile_rows, tile_cols, data, tile_row_offsets, tile_col_offsets, beta_block, alpha,
+                              identity_epilogue{});
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /// \brief Load an element for packing, converting to the accumulator type and conjugating if requested.
+    /// \ingroup internal
+    static Acc load(T const& x, bool conj) noexcept
+    {
+      if constexpr (BlasComplex<T>)
+      {
+        if (conj) return Acc(std::conj(x));
+      }
+      return Acc(x);
+    }
+
+    /// \brief Pack rows [ic, ic+mc) × depth [pc, pc+kc) of A into zero-padded MR-row micro-panels, multiplying
+    ///        row i by scale[i] if \p scale is not null.
+    /// \ingroup internal
+    void pack_A(T const* A, index_type ic, index_type mc, index_type pc, index_type kc, T const* scale,
+                Acc* out) const noexcept
+    {
+      constexpr index_type MR = traits::mr;
+      for (index_type ir = 0; ir < mc; ir += MR)
+      {
+        index_type const rows = std::min(MR, mc - ir);
+        std::ptrdiff_t const* offM = offMA_.get() + ic + ir;
+        for (index_type p = 0; p < kc; ++p)
+        {
+          T const* a = A + offKA_[pc + p];
+          index_type i = 0;
+          if (scale)
+          {
+            for (; i < rows; ++i)
+              out[i] = load(a[offM[i]], conj_a_) * Acc(scale[ic + ir + i]);
+          }
+          else
+          {
+            for (; i < rows; ++i)
+              out[i] = load(a[offM[i]], conj_a_);
+          }
+          for (; i < MR; ++i)
+            out[i] = Acc{};
+          out += MR;
+        }
+      }
+    }
+
+    /// \brief Pack depth [pc, pc+kc) × columns [jc, jc+nc) of B into zero-padded NR-column micro-panels,
+    ///        multiplying column j by scale[j] if \p scale is not null.
+    /// \ingroup internal
+    void pack_B(T const* B, index_type jc, index_type nc, index_type pc, index_type kc, T const* scale,
+                Acc* out) const noexcept
+    {
+      constexpr index_type NR = traits::nr;
+      for (index_type jr = 0; jr < nc; jr += NR)
+      {
+        index_type const cols = std::min(NR, nc - jr);
+        std::ptrdiff_t const* offN = offNB_.get() + jc + jr;
+        for (index_type p = 0; p < kc; ++p)
+        {
+          T const* b = B + offKB_[pc + p];
+          index_type j = 0;
+          if (scale)
+          {
+            for (; j < cols; ++j)
+              out[j] = load(b[offN[j]], conj_b_) * Acc(scale[jc + jr + j]);
+          }
+          else
+          {
+            for (; j < cols; ++j)
+              out[j] = load(b[offN[j]], conj_b_);
+          }
+          for (; j < NR; ++j)
+            out[j] = Acc{};
+          out += NR;
+        }
+      }
+    }
+
+    /// \brief Write the valid rows×cols corner of an accumulator tile into the output, passing each element
+    ///        through \p op. The output is not read if \p beta is zero.
+    /// \ingroup internal
+    template <typename Op>
+    static void store(Acc const* acc, index_type rows, index_type cols, Acc* data, std::ptrdiff_t const* row_offsets,
+                      std::ptrdiff_t const* col_offsets, Acc beta, Acc alpha, Op const& op)
+    {
+      constexpr index_type NR = traits::nr;
+      if (beta == Acc{})
+      {
+        for (index_type i = 0; i < rows; ++i)
+        {
+          Acc* c_row = data + row_offsets[i];
+          for (index_type j = 0; j < cols; ++j)
+            c_row[col_offsets[j]] = op(alpha * acc[i * NR + j]);
+        }
+        return;
+      }
+      for (index_type i = 0; i < rows; ++i)
+      {
+        Acc* c_row = data + row_offsets[i];
+        for (index_type j = 0; j < cols; ++j)
+        {
+          Acc& c = c_row[col_offsets[j]];
+          c = op((beta * c) + (alpha * acc[i * NR + j]));
+        }
+      }
+    }
+};
+
+} // namespace cpu
+
+} // namespace uni20::kernel
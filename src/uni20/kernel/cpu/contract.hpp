@@ -1,7 +1,11 @@
 #pragma once
 
 #include <uni20/common/mdspan.hpp>
+#include "blocked_gemm.hpp"
 #include "cpu.hpp"
+#include <uni20/core/math.hpp>
+#include <uni20/kernel/contract_epilogue.hpp>
+#include <uni20/kernel/contract_options.hpp>
 #include <uni20/mdspan/strides.hpp>
 
 namespace uni20::kernel
@@ -17,8 +21,9 @@ namespace cpu
 /// \tparam MR Number of fused M dimensions.
 /// \tparam NR Number of fused N dimensions.
 /// \tparam KR Number of fused K dimensions.
+/// \tparam Acc Type in which the dot products are accumulated.
 /// \ingroup kernel_cpu
-template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class GemmLoop {
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR, typename Acc = T> class GemmLoop {
   public:
     /// \brief Build the loop engine for a fused contraction.
     /// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
@@ -26,10 +31,15 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
     /// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
     /// \param alpha Scaling factor applied to the contraction output.
     /// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+    /// \param conj_a Contract with the complex conjugate of A (ignored for real scalars).
+    /// \param conj_b Contract with the complex conjugate of B (ignored for real scalars).
     /// \ingroup kernel_cpu
     GemmLoop(static_vector<extent_strides<2>, MR> const& Mgrp, static_vector<extent_strides<2>, NR> const& Ngrp,
-             static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T beta) noexcept
-        : Mgrp_(Mgrp), Ngrp_(Ngrp), Kgrp_(Kgrp), alpha_(alpha), beta_(beta)
+             static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T beta, bool conj_a = false,
+             bool conj_b = false) noexcept
+        : Mgrp_(Mgrp), Ngrp_(Ngrp), Kgrp_(Kgrp), alpha_(alpha), beta_(beta),
+          // Σ a·conj(b) = conj(Σ conj(a)·b), so only the conj(A) product is needed in the inner loop
+          conj_products_(Complex<T> && conj_a != conj_b), conj_result_(Complex<T> && conj_b)
     {}
 
     /// \brief Perform C = β·C + α·(A ⋅ B) over all fused M, N, and K dimensions.
@@ -37,25 +47,43 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
     /// \param B0 Pointer to the base of the right-hand operand.
     /// \param C0 Pointer to the base of the destination tensor.
     /// \ingroup kernel_cpu
-    void run(T const* A0, T const* B0, T* C0) noexcept { this->loopM(0, A0, B0, C0); }
+    void run(T const* A0, T const* B0, T* C0) const noexcept { this->loopM(0, 0, A0, B0, C0, no_epilogue); }
+
+    /// \brief Perform C = f(β·C + α·(A ⋅ B)·D) with the scaling D and functor f of an epilogue.
+    /// \param A0 Pointer to the base of the left-hand operand.
+    /// \param B0 Pointer to the base of the right-hand operand.
+    /// \param C0 Pointer to the base of the destination tensor.
+    /// \param ep Epilogue indexed by the flattened M and N indices of this engine.
+    /// \ingroup kernel_cpu
+    template <typename F> void run(T const* A0, T const* B0, T* C0, flat_epilogue<T, F> const& ep) const
+    {
+      this->loopM(0, 0, A0, B0, C0, &ep);
+    }
 
   private:
+    static constexpr std::nullptr_t const* no_epilogue = nullptr;
+
     static_vector<extent_strides<2>, MR> const Mgrp_;
     static_vector<extent_strides<2>, NR> const Ngrp_;
     static_vector<extent_strides<2>, KR> const Kgrp_;
     T const alpha_, beta_;
+    bool const conj_products_, conj_result_;
 
     /// \brief Recursively advances through the fused M dimensions.
+    /// \tparam Ep Epilogue type, or std::nullptr_t for a plain update.
     /// \param dim Index of the current M dimension.
+    /// \param row Flattened M index of the outer dimensions.
     /// \param a_ptr Pointer to the active location within the left-hand operand.
     /// \param b_ptr Pointer to the active location within the right-hand operand.
     /// \param c_ptr Pointer to the active location within the destination tensor.
+    /// \param ep Epilogue applied to each output element.
     /// \ingroup internal
-    void loopM(std::size_t dim, T const* a_ptr, T const* b_ptr, T* c_ptr) noexcept
+    template <typename Ep>
+    void loopM(std::size_t dim, index_type row, T const* a_ptr, T const* b_ptr, T* c_ptr, Ep const* ep) const
     {
       if (dim == Mgrp_.size())
       {
-        loopN(0, a_ptr, b_ptr, c_ptr);
+        loopN(0, row, 0, a_ptr, b_ptr, c_ptr, ep);
         return;
       }
       auto extent = Mgrp_[dim].extent;
@@ -63,26 +91,55 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
       auto sC = Mgrp_[dim].strides[1];
       for (decltype(extent) i = 0; i < extent; ++i)
       {
-        loopM(dim + 1, a_ptr, b_ptr, c_ptr);
+        loopM(dim + 1, row * extent + i, a_ptr, b_ptr, c_ptr, ep);
         a_ptr += sA;
         c_ptr += sC;
       }
     }
 
     /// \brief Recursively advances through the fused N dimensions.
+    /// \tparam Ep Epilogue type, or std::nullptr_t for a plain update.
     /// \param dim Index of the current N dimension.
+    /// \param row Flattened M index of the output element.
+    /// \param col Flattened N index of the outer dimensions.
     /// \param a_ptr Pointer to the active location within the left-hand operand.
     /// \param b_ptr Pointer to the active location within the right-hand operand.
     /// \param c_ptr Pointer to the active location within the destination tensor.
+    /// \param ep Epilogue applied to each output element.
     /// \ingroup internal
-    void loopN(std::size_t dim, T const* a_ptr, T const* b_ptr, T* c_ptr) noexcept
+    template <typename Ep>
+    void loopN(std::size_t dim, index_type row, index_type col, T const* a_ptr, T const* b_ptr, T* c_ptr,
+               Ep const* ep) const
     {
       if (dim == Ngrp_.size())
       {
         // At each M×N “cell” we do the dot-product over all K dims:
-        T acc{};
-        dotK(0, a_ptr, b_ptr, acc);
-        *c_ptr = (beta_ * *c_ptr) + (alpha_ * acc);
+        Acc acc{};
+        if constexpr (Complex<T>)
+        {
+          if (conj_products_)
+            dotK<true>(0, a_ptr, b_ptr, acc);
+          else
+            dotK<false>(0, a_ptr, b_ptr, acc);
+          if (conj_result_) acc = uni20::conj(acc);
+        }
+        else
+          dotK<false>(0, a_ptr, b_ptr, acc);
+        T alpha = alpha_;
+        if constexpr (!std::is_null_pointer_v<Ep>)
+        {
+          if (ep->scaled()) alpha *= ep->scale(row, col);
+        }
+        // as in BLAS, C is not read when beta is zero, so NaN or garbage already in it does not propagate
+        T value;
+        if constexpr (std::is_same_v<Acc, T>)
+          value = beta_ == T{} ? alpha * acc : (beta_ * *c_ptr) + (alpha * acc);
+        else
+          value = static_cast<T>(beta_ == T{} ? Acc(alpha) * acc : (Acc(beta_) * Acc(*c_ptr)) + (Acc(alpha) * acc));
+        if constexpr (!std::is_null_pointer_v<Ep>)
+          *c_ptr = ep->op(value);
+        else
+          *c_ptr = value;
         return;
       }
       auto extent = Ngrp_[dim].extent;
@@ -90,24 +147,30 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
       auto sC = Ngrp_[dim].strides[1];
       for (decltype(extent) j = 0; j < extent; ++j)
       {
-        loopN(dim + 1, a_ptr, b_ptr, c_ptr);
+        loopN(dim + 1, row, col * extent + j, a_ptr, b_ptr, c_ptr, ep);
         b_ptr += sB;
         c_ptr += sC;
       }
     }
 
     /// \brief Recursively accumulates dot products across the fused K dimensions.
+    /// \tparam ConjA Whether the elements of A are conjugated.
     /// \param dim Index of the current K dimension.
     /// \param a_ptr Pointer to the active location within the left-hand operand.
     /// \param b_ptr Pointer to the active location within the right-hand operand.
     /// \param acc Running contraction accumulator.
     /// \ingroup internal
-    void dotK(std::size_t dim, T const* a_ptr, T const* b_ptr, T& acc) noexcept
+    template <bool ConjA> void dotK(std::size_t dim, T const* a_ptr, T const* b_ptr, Acc& acc) const noexcept
     {
       if (dim == Kgrp_.size())
       {
         // we’ve arrived at a single element to multiply:
-        acc += *a_ptr * *b_ptr;
+        if constexpr (ConjA)
+          acc += Acc(uni20::conj(*a_ptr)) * Acc(*b_ptr);
+        else if constexpr (std::is_same_v<Acc, T>)
+          acc += *a_ptr * *b_ptr;
+        else
+          acc += Acc(*a_ptr) * Acc(*b_ptr);
         return;
       }
       auto extent = Kgrp_[dim].extent;
@@ -115,7 +178,7 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
       auto sB = Kgrp_[dim].strides[1];
       for (decltype(extent) k = 0; k < extent; ++k)
       {
-        dotK(dim + 1, a_ptr, b_ptr, acc);
+        dotK<ConjA>(dim + 1, a_ptr, b_ptr, acc);
         a_ptr += sA;
         b_ptr += sB;
       }
@@ -124,12 +187,17 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR> class Gemm
 
 } // namespace cpu
 
-template <typename T, std::size_t MR, std::size_t NR, std::size_t KR>
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR, typename Acc>
 /// \brief Execute the CPU tensor contraction using precomputed stride groupings.
+/// \details Contractions over float, double and their complex counterparts whose volume reaches
+///          cpu::blocked_gemm_min_volume use the packed cpu::BlockedGemm engine; everything else runs
+///          through the recursive cpu::GemmLoop. Both engines honour the conjugation flags and accumulate in
+///          the requested type.
 /// \tparam T Scalar type stored in the tensors.
 /// \tparam MR Number of fused M dimensions.
 /// \tparam NR Number of fused N dimensions.
 /// \tparam KR Number of fused K dimensions.
+/// \tparam Acc Requested accumulator type, or void for \p T.
 /// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
 /// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
 /// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
@@ -139,15 +207,92 @@ template <typename T, std::size_t MR, std::size_t NR, std::size_t KR>
 /// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
 /// \param C Pointer to the base of the destination tensor.
 /// \param tag Backend selector tag.
+/// \param opts Conjugation flags and accumulator type.
 /// \ingroup kernel_cpu
 void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
                       static_vector<extent_strides<2>, NR> const& Ngrp,
                       static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
-                      cpu_tag tag)
+                      cpu_tag tag, contract_options<Acc> opts)
 {
   static_cast<void>(tag);
-  cpu::GemmLoop Loop(Mgrp, Ngrp, Kgrp, alpha, beta);
+  using AccT = contract_accumulator_t<T, Acc>;
+  if constexpr (BlasScalar<T> && BlasScalar<AccT>)
+  {
+    if (cpu::group_extent(Mgrp) * cpu::group_extent(Ngrp) * cpu::group_extent(Kgrp) >= cpu::blocked_gemm_min_volume)
+    {
+      cpu::BlockedGemm<T, AccT> Engine(Mgrp, Ngrp, Kgrp, alpha, beta, opts.conj_a, opts.conj_b);
+      Engine.run(A, B, C);
+      return;
+    }
+  }
+  cpu::GemmLoop<T, MR, NR, KR, AccT> Loop(Mgrp, Ngrp, Kgrp, alpha, beta, opts.conj_a, opts.conj_b);
   Loop.run(A, B, C);
 }
 
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR, typename Acc, typename F>
+/// \brief Execute the CPU tensor contraction with a fused epilogue, C = f(β·C + α·(A ⋅ B)·D).
+/// \details Both engines apply the epilogue while each output element is written: cpu::GemmLoop per element
+///          and cpu::BlockedGemm per register tile, with the scaling D folded into the packed operands.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \tparam Acc Requested accumulator type, or void for \p T.
+/// \tparam F Elementwise epilogue functor.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param opts Conjugation flags and accumulator type.
+/// \param ep Epilogue indexed by the flattened M and N indices of the groups.
+/// \ingroup kernel_cpu
+void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
+                      static_vector<extent_strides<2>, NR> const& Ngrp,
+                      static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
+                      cpu_tag tag, contract_options<Acc> opts, flat_epilogue<T, F> const& ep)
+{
+  static_cast<void>(tag);
+  using AccT = contract_accumulator_t<T, Acc>;
+  if constexpr (BlasScalar<T> && BlasScalar<AccT>)
+  {
+    if (cpu::group_extent(Mgrp) * cpu::group_extent(Ngrp) * cpu::group_extent(Kgrp) >= cpu::blocked_gemm_min_volume)
+    {
+      cpu::BlockedGemm<T, AccT> Engine(Mgrp, Ngrp, Kgrp, alpha, beta, opts.conj_a, opts.conj_b);
+      Engine.run(A, B, C, ep);
+      return;
+    }
+  }
+  cpu::GemmLoop<T, MR, NR, KR, AccT> Loop(Mgrp, Ngrp, Kgrp, alpha, beta, opts.conj_a, opts.conj_b);
+  Loop.run(A, B, C, ep);
+}
+
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute the CPU tensor contraction using precomputed stride groupings.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \ingroup kernel_cpu
+void contract_strided(static_vector<extent_strides<2>, MR> const& Mgrp,
+                      static_vector<extent_strides<2>, NR> const& Ngrp,
+                      static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B, T beta, T* C,
+                      cpu_tag tag)
+{
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, tag, contract_options<>{});
+}
+
 } // namespace uni20::kernel
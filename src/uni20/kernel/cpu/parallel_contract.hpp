@@ -0,0 +1,237 @@
+#pragma once
+
+/**
+ * \file parallel_contract.hpp
+ * \ingroup kernel_cpu
+ * \brief Multithreaded tensor contraction over a oneTBB task arena.
+ * \details The flattened M×N output space is cut into tiles that run on disjoint parts of C. When there are
+ *          too few output tiles to occupy the arena, the contracted extent is additionally split into chunks
+ *          whose partial sums are reduced in a fixed order, so results do not depend on scheduling.
+ */
+
+#include "blocked_gemm.hpp"
+#include "contract.hpp"
+#include <uni20/common/aligned_buffer.hpp>
+
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/partitioner.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace uni20::kernel
+{
+
+namespace cpu
+{
+
+/// \brief Minimum m·n·k volume below which a contraction always runs serially.
+/// \ingroup kernel_cpu
+inline constexpr index_type contract_parallel_min_volume = index_type(1) << 18;
+
+/// \brief Minimum m·n·k volume of a single parallel task.
+/// \ingroup kernel_cpu
+inline constexpr index_type contract_parallel_min_task_volume = index_type(1) << 16;
+
+/// \brief Partition of a flattened M×N×K contraction into independent tasks.
+/// \ingroup kernel_cpu
+struct contract_partition
+{
+    index_type tile_m;   ///< Rows of C per tile.
+    index_type tile_n;   ///< Columns of C per tile.
+    index_type k_chunks; ///< Number of chunks the contracted extent is split into.
+
+    /// \brief True if the partition consists of a single task.
+    constexpr bool is_serial(index_type m, index_type n) const noexcept
+    {
+      return tile_m >= m && tile_n >= n && k_chunks <= 1;
+    }
+};
+
+/// \brief Choose tile sizes for a parallel contraction.
+/// \details Contractions below contract_parallel_min_volume stay serial. Otherwise output tiles start at one
+///          cache block and are halved (keeping multiples of the register tile) until there are about four
+///          tiles per thread or a tile would fall below contract_parallel_min_task_volume. If that still leaves
+///          threads idle and the contracted extent spans several cache blocks, K is split as well.
+/// \param m Flattened M extent.
+/// \param n Flattened N extent.
+/// \param k Flattened K extent.
+/// \param concurrency Number of threads available.
+/// \param mr Row granularity of a tile.
+/// \param nr Column granularity of a tile.
+/// \param kc Minimum depth of a K chunk.
+/// \param allow_k_split Whether the contracted extent may be partitioned.
+/// \return The chosen partition.
+/// \ingroup kernel_cpu
+constexpr contract_partition partition_contraction(index_type m, index_type n, index_type k, int concurrency,
+                                                   index_type mr, index_type nr, index_type kc,
+                                                   bool allow_k_split = true) noexcept
+{
+  contract_partition p{std::max<index_type>(m, 1), std::max<index_type>(n, 1), 1};
+  if (concurrency <= 1 || m * n * k < contract_parallel_min_volume) return p;
+
+  auto tiles = [&] { return ((m + p.tile_m - 1) / p.tile_m) * ((n + p.tile_n - 1) / p.tile_n); };
+  index_type const target = 4 * index_type(concurrency);
+  p.tile_m = std::min(p.tile_m, 16 * mr);
+  p.tile_n = std::min(p.tile_n, 16 * nr);
+  while (tiles() < target)
+  {
+    bool const split_m = p.tile_m / mr >= p.tile_n / nr;
+    index_type const tm = split_m ? std::max(mr, (p.tile_m / 2 + mr - 1) / mr * mr) : p.tile_m;
+    index_type const tn = split_m ? p.tile_n : std::max(nr, (p.tile_n / 2 + nr - 1) / nr * nr);
+    if ((tm == p.tile_m && tn == p.tile_n) || tm * tn * k < contract_parallel_min_task_volume) break;
+    p.tile_m = tm;
+    p.tile_n = tn;
+  }
+
+  if (allow_k_split && tiles() < index_type(concurrency) && k >= 2 * kc)
+  {
+    index_type const wanted = (index_type(concurrency) + tiles() - 1) / tiles();
+    p.k_chunks = std::max<index_type>(1, std::min(wanted, k / kc));
+  }
+  return p;
+}
+
+/// \brief Run a callable inside \p arena, or directly in the calling thread's arena if it is null.
+/// \ingroup internal
+template <typename F> void execute_in(oneapi::tbb::task_arena* arena, F&& f)
+{
+  if (arena)
+    arena->execute(std::forward<F>(f));
+  else
+    std::forward<F>(f)();
+}
+
+/// \brief Multithreaded contraction using the cache-blocked engine.
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup kernel_cpu
+template <BlasScalar T, std::size_t MR, std::size_t NR, std::size_t KR>
+void parallel_blocked_contract(static_vector<extent_strides<2>, MR> const& Mgrp,
+                               static_vector<extent_strides<2>, NR> const& Ngrp,
+                               static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B,
+                               T beta, T* C, oneapi::tbb::task_arena* arena)
+{
+  using traits = blocked_gemm_traits<T>;
+  BlockedGemm<T> Engine(Mgrp, Ngrp, Kgrp, alpha, beta);
+  index_type const m = Engine.m(), n = Engine.n(), k = Engine.k();
+  int const concurrency = arena ? arena->max_concurrency() : oneapi::tbb::this_task_arena::max_concurrency();
+  auto const part = partition_contraction(m, n, k, concurrency, traits::mr, traits::nr, traits::kc);
+  if (part.is_serial(m, n))
+  {
+    Engine.run(A, B, C);
+    return;
+  }
+
+  index_type const tiles_m = (m + part.tile_m - 1) / part.tile_m;
+  index_type const tiles_n = (n + part.tile_n - 1) / part.tile_n;
+  index_type const tiles = tiles_m * tiles_n;
+  auto tile_range = [&](index_type t) {
+    index_type const i0 = (t % tiles_m) * part.tile_m;
+    index_type const j0 = (t / tiles_m) * part.tile_n;
+    return std::array{i0, std::min(m, i0 + part.tile_m), j0, std::min(n, j0 + part.tile_n)};
+  };
+
+  if (part.k_chunks <= 1)
+  {
+    auto out = Engine.output(C);
+    execute_in(arena, [&] {
+      oneapi::tbb::parallel_for(index_type(0), tiles, [&](index_type t) {
+        auto [i0, i1, j0, j1] = tile_range(t);
+        Engine.run_block(A, B, out, i0, i1, j0, j1, 0, k, beta);
+      }, oneapi::tbb::simple_partitioner{});
+    });
+    return;
+  }
+
+  // Split K: chunk c accumulates α·A·B over its share of K into a private column-major m×n buffer, then the
+  // buffers are summed in chunk order into C.
+  index_type const chunks = part.k_chunks;
+  index_type const chunk_k = (k + chunks - 1) / chunks;
+  auto partial = allocate_uninitialized_buffer<T>(chunks * m * n);
+  auto rows = allocate_uninitialized_buffer<std::ptrdiff_t>(m);
+  auto cols = allocate_uninitialized_buffer<std::ptrdiff_t>(n);
+  for (index_type i = 0; i < m; ++i)
+    rows[i] = i;
+  for (index_type j = 0; j < n; ++j)
+    cols[j] = j * m;
+  auto c_out = Engine.output(C);
+
+  execute_in(arena, [&] {
+    oneapi::tbb::parallel_for(index_type(0), tiles * chunks, [&](index_type task) {
+      index_type const c = task / tiles;
+      auto [i0, i1, j0, j1] = tile_range(task % tiles);
+      index_type const p0 = std::min(k, c * chunk_k);
+      index_type const p1 = std::min(k, p0 + chunk_k);
+      typename BlockedGemm<T>::output_view out{partial.get() + c * m * n, rows.get(), cols.get()};
+      for (index_type j = j0; j < j1; ++j)
+        std::fill_n(out.data + i0 + j * m, i1 - i0, T{});
+      Engine.run_block(A, B, out, i0, i1, j0, j1, p0, p1, T{});
+    }, oneapi::tbb::simple_partitioner{});
+
+    oneapi::tbb::parallel_for(index_type(0), tiles, [&](index_type t) {
+      auto [i0, i1, j0, j1] = tile_range(t);
+      for (index_type j = j0; j < j1; ++j)
+        for (index_type i = i0; i < i1; ++i)
+        {
+          T sum = partial[i + j * m];
+          for (index_type c = 1; c < chunks; ++c)
+            sum += partial[c * m * n + i + j * m];
+          T& dst = c_out.data[c_out.row_offsets[i] + c_out.col_offsets[j]];
+          dst = beta == T{} ? sum : (beta * dst) + sum;
+        }
+    }, oneapi::tbb::simple_partitioner{});
+  });
+}
+
+} // namespace cpu
+
+template <typename T, std::size_t MR, std::size_t NR, std::size_t KR>
+/// \brief Execute the CPU tensor contraction on multiple threads.
+/// \details Scalar types handled by cpu::BlockedGemm are partitioned by cpu::partition_contraction; other
+///          types, and contractions too small to benefit, run serially through contract_strided().
+/// \tparam T Scalar type stored in the tensors.
+/// \tparam MR Number of fused M dimensions.
+/// \tparam NR Number of fused N dimensions.
+/// \tparam KR Number of fused K dimensions.
+/// \param Mgrp Metadata describing extents and strides for the fused M dimensions.
+/// \param Ngrp Metadata describing extents and strides for the fused N dimensions.
+/// \param Kgrp Metadata describing extents and strides for the fused K dimensions.
+/// \param alpha Scaling factor applied to the contraction output.
+/// \param A Pointer to the base of the left-hand operand.
+/// \param B Pointer to the base of the right-hand operand.
+/// \param beta Scaling factor applied to the pre-existing contents of the destination tensor.
+/// \param C Pointer to the base of the destination tensor.
+/// \param tag Backend selector tag.
+/// \param arena Arena providing the worker threads, or null for the calling thread's arena.
+/// \ingroup kernel_cpu
+void contract_strided_parallel(static_vector<extent_strides<2>, MR> const& Mgrp,
+                               static_vector<extent_strides<2>, NR> const& Ngrp,
+                               static_vector<extent_strides<2>, KR> const& Kgrp, T alpha, T const* A, T const* B,
+                               T beta, T* C, cpu_tag tag, oneapi::tbb::task_arena* arena)
+{
+  if constexpr (BlasScalar<T>)
+  {
+    if (cpu::group_extent(Mgrp) * cpu::group_extent(Ngrp) * cpu::group_extent(Kgrp) >= cpu::blocked_gemm_min_volume)
+    {
+      cpu::parallel_blocked_contract(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, arena);
+      return;
+    }
+  }
+  contract_strided(Mgrp, Ngrp, Kgrp, alpha, A, B, beta, C, tag);
+}
+
+} // namespace uni20::kernel
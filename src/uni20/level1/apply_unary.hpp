@@ -1,11 +1,17 @@
 #pragma once
 
+#include <uni20/level1/execution.hpp>
 #include <uni20/mdspan/iteration_plan.hpp>
 
+#include <type_traits>
+#include <utility>
+
 namespace uni20
 {
 
 /// \brief Apply a unary operation to every element of a strided mdspan in-place.
+/// \details Unit-stride runs of a span with the default accessor are processed over raw pointers; wrapping
+///          \p op in simd::simd_op additionally runs them on native SIMD vectors.
 /// \tparam MDS Mdspan-like type that models StridedMdspan.
 /// \tparam Op  Unary callable applied to each element.
 /// \param a    Target span whose elements are mutated.
@@ -24,4 +30,35 @@ template <typename MDS, typename Op> void apply_unary_inplace(MDS a, Op&& op)
   helper.run(offset, plan.data(), plan.size() - 1);
 }
 
+/// \brief Apply a unary operation to every element of a strided mdspan in-place, serially.
+/// \ingroup level1_ops
+template <typename MDS, typename Op> void apply_unary_inplace(sequenced_policy, MDS a, Op&& op)
+{
+  apply_unary_inplace(a, std::forward<Op>(op));
+}
+
+/// \brief Apply a unary operation to every element of a strided mdspan in-place, in parallel.
+/// \details Each task works on its own copy of \p op, so \p op must be copyable and its copies must be safe to
+///          invoke concurrently. Spans with fewer than \c policy.min_size elements are processed serially.
+/// \tparam MDS Mdspan-like type that models StridedMdspan.
+/// \tparam Op  Unary callable applied to each element.
+/// \param policy Parallel execution policy, normally \ref par.
+/// \param a    Target span whose elements are mutated.
+/// \param op   Unary functor invoked for each element.
+/// \ingroup level1_ops
+template <typename MDS, typename Op> void apply_unary_inplace(parallel_policy const& policy, MDS a, Op&& op)
+{
+  auto const& acc = a.accessor();
+  auto data = a.data_handle();
+  auto [plan, offset] = make_iteration_plan_with_offset(a.mapping());
+
+  if (plan.empty()) return;
+
+  detail::parallel_plan_for(policy, plan, offset, [&](auto const& sub_plan, auto sub_offset) {
+    std::decay_t<Op> local_op = op;
+    detail::UnrollHelper helper{data, acc, local_op};
+    helper.run(sub_offset, sub_plan.data(), sub_plan.size() - 1);
+  });
+}
+
 } // namespace uni20
@@ -2,9 +2,17 @@
 
 #include <uni20/common/mdspan.hpp>
 #include <uni20/common/trace.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/level1/flatten.hpp>
 #include <uni20/mdspan/concepts.hpp>
 #include <uni20/mdspan/iteration_plan.hpp>
 
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 /**
  * \defgroup level1_ops Level-1 tensor algorithms
  * \brief Element-wise tensor kernels that operate on strided mdspan views.
@@ -24,12 +32,195 @@ template <StridedMdspan MDS1, StridedMdspan MDS2> void assign(MDS1 const& src, M
   static_assert(MDS1::rank() == MDS2::rank(), "assign: rank mismatch");
   PRECONDITION_EQUAL(src.extents(), dst.extents(), "assign: shape mismatch");
 
-  auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{dst.mapping(), src.mapping()});
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(
+      std::array{dst.mapping(), src.mapping()},
+      std::array{sizeof(typename MDS2::element_type), sizeof(typename MDS1::element_type)});
 
   if (plan.empty()) return;
 
-  detail::MultiUnrollHelper helper{[](auto&& dst_v, auto&& src_v) { return src_v; }, dst, src};
+  detail::MultiUnrollHelper helper{simd::simd_op{[](auto&& dst_v, auto&& src_v) { return src_v; }}, dst, src};
   helper.run(plan, offsets);
 }
 
+namespace detail
+{
+
+/// \brief Copy the elements with row-major flattened index in [\p first, \p last) from \p src to \p dst.
+/// \details Fallback for non-strided sources that flatten_expression() cannot take apart, which are evaluated
+///          through their mapping and accessor at each multi-index.
+/// \ingroup internal
+template <SpanLike MDS1, StridedMdspan MDS2>
+void assign_indexed(MDS1 const& src, MDS2 const& dst, std::ptrdiff_t first, std::ptrdiff_t last)
+{
+  constexpr std::size_t R = MDS2::rank();
+  using index_type = typename MDS2::index_type;
+
+  std::array<index_type, R> idx{};
+  for (std::ptrdiff_t rem = first, d = R; d-- > 0;)
+  {
+    idx[d] = index_type(rem % std::ptrdiff_t(dst.extent(d)));
+    rem /= std::ptrdiff_t(dst.extent(d));
+  }
+
+  auto const& src_map = src.mapping();
+  auto const& dst_map = dst.mapping();
+  for (std::ptrdiff_t i = first; i < last; ++i)
+  {
+    dst.accessor().access(dst.data_handle(), std::apply(dst_map, idx)) =
+        src.accessor().access(src.data_handle(), std::apply(src_map, idx));
+
+    for (std::size_t d = R; d-- > 0;)
+    {
+      if (++idx[d] < dst.extent(d)) break;
+      idx[d] = 0;
+    }
+  }
+}
+
+/// \brief Evaluate a flattened expression into \p dst in a single fused pass.
+/// \details The \p leaves share one merged iteration plan with \p dst, and each element of \p dst is computed by
+///          \p eval from one element of every leaf, as returned by flatten_expression().
+/// \ingroup internal
+template <ExecutionPolicy Policy, typename Leaves, typename Eval, StridedMdspan MDS2>
+void assign_flattened(Policy const& policy, Leaves const& leaves, Eval const& eval, MDS2 dst)
+{
+  if (dst.size() == 0) return;
+
+  auto out = as_dynamic_strided(dst);
+
+  std::apply(
+      [&](auto const&... leaf) {
+        auto [plan, offsets] = make_multi_iteration_plan_with_offset(
+            std::array{out.mapping(), leaf.mapping()...},
+            std::array{sizeof(typename decltype(out)::element_type),
+                       sizeof(typename std::remove_cvref_t<decltype(leaf)>::element_type)...});
+        if (plan.empty())
+        {
+          // a single element, at the offsets of the plan
+          [&]<std::size_t... I>(std::index_sequence<I...>)
+          {
+            out.accessor().access(out.data_handle(), offsets[0]) =
+                eval(std::forward_as_tuple(leaf.accessor().access(leaf.data_handle(), offsets[I + 1])...));
+          }
+          (std::index_sequence_for<decltype(leaf)...>{});
+          return;
+        }
+        auto run = [&](auto const& sub_plan, auto sub_offsets) {
+          MultiUnrollHelper helper{[&eval](auto&&, auto&&... x) { return eval(std::forward_as_tuple(x...)); }, out,
+                                   leaf...};
+          helper.run(sub_plan, sub_offsets);
+        };
+        if constexpr (std::is_same_v<Policy, parallel_policy>)
+          parallel_plan_for(policy, plan, offsets, run);
+        else
+          run(plan, offsets);
+      },
+      leaves);
+}
+
+/// \brief Evaluate a lazy zip_transform() / sum_view() tree into \p dst in a single fused pass.
+/// \details The tree is flattened into its strided leaves, which share one merged iteration plan with \p dst,
+///          and each element of \p dst is computed from one element of every leaf without any temporary.
+/// \ingroup internal
+template <ExecutionPolicy Policy, SpanLike MDS1, StridedMdspan MDS2>
+void assign_fused(Policy const& policy, MDS1 const& src, MDS2 dst)
+{
+  auto flat = flatten_expression(src);
+  assign_flattened(policy, flat.first, flat.second, dst);
+}
+
+/// \brief Materialise a non-strided view into \p dst, fused if it is a lazy tree over strided spans.
+/// \ingroup internal
+template <ExecutionPolicy Policy, SpanLike MDS1, StridedMdspan MDS2>
+void assign_lazy(Policy const& policy, MDS1 const& src, MDS2 dst)
+{
+  static_assert(MDS1::rank() == MDS2::rank(), "assign: rank mismatch");
+  PRECONDITION_EQUAL(src.extents(), dst.extents(), "assign: shape mismatch");
+
+  if (dst.size() == 0) return;
+
+  if constexpr (is_flattenable<MDS1> && MDS2::rank() > 0)
+  {
+    assign_fused(policy, src, dst);
+  }
+  else if constexpr (std::is_same_v<Policy, parallel_policy>)
+  {
+    parallel_range_for(policy, std::ptrdiff_t(dst.size()),
+                       [&](std::ptrdiff_t first, std::ptrdiff_t last) { assign_indexed(src, dst, first, last); });
+  }
+  else
+  {
+    assign_indexed(src, dst, 0, std::ptrdiff_t(dst.size()));
+  }
+}
+
+} // namespace detail
+
+/// \brief Materialise a non-strided view, such as a multi-input zip_transform() or sum_view(), into \p dst.
+/// \details A tree of zip_transform() and sum_view() nodes over strided spans is evaluated in one fused pass over
+///          its leaves, so an expression such as `a*x + b*y + z` needs no temporaries. Any other view is evaluated
+///          element by element through its mapping.
+/// \tparam MDS1 Source view type that models SpanLike but not StridedMdspan.
+/// \tparam MDS2 Destination mdspan type that models StridedMdspan.
+/// \param src Source view providing the element values.
+/// \param dst Destination view receiving the copied elements.
+/// \ingroup level1_ops
+template <SpanLike MDS1, StridedMdspan MDS2>
+requires(!StridedMdspan<MDS1>) void assign(MDS1 const& src, MDS2 dst)
+{
+  detail::assign_lazy(seq, src, dst);
+}
+
+/// \brief Copy elements from a source view into a destination mdspan, serially.
+/// \ingroup level1_ops
+template <SpanLike MDS1, StridedMdspan MDS2> void assign(sequenced_policy, MDS1 const& src, MDS2 dst)
+{
+  assign(src, dst);
+}
+
+/// \brief Copy elements from a source mdspan into a destination mdspan, in parallel.
+/// \details A lazy single-input zip_transform() view is materialised this way, with its functor invoked
+///          concurrently. Tensors with fewer than \c policy.min_size elements are copied
+///          serially.
+/// \tparam MDS1 Source mdspan type that models StridedMdspan.
+/// \tparam MDS2 Destination mdspan type that models StridedMdspan.
+/// \param policy Parallel execution policy, normally \ref par.
+/// \param src Source view providing the element values.
+/// \param dst Destination view receiving the copied elements.
+/// \ingroup level1_ops
+template <StridedMdspan MDS1, StridedMdspan MDS2>
+void assign(parallel_policy const& policy, MDS1 const& src, MDS2 dst)
+{
+  static_assert(MDS1::rank() == MDS2::rank(), "assign: rank mismatch");
+  PRECONDITION_EQUAL(src.extents(), dst.extents(), "assign: shape mismatch");
+
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(
+      std::array{dst.mapping(), src.mapping()},
+      std::array{sizeof(typename MDS2::element_type), sizeof(typename MDS1::element_type)});
+
+  if (plan.empty()) return;
+
+  detail::parallel_plan_for(policy, plan, offsets, [&](auto const& sub_plan, auto sub_offsets) {
+    detail::MultiUnrollHelper helper{simd::simd_op{[](auto&& dst_v, auto&& src_v) { return src_v; }}, dst, src};
+    helper.run(sub_plan, sub_offsets);
+  });
+}
+
+/// \brief Materialise a non-strided view, such as a multi-input zip_transform() or sum_view(), in parallel.
+/// \details A lazy tree over strided spans is evaluated in one fused pass whose merged iteration plan is split
+///          into chunks; any other view has the row-major flattened index range of \p dst split instead. The
+///          functors of the view are invoked concurrently. Tensors with fewer than \c policy.min_size elements are
+///          materialised serially.
+/// \tparam MDS1 Source view type that models SpanLike but not StridedMdspan.
+/// \tparam MDS2 Destination mdspan type that models StridedMdspan.
+/// \param policy Parallel execution policy, normally \ref par.
+/// \param src Source view providing the element values.
+/// \param dst Destination view receiving the copied elements.
+/// \ingroup level1_ops
+template <SpanLike MDS1, StridedMdspan MDS2>
+requires(!StridedMdspan<MDS1>) void assign(parallel_policy const& policy, MDS1 const& src, MDS2 dst)
+{
+  detail::assign_lazy(policy, src, dst);
+}
+
 } // namespace uni20
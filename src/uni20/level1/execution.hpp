@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+ * \file execution.hpp
+ * \ingroup level1_ops
+ * \brief Execution policies for the level-1 kernels and the TBB driver behind the parallel one.
+ * \details A parallel kernel splits the leading dimensions of its merged iteration plan into a flattened range
+ *          of outer indices, hands contiguous chunks of that range to TBB, and runs the serial loop nest over the
+ *          remaining dimensions of each chunk. Tensors smaller than parallel_policy::min_size stay serial.
+ */
+
+#include <uni20/mdspan/iteration_plan.hpp>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace uni20
+{
+
+/// \brief Default element count below which a parallel level-1 kernel runs serially.
+/// \ingroup level1_ops
+inline constexpr std::size_t level1_parallel_min_size = std::size_t(1) << 15;
+
+/// \brief Default minimum number of elements handed to a single TBB task.
+/// \ingroup level1_ops
+inline constexpr std::size_t level1_parallel_grain = std::size_t(1) << 12;
+
+/// \brief Execution policy requesting the serial kernel.
+/// \ingroup level1_ops
+struct sequenced_policy
+{};
+
+/// \brief Execution policy requesting a kernel parallelised over TBB.
+/// \details The functor of a kernel run under this policy is copied into each task, and the copies are invoked
+///          concurrently on disjoint elements.
+/// \ingroup level1_ops
+struct parallel_policy
+{
+    oneapi::tbb::task_arena* arena = nullptr;       ///< Arena to run in, or null for the caller's arena.
+    std::size_t min_size = level1_parallel_min_size; ///< Element count below which the kernel stays serial.
+    std::size_t grain = level1_parallel_grain;       ///< Minimum number of elements per task.
+
+    /// \brief Copy of this policy that runs in \p a.
+    constexpr parallel_policy on(oneapi::tbb::task_arena& a) const noexcept
+    {
+      parallel_policy p = *this;
+      p.arena = &a;
+      return p;
+    }
+
+    /// \brief Copy of this policy with serial threshold \p n.
+    constexpr parallel_policy with_min_size(std::size_t n) const noexcept
+    {
+      parallel_policy p = *this;
+      p.min_size = n;
+      return p;
+    }
+};
+
+/// \brief Serial execution policy object.
+/// \ingroup level1_ops
+inline constexpr sequenced_policy seq{};
+
+/// \brief Parallel execution policy object, e.g. `assign(par, src, dst)`.
+/// \ingroup level1_ops
+inline constexpr parallel_policy par{};
+
+/// \brief Satisfied by the level-1 execution policies, sequenced_policy and parallel_policy.
+/// \ingroup level1_ops
+template <typename P>
+concept ExecutionPolicy =
+    std::is_same_v<std::remove_cvref_t<P>, sequenced_policy> || std::is_same_v<std::remove_cvref_t<P>, parallel_policy>;
+
+namespace detail
+{
+
+/// \brief Run \p f inside the arena of \p policy, or in the calling thread's arena if it has none.
+/// \ingroup internal
+template <typename F> void execute_in(parallel_policy const& policy, F&& f)
+{
+  if (policy.arena)
+    policy.arena->execute(std::forward<F>(f));
+  else
+    std::forward<F>(f)();
+}
+
+/// \brief Advance \p offsets by \p i steps along plan dimension \p dim.
+/// \ingroup internal
+template <typename Offsets, typename Dim> constexpr void advance_offsets(Offsets& offsets, Dim const& dim, auto i)
+{
+  if constexpr (requires { dim.strides; })
+  {
+    for (std::size_t s = 0; s < dim.strides.size(); ++s)
+      offsets[s] += static_cast<std::ptrdiff_t>(i) * dim.strides[s];
+  }
+  else
+  {
+    offsets += static_cast<std::ptrdiff_t>(i) * dim.stride;
+  }
+}
+
+/// \brief Run a loop nest over a merged iteration plan, split into chunks executed on TBB.
+/// \details The leading plan dimensions are fused into a flattened outer range with at least four indices per
+///          thread, or the whole plan if it is too small for that. Each chunk of the outer range is cut into runs
+///          along the last fused dimension, and \p run is called with a sub-plan that starts at that dimension
+///          (its extent shortened to the run) and the offsets of the first element of the run.
+/// \tparam Plan    Non-empty plan from make_iteration_plan_with_offset() or
+///                 make_multi_iteration_plan_with_offset().
+/// \tparam Offsets Offset, or array of per-span offsets, matching \p Plan.
+/// \tparam Run     Callable invoked as `run(Plan const& sub_plan, Offsets offsets)`.
+/// \ingroup internal
+template <typename Plan, typename Offsets, typename Run>
+void parallel_plan_for(parallel_policy const& policy, Plan const& plan, Offsets const& offsets, Run&& run)
+{
+  using index_type = std::ptrdiff_t;
+
+  index_type total = 1;
+  for (auto const& dim : plan)
+    total *= index_type(dim.extent);
+
+  auto body = [&] {
+    index_type const threads = oneapi::tbb::this_task_arena::max_concurrency();
+    if (total < index_type(policy.min_size) || threads <= 1)
+    {
+      run(plan, offsets);
+      return;
+    }
+
+    std::size_t fused = 0;
+    index_type outer = 1;
+    while (fused < plan.size() && outer < 4 * threads)
+      outer *= index_type(plan[fused++].extent);
+
+    index_type const inner = total / outer;
+    index_type const grain = std::max<index_type>(1, index_type(policy.grain) / inner);
+    auto const& last = plan[fused - 1];
+
+    auto chunk = [&](oneapi::tbb::blocked_range<index_type> const& r) {
+      // Multi-index of r.begin() over the fused dimensions, last dimension fastest.
+      std::array<index_type, Plan::capacity()> idx{};
+      for (index_type rem = r.begin(), d = index_type(fused); d-- > 0;)
+      {
+        idx[d] = rem % index_type(plan[d].extent);
+        rem /= index_type(plan[d].extent);
+      }
+
+      Plan sub;
+      for (std::size_t d = fused - 1; d < plan.size(); ++d)
+        sub.push_back(plan[d]);
+
+      for (index_type i = r.begin(); i < r.end();)
+      {
+        index_type const len = std::min(r.end() - i, index_type(last.extent) - idx[fused - 1]);
+
+        Offsets off = offsets;
+        for (std::size_t d = 0; d < fused; ++d)
+          advance_offsets(off, plan[d], idx[d]);
+        sub[0].extent = static_cast<decltype(sub[0].extent)>(len);
+        run(std::as_const(sub), off);
+
+        i += len;
+        idx[fused - 1] += len;
+        for (std::size_t d = fused - 1; d > 0 && idx[d] == index_type(plan[d].extent); --d)
+        {
+          idx[d] = 0;
+          ++idx[d - 1];
+        }
+      }
+    };
+
+    oneapi::tbb::parallel_for(oneapi::tbb::blocked_range<index_type>(0, outer, grain), chunk);
+  };
+
+  execute_in(policy, body);
+}
+
+/// \brief Run \p f over chunks of the flattened index range [0, \p total), executed on TBB.
+/// \details Runs \c f(0, total) in the calling thread if \p total is below \c policy.min_size.
+/// \tparam F Callable invoked as `f(first, last)` on disjoint half-open subranges.
+/// \ingroup internal
+template <typename F> void parallel_range_for(parallel_policy const& policy, std::ptrdiff_t total, F&& f)
+{
+  if (total < std::ptrdiff_t(policy.min_size))
+  {
+    f(std::ptrdiff_t(0), total);
+    return;
+  }
+  execute_in(policy, [&] {
+    oneapi::tbb::parallel_for(
+        oneapi::tbb::blocked_range<std::ptrdiff_t>(0, total, std::max<std::ptrdiff_t>(1, policy.grain)),
+        [&](oneapi::tbb::blocked_range<std::ptrdiff_t> const& r) { f(r.begin(), r.end()); });
+  });
+}
+
+} // namespace detail
+
+} // namespace uni20
@@ -0,0 +1,207 @@
+#pragma once
+
+/**
+ * \file flatten.hpp
+ * \ingroup level1_ops
+ * \brief Flattening of lazy zip_transform() and sum_view() expression trees into their strided leaves.
+ * \details A lazy view nests transform and sum nodes over strided spans. flatten_expression() walks the nodes at
+ *          compile time and returns the strided leaves, each given a layout_stride mapping with dynamic extents so
+ *          that they can share one multi-operand iteration plan, together with an evaluator that recomputes the
+ *          value of the tree from one element of each leaf.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/level1/sum.hpp>
+#include <uni20/level1/zip_transform.hpp>
+#include <uni20/mdspan/concepts.hpp>
+#include <uni20/mdspan/iteration_plan.hpp>
+#include <uni20/mdspan/zip_layout.hpp>
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace uni20::detail
+{
+
+/// \brief Child span types of a lazy accessor, as a std::tuple; void for any other accessor.
+/// \ingroup internal
+template <typename Acc> struct zip_children_of
+{
+    using type = void;
+};
+
+template <typename F, typename... Spans> struct zip_children_of<TransformAccessor<F, Spans...>>
+{
+    using type = std::tuple<Spans...>;
+};
+
+template <typename... Spans> struct zip_children_of<SumAccessor<Spans...>>
+{
+    using type = std::tuple<Spans...>;
+};
+
+/// \brief True if \p V is a strided span, or a lazy transform or sum view whose children all flatten.
+/// \ingroup internal
+template <typename V> constexpr bool flattenable()
+{
+  if constexpr (StridedMdspan<V>)
+    return true;
+  else if constexpr (!std::is_void_v<typename zip_children_of<typename V::accessor_type>::type>)
+    return []<typename... Spans>(std::tuple<Spans...>*) { return (flattenable<Spans>() && ...); }(
+        static_cast<typename zip_children_of<typename V::accessor_type>::type*>(nullptr));
+  else
+    return false;
+}
+
+/// \brief Variable form of flattenable().
+/// \ingroup internal
+template <typename V> inline constexpr bool is_flattenable = flattenable<V>();
+
+/// \brief Reinterpret a strided span with a layout_stride mapping over dynamic extents.
+/// \ingroup internal
+template <StridedMdspan S> auto as_dynamic_strided(S const& s)
+{
+  auto mapping = dynamic_stride_mapping(s);
+  return stdex::mdspan<typename S::element_type, typename decltype(mapping)::extents_type, stdex::layout_stride,
+                       typename S::accessor_type>(s.data_handle(), mapping, s.accessor());
+}
+
+/// \brief Evaluator of a leaf: element \p I of the tuple of leaf values.
+/// \ingroup internal
+template <std::size_t I> struct leaf_eval
+{
+    template <typename Values> constexpr decltype(auto) operator()(Values const& values) const
+    {
+      return std::get<I>(values);
+    }
+};
+
+/// \brief Evaluator of an interior node: \p f applied to the values of its children.
+/// \ingroup internal
+template <typename F, typename... Children> struct node_eval
+{
+    F f;
+    std::tuple<Children...> children;
+
+    template <typename Values> constexpr auto operator()(Values const& values) const
+    {
+      return std::apply([&](auto const&... c) { return f(c(values)...); }, children);
+    }
+};
+
+/// \brief Functor form of the SumAccessor element: the sum of its arguments.
+/// \ingroup internal
+struct sum_children
+{
+    template <typename... T> constexpr auto operator()(T const&... x) const { return (x + ...); }
+};
+
+/// \brief Rebuild the child spans of a lazy view from its data handle, mapping and accessor.
+/// \ingroup internal
+template <typename V> auto zip_children(V const& v)
+{
+  using children = typename zip_children_of<typename V::accessor_type>::type;
+  constexpr std::size_t N = std::tuple_size_v<children>;
+  auto const& handles = v.data_handle();
+  auto const& accessors = v.accessor().get_accessors();
+
+  return [&]<std::size_t... I>(std::index_sequence<I...>)
+  {
+    if constexpr (N == 1 && !(StridedMdspan<std::tuple_element_t<0, children>>))
+    {
+      // unary transform of a lazy view: it keeps the layout and mapping of its child
+      using S = std::tuple_element_t<0, children>;
+      return std::tuple{stdex::mdspan<typename S::element_type, typename V::extents_type, typename V::layout_type,
+                                      typename S::accessor_type>(std::get<0>(handles), v.mapping(),
+                                                                 std::get<0>(accessors))};
+    }
+    else if constexpr (requires { v.mapping().all_strides(); })
+    {
+      // StridedZipLayout: one stride array per child
+      constexpr std::size_t R = V::rank();
+      using extents_type = stdex::dextents<std::ptrdiff_t, R>;
+      std::array<std::ptrdiff_t, R> extents{};
+      for (std::size_t r = 0; r < R; ++r)
+        extents[r] = std::ptrdiff_t(v.extent(r));
+      auto child = [&]<std::size_t J>(std::integral_constant<std::size_t, J>) {
+        using S = std::tuple_element_t<J, children>;
+        std::array<std::ptrdiff_t, R> strides{};
+        for (std::size_t r = 0; r < R; ++r)
+          strides[r] = std::ptrdiff_t(v.mapping().all_strides()[J][r]);
+        return stdex::mdspan<typename S::element_type, extents_type, stdex::layout_stride, typename S::accessor_type>(
+            std::get<J>(handles), stdex::layout_stride::mapping<extents_type>(extents_type(extents), strides),
+            std::get<J>(accessors));
+      };
+      return std::tuple{child(std::integral_constant<std::size_t, I>{})...};
+    }
+    else
+    {
+      // GeneralZipLayout: one child mapping per child
+      return std::tuple{
+          stdex::mdspan<typename std::tuple_element_t<I, children>::element_type, typename V::extents_type,
+                        typename std::tuple_element_t<I, children>::layout_type,
+                        typename std::tuple_element_t<I, children>::accessor_type>(
+              std::get<I>(handles), std::get<I>(v.mapping().mappings()), std::get<I>(accessors))...};
+    }
+  }
+  (std::make_index_sequence<N>{});
+}
+
+/// \brief Flatten a lazy view whose leaves are numbered from \p First.
+/// \return Pair of the tuple of leaves, as returned by as_dynamic_strided(), and the evaluator of the tree.
+/// \ingroup internal
+template <std::size_t First, typename V> auto flatten_expression_from(V const& v);
+
+/// \brief Flatten the children of a node, numbering their leaves consecutively from \p First.
+/// \return Pair of the concatenated tuple of leaves and the tuple of child evaluators.
+/// \ingroup internal
+template <std::size_t First, typename Children> auto flatten_children(Children const& children)
+{
+  if constexpr (std::tuple_size_v<Children> == 0)
+  {
+    return std::pair{std::tuple{}, std::tuple{}};
+  }
+  else
+  {
+    auto [head_leaves, head_eval] = flatten_expression_from<First>(std::get<0>(children));
+    constexpr std::size_t next = First + std::tuple_size_v<decltype(head_leaves)>;
+    auto tail = std::apply([](auto const&, auto const&... rest) { return std::tuple{rest...}; }, children);
+    auto [tail_leaves, tail_evals] = flatten_children<next>(tail);
+    return std::pair{std::tuple_cat(head_leaves, tail_leaves), std::tuple_cat(std::tuple{head_eval}, tail_evals)};
+  }
+}
+
+template <std::size_t First, typename V> auto flatten_expression_from(V const& v)
+{
+  static_assert(is_flattenable<V>, "flatten_expression: not a lazy expression over strided spans");
+  if constexpr (StridedMdspan<V>)
+  {
+    return std::pair{std::tuple{as_dynamic_strided(v)}, leaf_eval<First>{}};
+  }
+  else
+  {
+    auto [leaves, evals] = flatten_children<First>(zip_children(v));
+    auto f = [&] {
+      if constexpr (is_sum_accessor_v<typename V::accessor_type>)
+        return sum_children{};
+      else
+        return v.accessor().func();
+    }();
+    return std::apply(
+        [&](auto const&... e) {
+          return std::pair{leaves, node_eval<decltype(f), std::remove_cvref_t<decltype(e)>...>{f, {e...}}};
+        },
+        evals);
+  }
+}
+
+/// \brief Flatten a lazy zip_transform() / sum_view() tree into its strided leaves and an evaluator.
+/// \details The evaluator is invoked with a tuple holding one element of each leaf, in leaf order, and returns
+///          the corresponding element of \p v.
+/// \ingroup internal
+template <typename V> auto flatten_expression(V const& v) { return flatten_expression_from<0>(v); }
+
+} // namespace uni20::detail
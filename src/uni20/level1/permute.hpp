@@ -0,0 +1,270 @@
+#pragma once
+
+/**
+ * \file permute.hpp
+ * \ingroup level1_ops
+ * \brief Tensor permutation (generalised transpose) dst = alpha·permute(src) + beta·dst.
+ * \details The source strides are reordered by the permutation so that source and destination share one merged
+ *          iteration plan. If both tensors stream along the same dimension the plan runs as an elementwise
+ *          update. Otherwise the kernel follows the blocking scheme of HPTT: the dimension with the smallest
+ *          destination stride and the one with the smallest source stride are cut into square tiles sized for L1,
+ *          the remaining dimensions run outside the tiles, and each tile is written one contiguous destination row
+ *          at a time while the source lines it reads stay resident. The tiles are the unit of work of the parallel
+ *          policy.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/core/simd.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/level1/flatten.hpp>
+#include <uni20/mdspan/concepts.hpp>
+#include <uni20/mdspan/iteration_plan.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+namespace uni20
+{
+
+namespace detail
+{
+
+/// \brief Edge of the square tile of the permute kernel for elements of \p T: the largest power of two whose
+///        source and destination blocks together fill at most a quarter of tile_cache_bytes.
+/// \ingroup internal
+template <typename T> constexpr std::ptrdiff_t permute_tile()
+{
+  std::ptrdiff_t tile = 8;
+  while (std::size_t(2 * 4 * (2 * tile) * (2 * tile)) * sizeof(T) <= tile_cache_bytes)
+    tile *= 2;
+  return tile;
+}
+
+/// \brief Run one tile of the permute kernel: dst[a, b] = op(dst[a, b], src[a, b]) over \p na × \p nb elements.
+/// \details Each row of the tile along \c a is written contiguously to the destination while the source is read
+///          down a column; the lines of the source column stay in L1 until the following rows have consumed them.
+///          If \p Unit is true the destination has unit stride along \c a and the source unit stride along \c b, and
+///          \p dst_a and \p src_b are ignored.
+/// \tparam Unit True for the unit-stride specialisation.
+/// \ingroup internal
+template <bool Unit, typename U, typename T, typename Op>
+void permute_block(U const* src, std::ptrdiff_t src_a, std::ptrdiff_t src_b, T* dst, std::ptrdiff_t dst_a,
+                   std::ptrdiff_t dst_b, std::ptrdiff_t na, std::ptrdiff_t nb, Op const& op)
+{
+  if constexpr (Unit)
+  {
+    src_b = 1;
+    dst_a = 1;
+  }
+  for (std::ptrdiff_t b = 0; b < nb; ++b)
+  {
+    U const* s = src + b * src_b;
+    T* d = dst + b * dst_b;
+    UNI20_VECTORIZE_LOOP
+    for (std::ptrdiff_t a = 0; a < na; ++a)
+      d[a * dst_a] = op(d[a * dst_a], s[a * src_a]);
+  }
+}
+
+/// \brief Apply dst = op(dst, src) elementwise, where \p src has already been permuted to the shape of \p dst.
+/// \details \p op is a simd_op taking the old destination element and the source element. A plan whose
+///          destination and source stream along different dimensions is run as tiled transposes; any other plan,
+///          and any tensor with a non-default accessor, runs as an elementwise loop.
+/// \ingroup internal
+template <ExecutionPolicy Policy, StridedMdspan Src, MutableStridedMdspan Dst, typename Op>
+void permute_aligned(Policy const& policy, Src const& src, Dst const& dst, Op const& op)
+{
+  using index_type = std::ptrdiff_t;
+  using U = typename Src::element_type;
+  using T = typename Dst::element_type;
+
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{dst.mapping(), src.mapping()},
+                                                               std::array{sizeof(T), sizeof(U)});
+  if (plan.empty())
+  {
+    auto& d = dst.accessor().access(dst.data_handle(), offsets[0]);
+    d = op(d, src.accessor().access(src.data_handle(), offsets[1]));
+    return;
+  }
+
+  // a: the dimension along which dst streams; b: the dimension along which src streams
+  std::size_t a = 0, b = 0;
+  for (std::size_t d = 1; d < plan.size(); ++d)
+  {
+    if (std::abs(plan[d].strides[0]) < std::abs(plan[a].strides[0])) a = d;
+    if (std::abs(plan[d].strides[1]) < std::abs(plan[b].strides[1])) b = d;
+  }
+
+  // a tile pays off once both dimensions span a cache line
+  constexpr index_type line = std::max<index_type>(1, index_type(cache_line_bytes / sizeof(U)));
+  if constexpr (is_default_accessor<typename Src::accessor_type> && is_default_accessor<typename Dst::accessor_type>)
+  {
+    if (a != b && plan[a].extent >= line && plan[b].extent >= line)
+    {
+      constexpr index_type M = permute_tile<std::remove_const_t<U>>();
+      auto const& dim_a = plan[a];
+      auto const& dim_b = plan[b];
+      index_type const tiles_a = (dim_a.extent + M - 1) / M;
+      index_type const tiles_b = (dim_b.extent + M - 1) / M;
+
+      decltype(plan) outer;
+      index_type total = tiles_a * tiles_b;
+      for (std::size_t d = 0; d < plan.size(); ++d)
+      {
+        if (d == a || d == b) continue;
+        outer.push_back(plan[d]);
+        total *= index_type(plan[d].extent);
+      }
+
+      bool const unit = dim_a.strides[0] == 1 && dim_b.strides[1] == 1;
+      auto run_tiles = [&](index_type first, index_type last) {
+        for (index_type t = first; t < last; ++t)
+        {
+          // tile along a fastest, then along b, then the outer dimensions
+          index_type rem = t;
+          index_type const ta = rem % tiles_a;
+          rem /= tiles_a;
+          index_type const tb = rem % tiles_b;
+          rem /= tiles_b;
+          std::array<index_type, 2> off = offsets;
+          for (std::size_t d = outer.size(); d-- > 0;)
+          {
+            advance_offsets(off, outer[d], rem % index_type(outer[d].extent));
+            rem /= index_type(outer[d].extent);
+          }
+          advance_offsets(off, dim_a, ta * M);
+          advance_offsets(off, dim_b, tb * M);
+
+          auto const* s = src.data_handle() + off[1];
+          auto* d = dst.data_handle() + off[0];
+          index_type const na = std::min(M, index_type(dim_a.extent) - ta * M);
+          index_type const nb = std::min(M, index_type(dim_b.extent) - tb * M);
+          if (unit)
+            permute_block<true>(s, dim_a.strides[1], dim_b.strides[1], d, dim_a.strides[0], dim_b.strides[0], na, nb,
+                                op);
+          else
+            permute_block<false>(s, dim_a.strides[1], dim_b.strides[1], d, dim_a.strides[0], dim_b.strides[0], na,
+                                 nb, op);
+        }
+      };
+
+      if constexpr (std::is_same_v<Policy, parallel_policy>)
+      {
+        // the thresholds of the policy count elements, so scale them down to tiles
+        parallel_policy tiles = policy.with_min_size(policy.min_size / std::size_t(M * M));
+        tiles.grain = std::max<std::size_t>(1, policy.grain / std::size_t(M * M));
+        parallel_range_for(tiles, total, run_tiles);
+      }
+      else
+      {
+        run_tiles(0, total);
+      }
+      return;
+    }
+  }
+
+  auto run = [&](auto const& sub_plan, auto sub_offsets) {
+    MultiUnrollHelper helper{op, dst, src};
+    helper.run(sub_plan, sub_offsets);
+  };
+  if constexpr (std::is_same_v<Policy, parallel_policy>)
+    parallel_plan_for(policy, plan, offsets, run);
+  else
+    run(plan, offsets);
+}
+
+/// \brief Check that \p perm is a permutation taking the shape of \p src to the shape of \p dst, and return \p src
+///        with its axes reordered to match \p dst: axis \c i of the result is axis \c perm[i] of \p src.
+/// \ingroup internal
+template <StridedMdspan Src, StridedMdspan Dst, std::size_t R>
+auto permute_source(Src const& src, std::array<std::size_t, R> const& perm, Dst const& dst)
+{
+  static_assert(Src::rank() == R && Dst::rank() == R, "permute: permutation length must equal the rank");
+
+  using extents_type = stdex::dextents<std::ptrdiff_t, R>;
+  std::array<bool, R> seen{};
+  std::array<std::ptrdiff_t, R> extents{};
+  std::array<std::ptrdiff_t, R> strides{};
+  for (std::size_t i = 0; i < R; ++i)
+  {
+    PRECONDITION(perm[i] < R && !seen[perm[i]], "permute: not a permutation", perm[i]);
+    seen[perm[i]] = true;
+    PRECONDITION_EQUAL(std::ptrdiff_t(src.extent(perm[i])), std::ptrdiff_t(dst.extent(i)), "permute: shape mismatch");
+    extents[i] = std::ptrdiff_t(src.extent(perm[i]));
+    strides[i] = std::ptrdiff_t(src.stride(perm[i]));
+  }
+  return stdex::mdspan<typename Src::element_type, extents_type, stdex::layout_stride, typename Src::accessor_type>(
+      src.data_handle(), stdex::layout_stride::mapping<extents_type>(extents_type(extents), strides), src.accessor());
+}
+
+} // namespace detail
+
+/// \brief Permute the axes of a tensor: dst[i...] = alpha·src[j...] + beta·dst[i...], where axis \c k of \p dst is
+///        axis \c perm[k] of \p src.
+/// \details As for BLAS, \p dst is not read if \p beta is zero, and a permutation whose source and destination
+///          stream along different axes runs as a tiled transpose; see \ref permute.hpp. \p src and \p dst must
+///          not overlap.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam Src    Mdspan type of the source.
+/// \tparam Dst    Mdspan type of the destination, of the same rank.
+/// \tparam R      Rank.
+/// \param policy Execution policy.
+/// \param alpha  Scale factor of the source.
+/// \param src    Tensor to permute.
+/// \param perm   Permutation: axis \c k of \p dst has the extent of, and is indexed like, axis \c perm[k] of \p src.
+/// \param beta   Scale factor of the previous contents of \p dst.
+/// \param dst    Destination view.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan Src, MutableStridedMdspan Dst, std::size_t R>
+void permute(Policy const& policy, typename Dst::value_type alpha, Src const& src,
+             std::array<std::size_t, R> const& perm, typename Dst::value_type beta, Dst dst)
+{
+  using V = typename Dst::value_type;
+  auto aligned = detail::permute_source(src, perm, dst);
+  if (dst.size() == 0) return;
+
+  auto out = detail::as_dynamic_strided(dst);
+  if (beta != V{})
+    detail::permute_aligned(policy, aligned, out,
+                            simd::simd_op{[alpha, beta](auto const& d, auto const& x) {
+                              return alpha * x + beta * d;
+                            }});
+  else if (alpha != V(1))
+    detail::permute_aligned(policy, aligned, out,
+                            simd::simd_op{[alpha](auto const&, auto const& x) { return alpha * x; }});
+  else
+    detail::permute_aligned(policy, aligned, out, simd::simd_op{[](auto const&, auto const& x) { return x; }});
+}
+
+/// \brief Permute the axes of a tensor into \p dst: dst[i...] = src[j...], where axis \c k of \p dst is axis
+///        \c perm[k] of \p src.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan Src, MutableStridedMdspan Dst, std::size_t R>
+void permute(Policy const& policy, Src const& src, std::array<std::size_t, R> const& perm, Dst dst)
+{
+  using V = typename Dst::value_type;
+  uni20::permute(policy, V(1), src, perm, V{}, dst);
+}
+
+/// \brief Permute the axes of a tensor into \p dst, serially.
+/// \ingroup level1_ops
+template <StridedMdspan Src, MutableStridedMdspan Dst, std::size_t R>
+void permute(Src const& src, std::array<std::size_t, R> const& perm, Dst dst)
+{
+  uni20::permute(seq, src, perm, dst);
+}
+
+/// \brief Scaled permutation dst = alpha·permute(src) + beta·dst, serially.
+/// \ingroup level1_ops
+template <StridedMdspan Src, MutableStridedMdspan Dst, std::size_t R>
+void permute(typename Dst::value_type alpha, Src const& src, std::array<std::size_t, R> const& perm,
+             typename Dst::value_type beta, Dst dst)
+{
+  uni20::permute(seq, alpha, src, perm, beta, dst);
+}
+
+} // namespace uni20
@@ -0,0 +1,362 @@
+#pragma once
+
+/**
+ * \file reduce.hpp
+ * \ingroup level1_ops
+ * \brief Reductions of strided mdspan views to a scalar: reduce, dot, vdot, norm2 and norm_inf.
+ * \details The elements are visited in the order of the merged iteration plan and summed pairwise: the
+ *          flattened index range is halved recursively down to leaves of detail::reduce_leaf_size elements, and
+ *          each leaf is accumulated over detail::reduce_lanes independent lanes that the compiler can keep in SIMD
+ *          registers. The rounding error grows with the logarithm of the size rather than linearly.
+ *
+ *          The shape of the summation tree depends only on the extents and strides of the operands. The parallel
+ *          overloads evaluate the subtrees of the same tree concurrently, so the result is bitwise identical to
+ *          the serial one for any number of threads.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/core/math.hpp>
+#include <uni20/core/types.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/mdspan/concepts.hpp>
+#include <uni20/mdspan/iteration_plan.hpp>
+
+#include <oneapi/tbb/parallel_invoke.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+namespace uni20
+{
+
+namespace detail
+{
+
+/// \brief Number of elements at the leaves of the pairwise summation tree.
+/// \ingroup internal
+inline constexpr index_type reduce_leaf_size = 256;
+
+/// \brief Number of independent accumulators within a leaf.
+/// \ingroup internal
+inline constexpr std::size_t reduce_lanes = 8;
+
+/// \brief Pairwise reduction of map(a[i], b[i], ...) over spans of identical extents.
+/// \tparam R       Accumulator type.
+/// \tparam Combine Associative binary functor on \p R.
+/// \tparam Map     Functor taking one element of each span and returning an \p R.
+/// \tparam Spans   StridedMdspan types of the operands.
+/// \ingroup internal
+template <typename R, typename Combine, typename Map, StridedMdspan... Spans> class PairwiseReducer
+{
+  public:
+    static constexpr std::size_t num_spans = sizeof...(Spans);
+
+    /// \brief Prepare a reduction over \p spans.
+    /// \param identity Identity element of \p combine.
+    /// \param combine  Functor that combines two partial results.
+    /// \param map      Functor applied to each tuple of elements.
+    /// \param spans    Operands of identical extents.
+    PairwiseReducer(R identity, Combine combine, Map map, Spans const&... spans)
+        : dh_{spans.data_handle()...}, accs_{spans.accessor()...}, identity_(identity), combine_(combine), map_(map)
+    {
+      auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{dynamic_stride_mapping(spans)...});
+      plan_ = plan;
+      offsets_ = offsets;
+      size_ = std::min({index_type(spans.size())...});
+    }
+
+    /// \brief Reduce in the calling thread.
+    R operator()() const { return this->evaluate(std::numeric_limits<index_type>::max()); }
+
+    /// \brief Reduce, running the subtrees of ranges larger than \c policy.min_size concurrently.
+    R operator()(parallel_policy const& policy) const
+    {
+      R result = identity_;
+      execute_in(policy, [&] { result = this->evaluate(std::max<index_type>(index_type(policy.min_size), 1)); });
+      return result;
+    }
+
+  private:
+    using plan_type = decltype(make_multi_iteration_plan_with_offset(
+                                   std::array{dynamic_stride_mapping(std::declval<Spans const&>())...})
+                                   .first);
+    using offset_type = std::array<index_type, num_spans>;
+
+    std::tuple<typename Spans::data_handle_type...> dh_;
+    std::tuple<typename Spans::accessor_type...> accs_;
+    R identity_;
+    Combine combine_;
+    Map map_;
+    plan_type plan_;
+    offset_type offsets_{};
+    index_type size_ = 0;
+
+    R evaluate(index_type parallel_cutoff) const
+    {
+      if (size_ == 0) return identity_;
+      if (plan_.empty()) return this->element(offsets_, 0, offset_type{});
+      return this->tree(0, size_, parallel_cutoff);
+    }
+
+    R element(offset_type const& offsets, index_type i, offset_type const& strides) const
+    {
+      return [&]<std::size_t... I>(std::index_sequence<I...>)
+      {
+        return R(map_(std::get<I>(accs_).access(std::get<I>(dh_), offsets[I] + i * strides[I])...));
+      }
+      (std::make_index_sequence<num_spans>{});
+    }
+
+    R tree(index_type first, index_type last, index_type parallel_cutoff) const
+    {
+      if (last - first <= reduce_leaf_size) return this->leaf(first, last);
+
+      index_type const leaves = (last - first + reduce_leaf_size - 1) / reduce_leaf_size;
+      index_type const mid = first + (leaves / 2) * reduce_leaf_size;
+      R lhs = identity_, rhs = identity_;
+      if (last - first > parallel_cutoff)
+      {
+        oneapi::tbb::parallel_invoke([&] { lhs = this->tree(first, mid, parallel_cutoff); },
+                                     [&] { rhs = this->tree(mid, last, parallel_cutoff); });
+      }
+      else
+      {
+        lhs = this->tree(first, mid, parallel_cutoff);
+        rhs = this->tree(mid, last, parallel_cutoff);
+      }
+      return combine_(lhs, rhs);
+    }
+
+    R leaf(index_type first, index_type last) const
+    {
+      constexpr index_type L = index_type(reduce_lanes);
+      std::size_t const depth = plan_.size();
+      auto const& inner = plan_[depth - 1];
+
+      // Multi-index of `first` in the plan, innermost dimension fastest.
+      std::array<index_type, plan_type::capacity()> idx{};
+      for (index_type rem = first, d = index_type(depth); d-- > 0;)
+      {
+        idx[d] = rem % index_type(plan_[d].extent);
+        rem /= index_type(plan_[d].extent);
+      }
+
+      std::array<R, reduce_lanes> lanes;
+      lanes.fill(identity_);
+
+      for (index_type i = first; i < last;)
+      {
+        offset_type offsets = offsets_;
+        for (std::size_t d = 0; d < depth; ++d)
+          for (std::size_t s = 0; s < num_spans; ++s)
+            offsets[s] += idx[d] * plan_[d].strides[s];
+
+        index_type const len = std::min(last - i, index_type(inner.extent) - idx[depth - 1]);
+        index_type j = 0;
+        for (; j + L <= len; j += L)
+          for (index_type l = 0; l < L; ++l)
+            lanes[l] = combine_(lanes[l], this->element(offsets, j + l, inner.strides));
+        for (; j < len; ++j)
+          lanes[j % L] = combine_(lanes[j % L], this->element(offsets, j, inner.strides));
+
+        i += len;
+        idx[depth - 1] += len;
+        for (std::size_t d = depth - 1; d > 0 && idx[d] == index_type(plan_[d].extent); --d)
+        {
+          idx[d] = 0;
+          ++idx[d - 1];
+        }
+      }
+
+      for (std::size_t w = reduce_lanes / 2; w > 0; w /= 2)
+        for (std::size_t l = 0; l < w; ++l)
+          lanes[l] = combine_(lanes[l], lanes[l + w]);
+      return lanes[0];
+    }
+};
+
+/// \brief Run a pairwise reduction serially.
+/// \ingroup internal
+template <typename R, typename Combine, typename Map, StridedMdspan... Spans>
+R pairwise_reduce(sequenced_policy, R identity, Combine combine, Map map, Spans const&... spans)
+{
+  return PairwiseReducer<R, Combine, Map, Spans...>(identity, combine, map, spans...)();
+}
+
+/// \brief Run a pairwise reduction under a parallel policy.
+/// \ingroup internal
+template <typename R, typename Combine, typename Map, StridedMdspan... Spans>
+R pairwise_reduce(parallel_policy const& policy, R identity, Combine combine, Map map, Spans const&... spans)
+{
+  return PairwiseReducer<R, Combine, Map, Spans...>(identity, combine, map, spans...)(policy);
+}
+
+/// \brief Functor returning its argument unchanged.
+/// \ingroup internal
+struct reduce_identity_map
+{
+    template <typename T> constexpr T operator()(T const& x) const { return x; }
+};
+
+/// \brief Functor returning the larger of two values.
+/// \ingroup internal
+struct reduce_max
+{
+    template <typename T> constexpr T operator()(T const& x, T const& y) const { return x < y ? y : x; }
+};
+
+/// \brief Partial sum of squares scale²·ssq, held relative to the largest magnitude seen so far so that it
+///        neither overflows nor underflows, as in LAPACK's `xLASSQ`.
+/// \ingroup internal
+template <typename T> struct scaled_ssq
+{
+    T scale = 0; ///< Largest magnitude in the partial sum.
+    T ssq = 0;   ///< Sum of the squares of the magnitudes divided by \c scale.
+};
+
+/// \brief Merge two scaled_ssq partial sums, rescaling the smaller one to the larger scale.
+/// \ingroup internal
+struct scaled_ssq_combine
+{
+    template <typename T> scaled_ssq<T> operator()(scaled_ssq<T> a, scaled_ssq<T> b) const
+    {
+      if (a.scale < b.scale) std::swap(a, b);
+      if (b.scale == T(0)) return a;
+      T const r = b.scale == a.scale ? T(1) : b.scale / a.scale; // equal infinities give 1, not NaN
+      return {a.scale, a.ssq + b.ssq * r * r};
+    }
+};
+
+/// \brief Real type of the absolute value of an element of \p MDS.
+/// \ingroup internal
+template <typename MDS> using abs_t = decltype(std::abs(std::declval<typename MDS::value_type>()));
+
+} // namespace detail
+
+/// \brief Reduce the elements of \p a with an associative operation, summed pairwise.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam MDS    Mdspan type that models StridedMdspan.
+/// \tparam T      Result type.
+/// \tparam Op     Associative binary functor on \p T.
+/// \param policy   Execution policy.
+/// \param a        Span to reduce.
+/// \param identity Identity element of \p op, returned for an empty span.
+/// \param op       Functor that combines two partial results.
+/// \return The reduction of all elements of \p a.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan MDS, typename T, typename Op>
+T reduce(Policy const& policy, MDS const& a, T identity, Op op)
+{
+  return detail::pairwise_reduce(policy, identity, op, detail::reduce_identity_map{}, a);
+}
+
+/// \brief Reduce the elements of \p a with an associative operation, serially.
+/// \ingroup level1_ops
+template <StridedMdspan MDS, typename T, typename Op> T reduce(MDS const& a, T identity, Op op)
+{
+  return uni20::reduce(seq, a, identity, op);
+}
+
+/// \brief Sum of the elements of \p a.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan MDS> auto reduce(Policy const& policy, MDS const& a)
+{
+  using T = typename MDS::value_type;
+  return uni20::reduce(policy, a, T{}, std::plus<T>{});
+}
+
+/// \brief Sum of the elements of \p a, computed serially.
+/// \ingroup level1_ops
+template <StridedMdspan MDS> auto reduce(MDS const& a) { return uni20::reduce(seq, a); }
+
+/// \brief Bilinear dot product sum(a[i] * b[i]), without complex conjugation.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam A      Mdspan type of the first operand.
+/// \tparam B      Mdspan type of the second operand.
+/// \param policy Execution policy.
+/// \param a      First operand.
+/// \param b      Second operand, with the extents of \p a.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan A, StridedMdspan B> auto dot(Policy const& policy, A const& a, B const& b)
+{
+  static_assert(A::rank() == B::rank(), "dot: rank mismatch");
+  PRECONDITION_EQUAL(a.extents(), b.extents(), "dot: shape mismatch");
+  using T = decltype(std::declval<typename A::value_type>() * std::declval<typename B::value_type>());
+  return detail::pairwise_reduce(
+      policy, T{}, std::plus<T>{}, [](auto const& x, auto const& y) { return x * y; }, a, b);
+}
+
+/// \brief Bilinear dot product sum(a[i] * b[i]), computed serially.
+/// \ingroup level1_ops
+template <StridedMdspan A, StridedMdspan B> auto dot(A const& a, B const& b) { return uni20::dot(seq, a, b); }
+
+/// \brief Inner product sum(conj(a[i]) * b[i]), conjugating the first operand.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam A      Mdspan type of the first operand.
+/// \tparam B      Mdspan type of the second operand.
+/// \param policy Execution policy.
+/// \param a      First operand, conjugated.
+/// \param b      Second operand, with the extents of \p a.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan A, StridedMdspan B> auto vdot(Policy const& policy, A const& a, B const& b)
+{
+  static_assert(A::rank() == B::rank(), "vdot: rank mismatch");
+  PRECONDITION_EQUAL(a.extents(), b.extents(), "vdot: shape mismatch");
+  using T = decltype(uni20::conj(std::declval<typename A::value_type>()) * std::declval<typename B::value_type>());
+  return detail::pairwise_reduce(
+      policy, T{}, std::plus<T>{}, [](auto const& x, auto const& y) { return uni20::conj(x) * y; }, a, b);
+}
+
+/// \brief Inner product sum(conj(a[i]) * b[i]), computed serially.
+/// \ingroup level1_ops
+template <StridedMdspan A, StridedMdspan B> auto vdot(A const& a, B const& b) { return uni20::vdot(seq, a, b); }
+
+/// \brief Euclidean (Frobenius) norm sqrt(sum |a[i]|²).
+/// \details Each leaf accumulates a scaled sum of squares and the leaves are merged pairwise, so the result does
+///          not overflow or underflow unless the norm itself does.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam MDS    Mdspan type that models StridedMdspan.
+/// \param policy Execution policy.
+/// \param a      Span whose norm is computed.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan MDS> auto norm2(Policy const& policy, MDS const& a)
+{
+  using T = detail::abs_t<MDS>;
+  using std::sqrt;
+  auto const sum = detail::pairwise_reduce(
+      policy, detail::scaled_ssq<T>{}, detail::scaled_ssq_combine{},
+      [](auto const& x) { return detail::scaled_ssq<T>{T(std::abs(x)), T(1)}; }, a);
+  return sum.scale * sqrt(sum.ssq);
+}
+
+/// \brief Euclidean (Frobenius) norm sqrt(sum |a[i]|²), computed serially.
+/// \ingroup level1_ops
+template <StridedMdspan MDS> auto norm2(MDS const& a) { return uni20::norm2(seq, a); }
+
+/// \brief Maximum norm max |a[i]|, or zero for an empty span.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam MDS    Mdspan type that models StridedMdspan.
+/// \param policy Execution policy.
+/// \param a      Span whose norm is computed.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan MDS> auto norm_inf(Policy const& policy, MDS const& a)
+{
+  using T = detail::abs_t<MDS>;
+  return detail::pairwise_reduce(
+      policy, T{}, detail::reduce_max{}, [](auto const& x) { return T(std::abs(x)); }, a);
+}
+
+/// \brief Maximum norm max |a[i]|, computed serially.
+/// \ingroup level1_ops
+template <StridedMdspan MDS> auto norm_inf(MDS const& a) { return uni20::norm_inf(seq, a); }
+
+} // namespace uni20
@@ -0,0 +1,194 @@
+#pragma once
+
+/**
+ * \file reduce_axes.hpp
+ * \ingroup level1_ops
+ * \brief Sums over selected axes and partial traces of a strided tensor into a lower-rank output view.
+ * \details Both kernels read the input in place through a reduction_plan; nothing is permuted or copied. If the
+ *          smallest input stride belongs to a kept dimension, the output is zeroed and every slice of the input at
+ *          a fixed reduced index is added into it, streaming both with unit stride. Otherwise each output element
+ *          is accumulated in a register over the reduced dimensions and written once.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/mdspan/concepts.hpp>
+#include <uni20/mdspan/iteration_plan.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+namespace uni20
+{
+
+namespace detail
+{
+
+/// \brief Reduce \p a into \p out, given the label of each dimension of \p a as for
+///        make_reduction_plan_with_offset().
+/// \ingroup internal
+template <ExecutionPolicy Policy, StridedMdspan A, MutableStridedMdspan Out>
+void reduce_legs(Policy const& policy, A const& a, std::array<std::ptrdiff_t, A::rank()> const& legs, Out out)
+{
+  using index_type = std::ptrdiff_t;
+  using value_type = typename Out::value_type;
+
+  if (out.size() == 0) return;
+
+  auto const plan = make_reduction_plan_with_offset(out.mapping(), a.mapping(), legs);
+
+  index_type reduced_size = 1;
+  index_type min_reduced = std::numeric_limits<index_type>::max();
+  for (auto const& dim : plan.reduced)
+  {
+    reduced_size *= dim.extent;
+    min_reduced = std::min(min_reduced, std::abs(dim.strides[0]));
+  }
+  index_type min_kept = std::numeric_limits<index_type>::max();
+  for (auto const& dim : plan.kept)
+    min_kept = std::min(min_kept, std::abs(dim.strides[1]));
+  bool const stream = reduced_size > 0 && min_kept < min_reduced;
+
+  auto out_dh = out.data_handle();
+  auto out_acc = out.accessor();
+  auto a_dh = a.data_handle();
+  auto a_acc = a.accessor();
+
+  auto run = [&](auto const& kept, std::array<index_type, 2> offsets) {
+    if (stream)
+    {
+      MultiUnrollHelper zero{simd::simd_op{[](auto o, auto) { return decltype(o){}; }}, out, a};
+      zero.run(kept, offsets);
+      MultiUnrollHelper add{simd::simd_op{[](auto o, auto x) { return o + x; }}, out, a};
+      for_each_offset(plan.reduced, std::array<index_type, 1>{0},
+                      [&](auto const& r) { add.run(kept, {offsets[0], offsets[1] + r[0]}); });
+      return;
+    }
+    for_each_offset(kept, offsets, [&](auto const& o) {
+      value_type sum{};
+      for_each_offset(plan.reduced, std::array<index_type, 1>{o[1]},
+                      [&](auto const& r) { sum += a_acc.access(a_dh, r[0]); });
+      out_acc.access(out_dh, o[0]) = sum;
+    });
+  };
+
+  if constexpr (std::is_same_v<Policy, parallel_policy>)
+  {
+    if (!plan.kept.empty())
+    {
+      // the threshold counts input elements, so scale it down by the work per output element
+      auto const scaled = policy.with_min_size(policy.min_size / std::size_t(std::max<index_type>(reduced_size, 1)));
+      parallel_plan_for(scaled, plan.kept, plan.offsets, run);
+      return;
+    }
+  }
+  run(plan.kept, plan.offsets);
+}
+
+} // namespace detail
+
+/// \brief Sum a tensor over the given axes: out[kept...] = Σ a[...], with the remaining axes of \p a mapped to
+///        the axes of \p out in order.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam A      Mdspan type of the input.
+/// \tparam Out    Mdspan type of the output, of rank A::rank() - K.
+/// \tparam K      Number of summed axes.
+/// \param policy Execution policy.
+/// \param a      Tensor to reduce.
+/// \param axes   Distinct axes of \p a to sum over.
+/// \param out    Output view, overwritten with the sums.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan A, MutableStridedMdspan Out, std::size_t K>
+void reduce_axes(Policy const& policy, A const& a, std::array<std::size_t, K> const& axes, Out out)
+{
+  static_assert(Out::rank() + K == A::rank(), "reduce_axes: output rank must be the input rank less the summed axes");
+
+  std::array<std::ptrdiff_t, A::rank()> legs;
+  legs.fill(0);
+  for (std::size_t k = 0; k < K; ++k)
+  {
+    PRECONDITION(axes[k] < A::rank(), "reduce_axes: axis out of range", axes[k]);
+    PRECONDITION(legs[axes[k]] == 0, "reduce_axes: repeated axis", axes[k]);
+    legs[axes[k]] = -1 - std::ptrdiff_t(k);
+  }
+  std::ptrdiff_t next = 0;
+  for (std::size_t i = 0; i < A::rank(); ++i)
+  {
+    if (legs[i] < 0) continue;
+    PRECONDITION_EQUAL(a.extent(i), out.extent(std::size_t(next)), "reduce_axes: shape mismatch");
+    legs[i] = next++;
+  }
+
+  detail::reduce_legs(policy, a, legs, out);
+}
+
+/// \brief Sum a tensor over the given axes, serially.
+/// \ingroup level1_ops
+template <StridedMdspan A, MutableStridedMdspan Out, std::size_t K>
+void reduce_axes(A const& a, std::array<std::size_t, K> const& axes, Out out)
+{
+  uni20::reduce_axes(seq, a, axes, out);
+}
+
+/// \brief Partial trace over pairs of axes: out[kept...] = Σ_i a[..., i, ..., i, ...] for each pair, with the
+///        remaining axes of \p a mapped to the axes of \p out in order.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \tparam A      Mdspan type of the input.
+/// \tparam Out    Mdspan type of the output, of rank A::rank() - 2P.
+/// \tparam P      Number of traced pairs.
+/// \param policy Execution policy.
+/// \param a      Tensor to trace.
+/// \param pairs  Pairs of axes of equal extent to contract with each other; all axes must be distinct.
+/// \param out    Output view, overwritten with the traces.
+/// \ingroup level1_ops
+template <ExecutionPolicy Policy, StridedMdspan A, MutableStridedMdspan Out, std::size_t P>
+void partial_trace(Policy const& policy, A const& a, std::array<std::array<std::size_t, 2>, P> const& pairs, Out out)
+{
+  static_assert(Out::rank() + 2 * P == A::rank(),
+                "partial_trace: output rank must be the input rank less two per traced pair");
+
+  std::array<std::ptrdiff_t, A::rank()> legs;
+  legs.fill(0);
+  for (std::size_t p = 0; p < P; ++p)
+  {
+    for (std::size_t axis : pairs[p])
+    {
+      PRECONDITION(axis < A::rank(), "partial_trace: axis out of range", axis);
+      PRECONDITION(legs[axis] == 0, "partial_trace: repeated axis", axis);
+      legs[axis] = -1 - std::ptrdiff_t(p);
+    }
+    PRECONDITION_EQUAL(a.extent(pairs[p][0]), a.extent(pairs[p][1]), "partial_trace: traced axes differ in extent");
+  }
+  std::ptrdiff_t next = 0;
+  for (std::size_t i = 0; i < A::rank(); ++i)
+  {
+    if (legs[i] < 0) continue;
+    PRECONDITION_EQUAL(a.extent(i), out.extent(std::size_t(next)), "partial_trace: shape mismatch");
+    legs[i] = next++;
+  }
+
+  detail::reduce_legs(policy, a, legs, out);
+}
+
+/// \brief Partial trace over pairs of axes, serially.
+/// \ingroup level1_ops
+template <StridedMdspan A, MutableStridedMdspan Out, std::size_t P>
+void partial_trace(A const& a, std::array<std::array<std::size_t, 2>, P> const& pairs, Out out)
+{
+  uni20::partial_trace(seq, a, pairs, out);
+}
+
+/// \brief Partial trace over the single pair of axes \p axis1 and \p axis2, serially.
+/// \ingroup level1_ops
+template <StridedMdspan A, MutableStridedMdspan Out>
+void partial_trace(A const& a, std::size_t axis1, std::size_t axis2, Out out)
+{
+  uni20::partial_trace(seq, a, std::array<std::array<std::size_t, 2>, 1>{{{axis1, axis2}}}, out);
+}
+
+} // namespace uni20
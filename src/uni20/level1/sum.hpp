@@ -35,6 +35,9 @@ template <StridedMdspan... Spans> struct SumAccessor
     // True element type (handles proxy references)
     using element_type = uni20::remove_proxy_reference_t<reference>;
 
+    /// \brief Alias so mdspan sees this as its offset_policy.
+    using offset_policy = SumAccessor;
+
     /// \brief Store each span's accessor instance.
     /// \param accs Accessor objects sourced from each input span.
     /// \ingroup internal
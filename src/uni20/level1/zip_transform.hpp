@@ -75,6 +75,17 @@ struct TransformAccessor : private Func // EBO if Func is empty
       return access_impl(handles, rel, std::make_index_sequence<sizeof...(Spans)>{});
     }
 
+    /// \brief Access the stored functor.
+    /// \ingroup internal
+    [[nodiscard]] constexpr Func const& func() const noexcept { return static_cast<Func const&>(*this); }
+
+    /// \brief Access the tuple of child accessors.
+    /// \ingroup internal
+    [[nodiscard]] constexpr accessor_tuple const& get_accessors() const noexcept
+    {
+      return static_cast<accessor_tuple const&>(*this);
+    }
+
   private:
     /// \brief Helper: call each child.offset() and bundle new handles.
     /// \ingroup internal
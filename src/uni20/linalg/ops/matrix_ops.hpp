@@ -2,6 +2,7 @@
 
 #include <uni20/core/types.hpp>
 #include <uni20/linalg/backend_manifest.hpp>
+#include <uni20/storage/buffer_pool.hpp>
 #include <uni20/storage/vectorstorage.hpp>
 #include <uni20/tensor/basic_tensor.hpp>
 #include <uni20/tensor/tensor_view.hpp>
@@ -294,9 +295,11 @@ void matrix_power_into(TensorView<T const, MatTraits> mat, unsigned int power, T
   }
 
   using value_type = detail::value_type_t<decltype(mat)>;
-  using tensor_type = uni20::BasicTensor<value_type, stdex::dextents<index_type, 2>, VectorStorage>;
+  // The three work matrices are fully overwritten before they are read, and repeated calls of the same size reuse
+  // their blocks from the pool.
+  using tensor_type = uni20::BasicTensor<value_type, stdex::dextents<index_type, 2>, PooledStorage>;
 
-  tensor_type result(detail::make_extents(mat));
+  tensor_type result(uninitialized, detail::make_extents(mat));
   ::uni20::linalg::fill_identity(result.view(), tag);
 
   if (power == 0U)
@@ -305,8 +308,9 @@ void matrix_power_into(TensorView<T const, MatTraits> mat, unsigned int power, T
     return;
   }
 
-  tensor_type base = detail::clone(mat, tag);
-  tensor_type scratch(detail::make_extents(mat));
+  tensor_type base(uninitialized, detail::make_extents(mat));
+  ::uni20::linalg::copy(mat, base.view(), tag);
+  tensor_type scratch(uninitialized, detail::make_extents(mat));
 
   unsigned int exponent = power;
   while (exponent > 0U)
@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * \file broadcast.hpp
+ * \ingroup mdspan_ext
+ * \brief Broadcast views of strided mdspans, which repeat the elements of a tensor along extra or unit axes.
+ * \details A broadcast axis has stride 0, so every index along it addresses the same elements and nothing is
+ *          copied. The iteration plans treat such an axis as free for the broadcast operand, so a loop over it is
+ *          placed inside the loops that it does move through and the operand is loaded once per inner loop; see
+ *          iteration_plan.hpp. A broadcast view must only be read: writing through it updates the same element
+ *          many times.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/mdspan/concepts.hpp>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace uni20
+{
+
+/// \brief Layout_stride mapping that broadcasts \p mapping to the extents \p extents.
+/// \details Following the numpy rules, the axes are aligned at the right; each axis of \p mapping must have the
+///          extent of the axis it is aligned with, or extent 1, in which case it is repeated with stride 0. The
+///          leading axes of \p extents that \p mapping does not have are also repeated with stride 0.
+/// \tparam Mapping    Strided layout mapping of the source.
+/// \tparam NewExtents Extents type of the result, of at least the rank of the source.
+/// \ingroup mdspan_ext
+template <typename Mapping, typename NewExtents>
+auto broadcast_mapping(Mapping const& mapping, NewExtents const& extents)
+{
+  constexpr std::size_t R = Mapping::extents_type::rank();
+  constexpr std::size_t N = NewExtents::rank();
+  static_assert(N >= R, "broadcast_to: cannot broadcast to a lower rank");
+
+  using index_type = typename NewExtents::index_type;
+  std::array<index_type, N> strides{};
+  for (std::size_t r = 0; r < R; ++r)
+  {
+    std::size_t const d = N - R + r;
+    auto const old_extent = index_type(mapping.extents().extent(r));
+    PRECONDITION(old_extent == extents.extent(d) || old_extent == 1, "broadcast_to: incompatible extents", r,
+                 old_extent, extents.extent(d));
+    strides[d] = old_extent == extents.extent(d) ? index_type(mapping.stride(r)) : index_type(0);
+  }
+  return stdex::layout_stride::mapping<NewExtents>(extents, strides);
+}
+
+/// \brief View of \p s broadcast to the extents \p extents.
+/// \details No element is copied; see broadcast_mapping() for the rules. With the default accessor the elements of
+///          the view are const; any other accessor is kept as it is.
+/// \param s       Strided mdspan to broadcast.
+/// \param extents Extents of the result.
+/// \return Mdspan of the same elements, with layout_stride and stride 0 along every broadcast axis.
+/// \ingroup mdspan_ext
+template <StridedMdspan S, typename NewExtents> auto broadcast_to(S const& s, NewExtents const& extents)
+{
+  using element_type = typename S::element_type const;
+  using accessor_type = stdex::default_accessor<element_type>;
+  if constexpr (std::is_same_v<typename S::accessor_type, stdex::default_accessor<typename S::element_type>>)
+  {
+    return stdex::mdspan<element_type, NewExtents, stdex::layout_stride, accessor_type>(
+        s.data_handle(), broadcast_mapping(s.mapping(), extents));
+  }
+  else
+  {
+    return stdex::mdspan<typename S::element_type, NewExtents, stdex::layout_stride, typename S::accessor_type>(
+        s.data_handle(), broadcast_mapping(s.mapping(), extents), s.accessor());
+  }
+}
+
+} // namespace uni20
@@ -7,6 +7,7 @@
  */
 
 #include <uni20/common/static_vector.hpp>
+#include <uni20/core/simd.hpp>
 #include <uni20/mdspan/concepts.hpp>
 #include <uni20/mdspan/strides.hpp>
 
@@ -107,13 +108,22 @@ template <typename Mapping> auto make_iteration_plan_with_offset(Mapping const&
 }
 
 /// \brief Build a merged iteration plan for multiple tensors sharing the same extents.
+/// \details The loop order is chosen by a cost model: each dimension is weighted by the number of bytes that one
+///          step along it moves through memory, summed over all tensors, and dimensions are nested from the
+///          heaviest outermost to the lightest innermost. Ties are broken by the stride of the first tensor.
+///          Adjacent dimensions that are contiguous in every tensor are then merged. Strides are flipped so that
+///          the first tensor has no negative stride. A tensor broadcast along a dimension has stride 0 there, which
+///          adds nothing to the cost, so broadcast dimensions move inward and the operand is reused across the
+///          innermost loop; a zero stride only merges with another zero stride of the same tensor.
 /// \tparam Mapping Layout mapping type modelling the mdspan mapping interface.
 /// \tparam N       Number of tensors participating in the iteration.
-/// \param mappings Array of mappings, one per tensor.
+/// \param mappings      Array of mappings, one per tensor.
+/// \param element_sizes Size in bytes of the elements of each tensor.
 /// \return Pair of the merged plan and the per-tensor offset corrections.
 /// \ingroup internal
 template <typename Mapping, std::size_t N>
-auto make_multi_iteration_plan_with_offset(std::array<Mapping, N> const& mappings)
+auto make_multi_iteration_plan_with_offset(std::array<Mapping, N> const& mappings,
+                                           std::array<std::size_t, N> const& element_sizes)
 {
   using size_type = typename Mapping::size_type;
   using index_type = typename Mapping::index_type;
@@ -159,18 +169,259 @@ auto make_multi_iteration_plan_with_offset(std::array<Mapping, N> const& mapping
 
   if (raw_plan.empty()) return std::pair{raw_plan, offsets};
 
-  std::sort(raw_plan.begin(), raw_plan.end(),
-            [](auto const& lhs, auto const& rhs) { return std::abs(lhs.strides[0]) > std::abs(rhs.strides[0]); });
-
-  merge_strides_right(raw_plan);
+  auto const cost = [&](extent_strides<N> const& dim) {
+    std::size_t bytes = 0;
+    for (std::size_t k = 0; k < N; ++k)
+      bytes += std::size_t(std::abs(dim.strides[k])) * element_sizes[k];
+    return bytes;
+  };
+  std::stable_sort(raw_plan.begin(), raw_plan.end(), [&](auto const& lhs, auto const& rhs) {
+    auto const lhs_cost = cost(lhs);
+    auto const rhs_cost = cost(rhs);
+    if (lhs_cost != rhs_cost) return lhs_cost > rhs_cost;
+    return std::abs(lhs.strides[0]) > std::abs(rhs.strides[0]);
+  });
+
+  detail::merge_adjacent_right(raw_plan);
 
   return std::pair{raw_plan, offsets};
 }
 
+/// \brief Build a merged iteration plan for multiple tensors sharing the same extents, weighting every tensor
+///        equally.
+/// \tparam Mapping Layout mapping type modelling the mdspan mapping interface.
+/// \tparam N       Number of tensors participating in the iteration.
+/// \param mappings Array of mappings, one per tensor.
+/// \return Pair of the merged plan and the per-tensor offset corrections.
+/// \ingroup internal
+template <typename Mapping, std::size_t N>
+auto make_multi_iteration_plan_with_offset(std::array<Mapping, N> const& mappings)
+{
+  std::array<std::size_t, N> element_sizes;
+  element_sizes.fill(1);
+  return make_multi_iteration_plan_with_offset(mappings, element_sizes);
+}
+
+/// \brief Iteration plan for a reduction of a tensor A into a lower-rank output tensor.
+/// \details The kept dimensions carry strides {output, A} and are ordered by decreasing output stride, so the
+///          innermost kept loop walks the output with its smallest stride. The reduced dimensions carry the stride
+///          of A alone and are ordered by decreasing A stride. A reduced dimension of extent zero appears as a
+///          single dimension of extent zero.
+/// \tparam RA Rank of A.
+/// \ingroup internal
+template <std::size_t RA> struct reduction_plan
+{
+    static_vector<extent_strides<2>, RA> kept;    ///< Dimensions shared by the output and A.
+    static_vector<extent_strides<1>, RA> reduced; ///< Dimensions of A summed over.
+    std::array<std::ptrdiff_t, 2> offsets{};      ///< Offsets of the first element in {output, A}.
+};
+
+/// \brief Build the iteration plan of a reduction of A into an output tensor.
+/// \details \p legs labels each dimension of A: a non-negative label is the output dimension it maps to, and a
+///          negative label marks a reduced dimension. Dimensions of A that share a negative label are traced
+///          together, i.e. summed along their common diagonal, which becomes one reduced dimension whose stride is
+///          the sum of their strides. The output must be non-empty, each output dimension must be labelled
+///          exactly once, and labelled dimensions must have matching extents.
+/// \tparam OutMapping Layout mapping of the output.
+/// \tparam AMapping   Layout mapping of A.
+/// \param out  Mapping of the output tensor.
+/// \param a    Mapping of the reduced tensor.
+/// \param legs Label of each dimension of A.
+/// \return The plan, with the kept and reduced dimensions separated.
+/// \ingroup internal
+template <typename OutMapping, typename AMapping>
+auto make_reduction_plan_with_offset(OutMapping const& out, AMapping const& a,
+                                     std::array<std::ptrdiff_t, AMapping::extents_type::rank()> const& legs)
+{
+  using index_type = std::ptrdiff_t;
+  static constexpr std::size_t RA = AMapping::extents_type::rank();
+
+  reduction_plan<RA> plan;
+
+  for (std::size_t i = 0; i < RA; ++i)
+  {
+    index_type const extent = a.extents().extent(i);
+    if (legs[i] >= 0)
+    {
+      std::array<index_type, 2> strides{index_type(out.stride(std::size_t(legs[i]))), index_type(a.stride(i))};
+      if (extent == 1) continue;
+      if (strides[0] < 0)
+      {
+        for (std::size_t s = 0; s < 2; ++s)
+        {
+          plan.offsets[s] += strides[s] * (extent - 1);
+          strides[s] = -strides[s];
+        }
+      }
+      plan.kept.push_back(extent_strides<2>(extent, strides));
+      continue;
+    }
+
+    // first dimension with this label: gather the diagonal
+    if (std::find(legs.begin(), legs.begin() + i, legs[i]) != legs.begin() + i) continue;
+    index_type stride = 0;
+    for (std::size_t j = i; j < RA; ++j)
+      if (legs[j] == legs[i]) stride += a.stride(j);
+    if (extent == 0)
+    {
+      plan.reduced.clear();
+      plan.reduced.push_back(extent_strides<1>(0, {0}));
+      break;
+    }
+    if (stride < 0)
+    {
+      plan.offsets[1] += stride * (extent - 1);
+      stride = -stride;
+    }
+    plan.reduced.push_back(extent_strides<1>(extent, {stride}));
+  }
+
+  if (plan.reduced.size() != 1 || plan.reduced[0].extent != 0) merge_strides_right(plan.reduced);
+  merge_strides_right(plan.kept);
+
+  return plan;
+}
+
 namespace detail
 {
 
+/// \brief Invoke \p f with the offsets of every element visited by \p plan, outermost dimension slowest.
+/// \details An empty plan visits the single element at \p offsets.
+/// \tparam N Number of tensors tracked by the plan.
+/// \tparam R Capacity of the plan.
+/// \tparam F Callable invoked as `f(std::array<std::ptrdiff_t, N> const&)`.
+/// \ingroup internal
+template <std::size_t N, std::size_t R, typename F>
+void for_each_offset(static_vector<extent_strides<N>, R> const& plan, std::array<std::ptrdiff_t, N> offsets, F&& f,
+                     std::size_t depth = 0)
+{
+  if (depth == plan.size())
+  {
+    f(std::as_const(offsets));
+    return;
+  }
+  auto const& dim = plan[depth];
+  for (std::ptrdiff_t i = 0; i < dim.extent; ++i)
+  {
+    detail::for_each_offset(plan, offsets, f, depth + 1);
+    for (std::size_t s = 0; s < N; ++s)
+      offsets[s] += dim.strides[s];
+  }
+}
+
+/// \brief Working set, in bytes, that one tile of the two innermost loops of a plan is sized to fit.
+/// \ingroup internal
+inline constexpr std::size_t tile_cache_bytes = std::size_t(1) << 15;
+
+/// \brief Cache line size assumed when deciding whether a strided innermost loop needs tiling.
+/// \ingroup internal
+inline constexpr std::size_t cache_line_bytes = 64;
+
+/// \brief Working set, in bytes, of the two innermost loops below which a plan is left untiled, as it is already
+///        cache resident.
+/// \ingroup internal
+inline constexpr std::size_t untiled_cache_bytes = std::size_t(1) << 18;
+
+/// \brief Tile extent for the two innermost loops of \p plan, or 0 if the plan should run untiled.
+/// \details Tiling pays off when some tensor has a smaller stride in the second innermost loop than in the
+///          innermost one, and the innermost loop jumps at least a cache line through that tensor; a transposed
+///          copy is the typical case, unless the two loops together touch less than untiled_cache_bytes. The tile
+///          is the largest power of two whose square, over every tensor, fits in tile_cache_bytes.
+/// \tparam Plan Plan type, a sequence of extent_strides<N> from the outermost to the innermost loop.
+/// \tparam N    Number of tensors tracked by the plan.
+/// \ingroup internal
+template <typename Plan, std::size_t N>
+std::ptrdiff_t plan_tile_extent(Plan const& plan, std::array<std::size_t, N> const& element_sizes)
+{
+  if (plan.size() < 2) return 0;
+  auto const& outer = plan[plan.size() - 2];
+  auto const& inner = plan[plan.size() - 1];
+
+  bool conflict = false;
+  std::size_t bytes = 0;
+  for (std::size_t k = 0; k < N; ++k)
+  {
+    bytes += element_sizes[k];
+    auto const inner_stride = std::size_t(std::abs(inner.strides[k]));
+    // a tensor broadcast along the outer loop rereads the same elements, so it does not ask for a tile
+    conflict |= outer.strides[k] != 0 && std::size_t(std::abs(outer.strides[k])) < inner_stride &&
+                inner_stride * element_sizes[k] >= cache_line_bytes;
+  }
+  if (!conflict || std::size_t(outer.extent * inner.extent) * bytes < untiled_cache_bytes) return 0;
+
+  std::ptrdiff_t tile = 8;
+  while (std::size_t(4 * tile * tile) * bytes <= tile_cache_bytes)
+    tile *= 2;
+  if (outer.extent <= tile && inner.extent <= tile) return 0;
+  return tile;
+}
+
+/// \brief Invoke \p f on tiles of the two innermost loops of \p plan, with the outer loops outermost.
+/// \details \p f is called as `f(sub_plan, sub_offsets)`, where \p sub_plan is a two-dimensional plan over one
+///          tile, of at most \p tile by \p tile elements, and \p sub_offsets are the offsets of its first element.
+/// \tparam Plan Plan type, a sequence of at least two extent_strides<N>.
+/// \tparam N    Number of tensors tracked by the plan.
+/// \ingroup internal
+template <typename Plan, std::size_t N, typename F>
+void for_each_tile(Plan const& plan, std::array<std::ptrdiff_t, N> offsets, std::ptrdiff_t tile, F&& f,
+                   std::size_t depth = 0)
+{
+  if (depth + 2 < plan.size())
+  {
+    auto const& dim = plan[depth];
+    for (std::ptrdiff_t i = 0; i < dim.extent; ++i)
+    {
+      detail::for_each_tile(plan, offsets, tile, f, depth + 1);
+      for (std::size_t s = 0; s < N; ++s)
+        offsets[s] += dim.strides[s];
+    }
+    return;
+  }
+
+  auto const& outer = plan[plan.size() - 2];
+  auto const& inner = plan[plan.size() - 1];
+  static_vector<extent_strides<N>, 2> sub;
+  for (std::ptrdiff_t i = 0; i < outer.extent; i += tile)
+  {
+    for (std::ptrdiff_t j = 0; j < inner.extent; j += tile)
+    {
+      std::array<std::ptrdiff_t, N> sub_offsets = offsets;
+      for (std::size_t s = 0; s < N; ++s)
+        sub_offsets[s] += i * outer.strides[s] + j * inner.strides[s];
+      sub.clear();
+      sub.emplace_back(std::min(tile, outer.extent - i), outer.strides);
+      sub.emplace_back(std::min(tile, inner.extent - j), inner.strides);
+      f(std::as_const(sub), sub_offsets);
+    }
+  }
+}
+
+/// \brief Layout_stride mapping with dynamic extents equivalent to the mapping of \p s.
+/// \details Lets operands with different layout policies share one multi-span iteration plan.
+/// \ingroup internal
+template <StridedMdspan S> auto dynamic_stride_mapping(S const& s)
+{
+  constexpr std::size_t R = S::rank();
+  using index_type = std::ptrdiff_t;
+  using extents_type = stdex::dextents<index_type, R>;
+  std::array<index_type, R> extents{};
+  std::array<index_type, R> strides{};
+  for (std::size_t r = 0; r < R; ++r)
+  {
+    extents[r] = index_type(s.extent(r));
+    strides[r] = index_type(s.mapping().stride(r));
+  }
+  return stdex::layout_stride::mapping<extents_type>(extents_type(extents), strides);
+}
+
+/// \brief True if \p Accessor is the default accessor, whose data handle is a plain pointer to the elements.
+/// \ingroup internal
+template <typename Accessor>
+inline constexpr bool is_default_accessor =
+    std::is_same_v<Accessor, stdex::default_accessor<typename Accessor::element_type>>;
+
 /// \brief Helper that executes nested loops according to a single-span iteration plan.
+/// \details With the default accessor, a unit-stride innermost loop runs through simd::transform_inplace().
 /// \tparam DataHandle Data handle type from the mdspan.
 /// \tparam Accessor   Accessor policy associated with the mdspan.
 /// \tparam Op         Unary callable applied to each element.
@@ -189,6 +440,11 @@ template <typename DataHandle, typename Accessor, typename Op> struct UnrollHelp
       auto const this_stride = plan->stride;
       if (this_stride == 1)
       {
+        if constexpr (is_default_accessor<Accessor>)
+        {
+          simd::transform_inplace(data_ + Offset, idx_t(this_extent), op_);
+          return;
+        }
         for (idx_t i = 0; i < idx_t(this_extent); ++i)
         {
           acc_.access(data_, Offset + i) = op_(acc_.access(data_, Offset + i));
@@ -257,6 +513,10 @@ template <typename DataHandle, typename Accessor, typename Op> struct UnrollHelp
 };
 
 /// \brief Helper to unroll nested loops for multiple tensors of identical extent.
+/// \details When every span uses the default accessor and the innermost plan dimension has unit stride in all of
+///          them, that loop runs through simd::transform(); if some sources are broadcast along it, with stride 0,
+///          it runs through simd::transform_broadcast() instead. When the two innermost loops favour different spans,
+///          as in a transposed copy, they are run in cache-sized tiles; see plan_tile_extent().
 /// \tparam Op        Callable taking N element values and returning the result.
 /// \tparam Spans...  StridedMdspan types that share identical extents and rank.
 /// \ingroup internal
@@ -283,6 +543,25 @@ template <typename Op, StridedMdspan... Spans> struct MultiUnrollHelper
     {}
 
     template <typename Plan> void run(Plan const& plan, offset_type offsets) noexcept
+    {
+      if (std::ptrdiff_t const tile = plan_tile_extent(plan, element_sizes); tile > 0)
+      {
+        for_each_tile(plan, offsets, tile, [this](auto const& sub_plan, offset_type sub_offsets) {
+          this->run_untiled(sub_plan, sub_offsets);
+        });
+        return;
+      }
+      this->run_untiled(plan, offsets);
+    }
+
+  private:
+    static constexpr std::size_t MaxUnrollDepth = 3;
+
+    static constexpr bool all_default_accessors = (is_default_accessor<typename Spans::accessor_type> && ...);
+
+    static constexpr std::array<std::size_t, num_spans> element_sizes{sizeof(typename Spans::element_type)...};
+
+    template <typename Plan> void run_untiled(Plan const& plan, offset_type offsets) noexcept
     {
       std::size_t depth = plan.size() - 1;
       switch (depth)
@@ -302,9 +581,6 @@ template <typename Op, StridedMdspan... Spans> struct MultiUnrollHelper
       }
     }
 
-  private:
-    static constexpr std::size_t MaxUnrollDepth = 3;
-
     void run_dynamic(offset_type offsets, const extent_strides<num_spans>* plan, std::size_t depth) noexcept
     {
       index_type const N = plan->extent;
@@ -330,6 +606,33 @@ template <typename Op, StridedMdspan... Spans> struct MultiUnrollHelper
                       std::integral_constant<std::size_t, 0>) noexcept
     {
       index_type const N = plan->extent;
+      if constexpr (all_default_accessors)
+      {
+        if (std::ranges::all_of(plan->strides, [](index_type s) { return s == 1; }))
+        {
+          [&]<std::size_t... I>(std::index_sequence<I...>)
+          {
+            simd::transform(N, op_, std::get<0>(dh_) + offsets[0], (std::get<I>(dh_) + offsets[I])...);
+          }
+          (std::make_index_sequence<num_spans>{});
+          return;
+        }
+        // broadcast operands, with stride 0, are loaded once for the whole loop
+        if (plan->strides[0] == 1 &&
+            std::ranges::all_of(plan->strides, [](index_type s) { return s == 0 || s == 1; }))
+        {
+          std::array<bool, num_spans> broadcast{};
+          for (std::size_t s = 0; s < num_spans; ++s)
+            broadcast[s] = plan->strides[s] == 0;
+          [&]<std::size_t... I>(std::index_sequence<I...>)
+          {
+            simd::transform_broadcast(N, op_, broadcast, std::get<0>(dh_) + offsets[0],
+                                      (std::get<I>(dh_) + offsets[I])...);
+          }
+          (std::make_index_sequence<num_spans>{});
+          return;
+        }
+      }
       for (index_type i = 0; i < N; ++i)
       {
         [&]<std::size_t... I>(std::index_sequence<I...>)
@@ -124,13 +124,13 @@ template <std::size_t N, std::size_t R> void sort_and_merge_left(static_vector<e
   out.resize(write);
 }
 
-template <std::size_t N, std::size_t R> void sort_and_merge_right(static_vector<extent_strides<N>, R>& out)
+/// \brief Merge each dimension into the next outer one where every stride allows it, keeping the loop order.
+/// \details \p out is ordered from the outermost to the innermost dimension.
+/// \ingroup internal
+template <std::size_t N, std::size_t R> void merge_adjacent_right(static_vector<extent_strides<N>, R>& out)
 {
   if (out.size() <= 1) return;
 
-  std::sort(out.begin(), out.end(),
-            [](auto const& lhs, auto const& rhs) { return std::abs(lhs.strides[0]) > std::abs(rhs.strides[0]); });
-
   extent_strides<N> current = out[0];
   std::size_t write = 0;
   for (std::size_t i = 1; i < out.size(); ++i)
@@ -151,6 +151,16 @@ template <std::size_t N, std::size_t R> void sort_and_merge_right(static_vector<
   out.resize(write);
 }
 
+template <std::size_t N, std::size_t R> void sort_and_merge_right(static_vector<extent_strides<N>, R>& out)
+{
+  if (out.size() <= 1) return;
+
+  std::sort(out.begin(), out.end(),
+            [](auto const& lhs, auto const& rhs) { return std::abs(lhs.strides[0]) > std::abs(rhs.strides[0]); });
+
+  merge_adjacent_right(out);
+}
+
 } // namespace detail
 
 /// \brief Build and merge stride metadata from two stride arrays favouring column-major (left) order.
@@ -282,4 +292,84 @@ auto extract_strides(AType const& A, BType const& B,
   return std::tuple{Mgroup, Ngroup, Kgroup};
 }
 
+/// \brief Extract merged stride groups for a batched tensor contraction.
+/// \details Batch legs appear in A, B and C at once and are neither summed nor broadcast: for every batch index
+///          an independent contraction is performed. The first `NB` legs of C are the batch legs, in the order
+///          of \p batchDims; they are followed by the uncontracted legs of A and then those of B, as for
+///          extract_strides().
+/// \tparam AType Strided mdspan describing the A operand.
+/// \tparam BType Strided mdspan describing the B operand.
+/// \tparam CType Strided mdspan describing the C operand.
+/// \tparam N Number of contraction dimensions.
+/// \tparam NB Number of batch dimensions.
+/// \param A The left operand tensor.
+/// \param B The right operand tensor.
+/// \param contractDims Pairs of contraction indices mapping A to B dimensions.
+/// \param batchDims Pairs of batch indices mapping A to B dimensions.
+/// \param C The output tensor.
+/// \return Tuple of stride descriptors for the batch group (strides {A, B, C}) and the M, N, and K groupings.
+/// \ingroup mdspan_ext
+template <StridedMdspan AType, StridedMdspan BType, StridedMdspan CType, std::size_t N, std::size_t NB>
+auto extract_strides_batched(AType const& A, BType const& B,
+                             std::array<std::pair<std::size_t, std::size_t>, N> const& contractDims,
+                             std::array<std::pair<std::size_t, std::size_t>, NB> const& batchDims, CType const& C)
+{
+  constexpr std::size_t MR = AType::rank() - N - NB;
+  constexpr std::size_t NR = BType::rank() - N - NB;
+  constexpr std::size_t KR = N;
+
+  static_vector<extent_strides<3>, NB> Bgroup;
+  static_vector<extent_strides<2>, MR> Mgroup;
+  static_vector<extent_strides<2>, NR> Ngroup;
+  static_vector<extent_strides<2>, KR> Kgroup;
+
+  std::array<bool, AType::rank()> AUsed{false};
+  std::array<bool, BType::rank()> BUsed{false};
+  for (std::size_t i = 0; i < NB; ++i)
+  {
+    auto [ai, bi] = batchDims[i];
+    ERROR_IF(A.extent(ai) != B.extent(bi), "Extent along batch dimension does not match", ai, bi);
+    ERROR_IF(A.extent(ai) != C.extent(i), "Extent along batch dimension does not match", ai, i);
+    ERROR_IF(AUsed[ai] || BUsed[bi], "Batch dimension used more than once", ai, bi);
+    AUsed[ai] = true;
+    BUsed[bi] = true;
+    Bgroup.emplace_back(A.extent(ai), A.stride(ai), B.stride(bi), C.stride(i));
+  }
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    auto [ai, bi] = contractDims[i];
+    ERROR_IF(A.extent(ai) != B.extent(bi), "Extent along tensor contraction dimension does not match", ai, bi);
+    ERROR_IF(AUsed[ai] || BUsed[bi], "Contraction dimension is also a batch dimension", ai, bi);
+    AUsed[ai] = true;
+    BUsed[bi] = true;
+    Kgroup.emplace_back(A.extent(ai), A.stride(ai), B.stride(bi));
+  }
+  std::size_t ci = NB;
+  for (std::size_t ai = 0; ai < AType::rank(); ++ai)
+  {
+    if (!AUsed[ai])
+    {
+      ERROR_IF(A.extent(ai) != C.extent(ci), "Extent along uncontracted dimension does not match", ai, ci);
+      Mgroup.emplace_back(A.extent(ai), A.stride(ai), C.stride(ci));
+      ++ci;
+    }
+  }
+  for (std::size_t bi = 0; bi < BType::rank(); ++bi)
+  {
+    if (!BUsed[bi])
+    {
+      ERROR_IF(B.extent(bi) != C.extent(ci), "Extent along uncontracted dimension does not match", bi, ci);
+      Ngroup.emplace_back(B.extent(bi), B.stride(bi), C.stride(ci));
+      ++ci;
+    }
+  }
+
+  merge_strides_right(Bgroup);
+  merge_strides_right(Mgroup);
+  merge_strides_right(Ngroup);
+  merge_strides_right(Kgroup);
+
+  return std::tuple{Bgroup, Mgroup, Ngroup, Kgroup};
+}
+
 } // namespace uni20
@@ -429,6 +429,14 @@ template <typename... Layouts> struct GeneralZipLayout
         /// \ingroup mdspan_ext
         [[nodiscard]] constexpr extents_type const& extents() const noexcept { return extents_; }
 
+        /// \brief Access the child mappings.
+        /// \return Tuple of the mappings of each zipped span.
+        /// \ingroup mdspan_ext
+        [[nodiscard]] constexpr std::tuple<typename Layouts::template mapping<Extents>...> const& mappings() const noexcept
+        {
+          return impls_;
+        }
+
         /// \brief Return the maximum required span size among the child mappings.
         /// \return Maximum number of elements any child mapping may touch.
         /// \ingroup mdspan_ext
@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * \file alignedstorage.hpp
+ * \ingroup tensor
+ * \brief Storage policy whose buffers start on a cache-line (or wider) boundary, and a compile-time query for the
+ *        alignment that a storage policy guarantees.
+ * \details std::vector only guarantees alignof(T), and large allocations from malloc typically sit 16 bytes past
+ *          a page boundary, so a 32- or 64-byte SIMD load from the start of a row splits a cache line. A
+ *          BasicTensor over AlignedStorage has its first element aligned to \c Align bytes, so the level-1 SIMD
+ *          loops, which test the alignment of their pointers at run time, take their aligned path on it. The
+ *          guarantee itself can be queried as BasicTensor::alignment or storage_alignment_v, but no kernel selects
+ *          a code path from it at compile time: kernels receive mdspans, often offset into the tensor by slicing,
+ *          which carry no alignment in their type, and the run-time test costs one branch per contiguous loop.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/cpu/cpu.hpp>
+#include <uni20/storage/heap_buffer.hpp>
+#include <uni20/storage/vectorstorage.hpp>
+#include <uni20/tensor/layout.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+namespace uni20
+{
+
+/// \brief Storage policy holding the elements of a tensor in a heap_buffer aligned to \p Align bytes.
+/// \details The elements are value-initialised unless the tensor is constructed with the \ref uninitialized tag.
+///          The default mapping is row-major and unpadded, so only the first element of the tensor is guaranteed
+///          to be aligned.
+/// \tparam Align Alignment of the first element, in bytes; a power of two, 64 (one cache line) by default.
+/// \ingroup tensor
+template <std::size_t Align = 64> struct AlignedStorage
+{
+    static_assert(std::has_single_bit(Align) && Align >= alignof(void*),
+                  "AlignedStorage: the alignment must be a power of two of at least the pointer alignment");
+
+    /// \brief Alignment of the first element of every buffer, in bytes.
+    static constexpr std::size_t alignment = Align;
+
+    template <typename ElementType> using storage_t = heap_buffer<ElementType, std::max(Align, alignof(ElementType))>;
+
+    using default_layout_policy = stdex::layout_stride;
+    using default_mapping_builder = layout::LayoutRight;
+
+    template <typename ElementType> static auto make_handle(storage_t<ElementType>& storage) noexcept -> ElementType*
+    {
+      return storage.data();
+    }
+
+    template <typename ElementType>
+    static auto make_handle(storage_t<ElementType> const& storage) noexcept -> ElementType const*
+    {
+      return storage.data();
+    }
+
+    using default_tag = cpu_tag;
+};
+
+/// \brief Alignment in bytes that the storage policy \p StoragePolicy guarantees for the first element of a buffer
+///        of \p T: the \c alignment member of the policy if it has one, and otherwise alignof(T).
+/// \details A buffer smaller than the alignment may be aligned only to the largest power of two not exceeding its
+///          size, which still covers any SIMD vector that fits in it.
+/// \ingroup tensor
+template <typename StoragePolicy, typename T> inline constexpr std::size_t storage_alignment_v = alignof(T);
+
+template <typename StoragePolicy, typename T>
+requires requires { StoragePolicy::alignment; }
+inline constexpr std::size_t storage_alignment_v<StoragePolicy, T> =
+    std::max<std::size_t>(StoragePolicy::alignment, alignof(T));
+
+} // namespace uni20
@@ -0,0 +1,320 @@
+#pragma once
+
+/**
+ * \file buffer_pool.hpp
+ * \ingroup tensor
+ * \brief Thread-caching pool of aligned memory blocks in size classes, and the PooledStorage policy built on it.
+ * \details Loops that create and destroy many tensors of the same shape pay for a malloc and for the page faults
+ *          of fresh memory every time. BufferPool instead keeps released blocks for reuse. Requests are rounded up
+ *          to a size class, four per power of two so that at most a quarter of a block is wasted, and a released
+ *          block goes to a cache private to the releasing thread, or, once that cache is full, to a pool shared by
+ *          all threads. An allocation looks in the thread cache first, then in the shared pool, and only then asks
+ *          the system. How many bytes each level retains, and the largest block that is pooled at all, are set by
+ *          buffer_pool_limits; statistics() counts hits, misses and retained bytes.
+ */
+
+#include <uni20/common/aligned_buffer.hpp>
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/cpu/cpu.hpp>
+#include <uni20/storage/heap_buffer.hpp>
+#include <uni20/tensor/layout.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace uni20
+{
+
+/// \brief Retention limits of a BufferPool.
+/// \ingroup tensor
+struct buffer_pool_limits
+{
+    std::size_t max_thread_bytes = std::size_t(64) << 20;  ///< Bytes kept in the cache of each thread.
+    std::size_t max_shared_bytes = std::size_t(256) << 20; ///< Bytes kept in the pool shared by all threads.
+    std::size_t max_block_bytes = std::size_t(256) << 20;  ///< Larger blocks are returned to the system at once.
+};
+
+/// \brief Counters of a BufferPool.
+/// \ingroup tensor
+struct buffer_pool_statistics
+{
+    std::size_t hits = 0;           ///< Allocations served from a thread cache or the shared pool.
+    std::size_t misses = 0;         ///< Allocations that had to ask the system.
+    std::size_t bytes_retained = 0; ///< Bytes held in the thread caches and the shared pool.
+};
+
+/// \brief Thread-caching, size-class pool of 64-byte aligned memory blocks; see \ref buffer_pool.hpp.
+/// \details There is one pool per process, global(). Blocks must be released with the size they were allocated
+///          with, and may be released by any thread.
+/// \ingroup tensor
+class BufferPool {
+  public:
+    /// \brief Alignment of every block, in bytes.
+    static constexpr std::size_t alignment = 64;
+
+    /// \brief Size of the smallest size class, in bytes.
+    static constexpr std::size_t min_block_bytes = 64;
+
+    /// \brief Number of size classes.
+    static constexpr std::size_t num_classes = 1 + 4 * (std::numeric_limits<std::size_t>::digits - 6);
+
+    BufferPool(BufferPool const&) = delete;
+    BufferPool& operator=(BufferPool const&) = delete;
+
+    /// \brief The pool of the process, which lives until the process exits.
+    static BufferPool& global()
+    {
+      static BufferPool* pool = new BufferPool();
+      return *pool;
+    }
+
+    /// \brief Index of the size class of a request of \p bytes.
+    static constexpr std::size_t size_class(std::size_t bytes) noexcept
+    {
+      if (bytes <= min_block_bytes) return 0;
+      std::size_t const k = std::size_t(std::bit_width(bytes - 1)) - 1;
+      std::size_t const quarter = std::size_t(1) << (k - 2);
+      std::size_t const steps = (bytes - (std::size_t(1) << k) + quarter - 1) / quarter;
+      return 1 + 4 * (k - 6) + (steps - 1);
+    }
+
+    /// \brief Size in bytes of the blocks of size class \p index.
+    static constexpr std::size_t class_bytes(std::size_t index) noexcept
+    {
+      if (index == 0) return min_block_bytes;
+      std::size_t const k = 6 + (index - 1) / 4;
+      return (std::size_t(1) << k) + ((index - 1) % 4 + 1) * (std::size_t(1) << (k - 2));
+    }
+
+    /// \brief Allocate a block of at least \p bytes bytes, aligned to \ref alignment.
+    /// \throws std::bad_alloc If the system allocation fails.
+    void* allocate(std::size_t bytes)
+    {
+      std::size_t const index = size_class(bytes);
+      std::size_t const block = class_bytes(index);
+      if (block <= max_block_bytes_.load(std::memory_order_relaxed))
+      {
+        if (void* p = local().pop(index, block))
+        {
+          hits_.fetch_add(1, std::memory_order_relaxed);
+          retained_.fetch_sub(block, std::memory_order_relaxed);
+          return p;
+        }
+        if (void* p = shared_.pop(index, block))
+        {
+          hits_.fetch_add(1, std::memory_order_relaxed);
+          retained_.fetch_sub(block, std::memory_order_relaxed);
+          return p;
+        }
+      }
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return detail::allocate_raw(block, alignment);
+    }
+
+    /// \brief Release a block returned by allocate(\p bytes), keeping it for reuse if the limits allow.
+    void deallocate(void* p, std::size_t bytes) noexcept
+    {
+      if (!p) return;
+      std::size_t const index = size_class(bytes);
+      std::size_t const block = class_bytes(index);
+      if (block <= max_block_bytes_.load(std::memory_order_relaxed) &&
+          (local().push(p, index, block, max_thread_bytes_.load(std::memory_order_relaxed)) ||
+           shared_.push(p, index, block, max_shared_bytes_.load(std::memory_order_relaxed))))
+      {
+        retained_.fetch_add(block, std::memory_order_relaxed);
+        return;
+      }
+      release_block(p);
+    }
+
+    /// \brief Set the retention limits; blocks already retained are kept until they are reused or trimmed.
+    void set_limits(buffer_pool_limits const& limits) noexcept
+    {
+      max_thread_bytes_.store(limits.max_thread_bytes, std::memory_order_relaxed);
+      max_shared_bytes_.store(limits.max_shared_bytes, std::memory_order_relaxed);
+      max_block_bytes_.store(limits.max_block_bytes, std::memory_order_relaxed);
+    }
+
+    /// \brief The current retention limits.
+    [[nodiscard]] buffer_pool_limits limits() const noexcept
+    {
+      return {max_thread_bytes_.load(std::memory_order_relaxed), max_shared_bytes_.load(std::memory_order_relaxed),
+              max_block_bytes_.load(std::memory_order_relaxed)};
+    }
+
+    /// \brief Snapshot of the counters.
+    [[nodiscard]] buffer_pool_statistics statistics() const noexcept
+    {
+      return {hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed),
+              retained_.load(std::memory_order_relaxed)};
+    }
+
+    /// \brief Set the hit and miss counters to zero.
+    void reset_statistics() noexcept
+    {
+      hits_.store(0, std::memory_order_relaxed);
+      misses_.store(0, std::memory_order_relaxed);
+    }
+
+    /// \brief Return the blocks in the shared pool and in the cache of the calling thread to the system.
+    void trim() noexcept { retained_.fetch_sub(local().clear() + shared_.clear(), std::memory_order_relaxed); }
+
+  private:
+    BufferPool() = default;
+
+    static void release_block(void* p) noexcept { detail::aligned_deleter<std::byte>{}(static_cast<std::byte*>(p)); }
+
+    /// \brief Free lists of one cache level, by size class.
+    struct free_lists
+    {
+        std::array<std::vector<void*>, num_classes> blocks;
+        std::size_t bytes = 0;
+
+        void* pop(std::size_t index, std::size_t block) noexcept
+        {
+          auto& list = blocks[index];
+          if (list.empty()) return nullptr;
+          void* p = list.back();
+          list.pop_back();
+          bytes -= block;
+          return p;
+        }
+
+        bool push(void* p, std::size_t index, std::size_t block, std::size_t limit) noexcept
+        {
+          if (bytes + block > limit) return false;
+          try
+          {
+            blocks[index].push_back(p);
+          }
+          catch (...)
+          {
+            return false;
+          }
+          bytes += block;
+          return true;
+        }
+
+        std::size_t clear() noexcept
+        {
+          for (auto& list : blocks)
+          {
+            for (void* p : list)
+              release_block(p);
+            list.clear();
+          }
+          return std::exchange(bytes, 0);
+        }
+    };
+
+    /// \brief Free lists shared by all threads.
+    struct shared_lists
+    {
+        std::mutex mutex;
+        free_lists lists;
+
+        void* pop(std::size_t index, std::size_t block) noexcept
+        {
+          std::lock_guard lock(mutex);
+          return lists.pop(index, block);
+        }
+
+        bool push(void* p, std::size_t index, std::size_t block, std::size_t limit) noexcept
+        {
+          std::lock_guard lock(mutex);
+          return lists.push(p, index, block, limit);
+        }
+
+        std::size_t clear() noexcept
+        {
+          std::lock_guard lock(mutex);
+          return lists.clear();
+        }
+    };
+
+    /// \brief Cache of the calling thread, handed to the shared pool when the thread exits.
+    struct thread_cache : free_lists
+    {
+        ~thread_cache()
+        {
+          auto& pool = BufferPool::global();
+          for (std::size_t index = 0; index < num_classes; ++index)
+          {
+            std::size_t const block = class_bytes(index);
+            for (void* p : blocks[index])
+            {
+              if (!pool.shared_.push(p, index, block, pool.max_shared_bytes_.load(std::memory_order_relaxed)))
+              {
+                pool.retained_.fetch_sub(block, std::memory_order_relaxed);
+                release_block(p);
+              }
+            }
+          }
+        }
+    };
+
+    static thread_cache& local() noexcept
+    {
+      thread_local thread_cache cache;
+      return cache;
+    }
+
+    shared_lists shared_;
+    std::atomic<std::size_t> max_thread_bytes_{buffer_pool_limits{}.max_thread_bytes};
+    std::atomic<std::size_t> max_shared_bytes_{buffer_pool_limits{}.max_shared_bytes};
+    std::atomic<std::size_t> max_block_bytes_{buffer_pool_limits{}.max_block_bytes};
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+    std::atomic<std::size_t> retained_{0};
+};
+
+/// \brief Memory source of basic_buffer that draws from BufferPool::global().
+/// \ingroup tensor
+struct pooled_source
+{
+    static constexpr std::size_t alignment = BufferPool::alignment;
+
+    static void* allocate(std::size_t bytes) { return BufferPool::global().allocate(bytes); }
+
+    static void deallocate(void* p, std::size_t bytes) noexcept { BufferPool::global().deallocate(p, bytes); }
+};
+
+/// \brief Owning, contiguous buffer of \p T whose memory is drawn from and returned to BufferPool::global().
+/// \ingroup tensor
+template <typename T> using pooled_buffer = basic_buffer<T, pooled_source>;
+
+/// \brief Storage policy for short-lived tensors, whose buffers are recycled through BufferPool::global().
+/// \details The elements are value-initialised unless the tensor is constructed with the \ref uninitialized tag,
+///          in which case a recycled block keeps whatever it last held.
+/// \ingroup tensor
+struct PooledStorage
+{
+    /// \brief Alignment of the first element of every buffer, in bytes.
+    static constexpr std::size_t alignment = BufferPool::alignment;
+
+    template <typename ElementType> using storage_t = pooled_buffer<ElementType>;
+
+    using default_layout_policy = stdex::layout_stride;
+    using default_mapping_builder = layout::LayoutRight;
+
+    template <typename ElementType> static auto make_handle(storage_t<ElementType>& storage) noexcept -> ElementType*
+    {
+      return storage.data();
+    }
+
+    template <typename ElementType>
+    static auto make_handle(storage_t<ElementType> const& storage) noexcept -> ElementType const*
+    {
+      return storage.data();
+    }
+
+    using default_tag = cpu_tag;
+};
+
+} // namespace uni20
@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * \file heap_buffer.hpp
+ * \ingroup tensor
+ * \brief Owning buffers that, unlike std::vector, can be allocated without initialising their elements.
+ * \details std::vector value-initialises every element it allocates, which for arithmetic types is a full pass
+ *          of zeros over memory that an output tensor is about to overwrite anyway. The buffers here can skip that
+ *          pass when constructed with the \ref uninitialized tag; they hold the elements of the heap-backed
+ *          storage policies.
+ */
+
+#include <uni20/common/aligned_buffer.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace uni20
+{
+
+/// \brief Tag type selecting construction without initialising the elements.
+/// \ingroup tensor
+struct uninitialized_t
+{
+    explicit uninitialized_t() = default;
+};
+
+/// \brief Tag requesting that the elements of a new tensor are left uninitialised, for tensors that will be fully
+///        overwritten before they are read.
+/// \details Elements of class type are still default-constructed; elements of arithmetic type are left
+///          indeterminate. Storage policies that cannot skip the initialisation, such as VectorStorage, ignore the
+///          tag.
+/// \ingroup tensor
+inline constexpr uninitialized_t uninitialized{};
+
+/// \brief Owning, contiguous buffer of \p T whose memory comes from \p Source.
+/// \details Unlike std::vector, the buffer can be created without initialising its elements. Copies are deep and
+///          allocate from the same source.
+/// \tparam T      Element type.
+/// \tparam Source Memory source with static `allocate(bytes)` and `deallocate(p, bytes)` and an \c alignment.
+/// \ingroup tensor
+template <typename T, typename Source> class basic_buffer {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+    using source_type = Source;
+
+    static constexpr std::size_t alignment = Source::alignment;
+
+    basic_buffer() = default;
+
+    /// \brief Allocate \p n value-initialised elements.
+    explicit basic_buffer(size_type n)
+        : basic_buffer(init_tag{}, n, [](T* p, size_type count) { std::uninitialized_value_construct_n(p, count); })
+    {}
+
+    /// \brief Allocate \p n default-initialised elements, which leaves elements of arithmetic type indeterminate.
+    basic_buffer(size_type n, uninitialized_t)
+        : basic_buffer(init_tag{}, n, [](T* p, size_type count) { std::uninitialized_default_construct_n(p, count); })
+    {}
+
+    basic_buffer(basic_buffer const& other)
+        : basic_buffer(init_tag{}, other.size_,
+                       [&other](T* p, size_type count) { std::uninitialized_copy_n(other.data_, count, p); })
+    {}
+
+    basic_buffer(basic_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+    {}
+
+    basic_buffer& operator=(basic_buffer other) noexcept
+    {
+      this->swap(other);
+      return *this;
+    }
+
+    ~basic_buffer()
+    {
+      std::destroy_n(data_, size_);
+      release(data_, size_);
+    }
+
+    void swap(basic_buffer& other) noexcept
+    {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+    }
+
+    [[nodiscard]] T* data() noexcept { return data_; }
+    [[nodiscard]] T const* data() const noexcept { return data_; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] T& operator[](size_type i) noexcept { return data_[i]; }
+    [[nodiscard]] T const& operator[](size_type i) const noexcept { return data_[i]; }
+
+    [[nodiscard]] iterator begin() noexcept { return data_; }
+    [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+    [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+
+  private:
+    struct init_tag
+    {};
+
+    template <typename Init> basic_buffer(init_tag, size_type n, Init&& init)
+    {
+      if (n == 0) return;
+      T* p = static_cast<T*>(Source::allocate(n * sizeof(T)));
+      try
+      {
+        init(p, n);
+      }
+      catch (...)
+      {
+        Source::deallocate(p, n * sizeof(T));
+        throw;
+      }
+      data_ = p;
+      size_ = n;
+    }
+
+    static void release(T* p, size_type n) noexcept
+    {
+      if (p) Source::deallocate(p, n * sizeof(T));
+    }
+
+    T* data_ = nullptr;
+    size_type size_ = 0;
+};
+
+/// \brief Memory source of basic_buffer that allocates each buffer with allocate_uninitialized_buffer().
+/// \tparam Align Alignment of every allocation, in bytes.
+/// \ingroup tensor
+template <std::size_t Align> struct aligned_heap_source
+{
+    static constexpr std::size_t alignment = Align;
+
+    static void* allocate(std::size_t bytes)
+    {
+      return allocate_uninitialized_buffer<std::byte>(bytes, Align).release();
+    }
+
+    static void deallocate(void* p, std::size_t) noexcept
+    {
+      detail::aligned_deleter<std::byte>{}(static_cast<std::byte*>(p));
+    }
+};
+
+/// \brief Owning, aligned, contiguous buffer of \p T allocated with allocate_uninitialized_buffer().
+/// \tparam T     Element type.
+/// \tparam Align Alignment of the first element, in bytes.
+/// \ingroup tensor
+template <typename T, std::size_t Align = 64> using heap_buffer = basic_buffer<T, aligned_heap_source<Align>>;
+
+} // namespace uni20
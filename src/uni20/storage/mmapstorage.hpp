@@ -0,0 +1,291 @@
+#pragma once
+
+/**
+ * \file mmapstorage.hpp
+ * \ingroup tensor
+ * \brief Storage policy backing a tensor by a memory-mapped file, for tensors larger than the physical memory.
+ * \details The elements of a BasicTensor over MmapStorage are the contents of a file mapped with mmap, so the
+ *          operating system pages them in on access and writes them back or evicts them under memory pressure.
+ *          Since the handle is an ordinary pointer, TensorView, mdspan and the kernels work on it unchanged. Several
+ *          processes that map the same file read-only share one copy of it in the page cache.
+ *
+ *          A file is opened with mmap_buffer::open() or created with mmap_buffer::create(), and the buffer is given
+ *          to the BasicTensor constructor that adopts a storage object. A tensor constructed from its extents alone
+ *          maps anonymous, zero-filled memory. This header requires POSIX and is not included by basic_tensor.hpp.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/kernel/cpu/cpu.hpp>
+#include <uni20/storage/heap_buffer.hpp>
+#include <uni20/tensor/layout.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uni20
+{
+
+/// \brief Access mode of a file mapped by mmap_buffer.
+/// \ingroup tensor
+enum class mmap_mode
+{
+  read_only,    ///< Shared, read-only mapping; mutable access to the tensor is a precondition failure.
+  read_write,   ///< Shared mapping whose writes reach the file, at the latest on flush().
+  copy_on_write ///< Private mapping; writes go to private pages and never reach the file.
+};
+
+/// \brief Expected access pattern of a range of a mapping, passed on to madvise.
+/// \ingroup tensor
+enum class mmap_advice
+{
+  normal,     ///< No particular pattern; the default.
+  sequential, ///< Pages are read in order, so read ahead aggressively and drop them soon after.
+  random,     ///< Pages are read in no particular order, so do not read ahead.
+  willneed,   ///< Pages will be needed soon, so start reading them in now.
+  dontneed    ///< Pages are not needed for now; file-backed pages are dropped and read again on next access.
+};
+
+namespace detail
+{
+[[noreturn]] inline void throw_mmap_error(char const* what, std::filesystem::path const& path = {})
+{
+  std::string msg = what;
+  if (!path.empty()) msg += ": " + path.string();
+  throw std::system_error(errno, std::generic_category(), msg);
+}
+
+inline int to_madvise(mmap_advice advice) noexcept
+{
+  switch (advice)
+  {
+    case mmap_advice::sequential:
+      return MADV_SEQUENTIAL;
+    case mmap_advice::random:
+      return MADV_RANDOM;
+    case mmap_advice::willneed:
+      return MADV_WILLNEED;
+    case mmap_advice::dontneed:
+      return MADV_DONTNEED;
+    default:
+      return MADV_NORMAL;
+  }
+}
+} // namespace detail
+
+/// \brief Owning buffer of \p T mapped from a file, or from anonymous memory.
+/// \details The file descriptor is closed once the mapping is made. Copies are deep and live in anonymous memory,
+///          so a copy of a read-only mapping is writable and independent of the file.
+/// \tparam T Element type, which must be trivially copyable, since its bytes are those of the file.
+/// \ingroup tensor
+template <typename T> class mmap_buffer {
+    static_assert(std::is_trivially_copyable_v<T>, "mmap_buffer: element type must be trivially copyable");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+    mmap_buffer() = default;
+
+    /// \brief Map \p n zero-filled elements of anonymous memory.
+    explicit mmap_buffer(size_type n) : size_(n), mode_(mmap_mode::copy_on_write)
+    {
+      if (n == 0) return;
+      void* p = ::mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) detail::throw_mmap_error("mmap_buffer: anonymous mmap failed");
+      data_ = static_cast<T*>(p);
+    }
+
+    /// \brief Map \p n elements of anonymous memory, which the system fills with zeros in any case.
+    mmap_buffer(size_type n, uninitialized_t) : mmap_buffer(n) {}
+
+    mmap_buffer(mmap_buffer const& other) : mmap_buffer(other.size_)
+    {
+      std::copy_n(other.data_, size_, data_);
+    }
+
+    mmap_buffer(mmap_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          mode_(other.mode_), file_backed_(std::exchange(other.file_backed_, false))
+    {}
+
+    mmap_buffer& operator=(mmap_buffer other) noexcept
+    {
+      this->swap(other);
+      return *this;
+    }
+
+    ~mmap_buffer()
+    {
+      if (data_) ::munmap(data_, size_ * sizeof(T));
+    }
+
+    void swap(mmap_buffer& other) noexcept
+    {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(mode_, other.mode_);
+      std::swap(file_backed_, other.file_backed_);
+    }
+
+    /// \brief Map the whole of an existing file, whose size must be a multiple of sizeof(T).
+    /// \throws std::system_error If the file cannot be opened or mapped.
+    static mmap_buffer open(std::filesystem::path const& path, mmap_mode mode = mmap_mode::read_only)
+    {
+      int const fd = ::open(path.c_str(), mode == mmap_mode::read_write ? O_RDWR : O_RDONLY);
+      if (fd < 0) detail::throw_mmap_error("mmap_buffer: cannot open", path);
+      struct ::stat st{};
+      if (::fstat(fd, &st) != 0)
+      {
+        int const err = errno;
+        ::close(fd);
+        errno = err;
+        detail::throw_mmap_error("mmap_buffer: cannot stat", path);
+      }
+      auto const bytes = static_cast<std::size_t>(st.st_size);
+      PRECONDITION(bytes % sizeof(T) == 0, "mmap_buffer: file size is not a multiple of the element size", bytes,
+                   sizeof(T));
+      return mmap_buffer(fd, bytes / sizeof(T), mode, path);
+    }
+
+    /// \brief Create \p path, or truncate it if it exists, with room for \p n elements, and map it read-write.
+    /// \details The elements start as zeros; the file is sparse until they are written.
+    /// \throws std::system_error If the file cannot be created, resized or mapped.
+    static mmap_buffer create(std::filesystem::path const& path, size_type n)
+    {
+      int const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) detail::throw_mmap_error("mmap_buffer: cannot create", path);
+      if (::ftruncate(fd, static_cast<off_t>(n * sizeof(T))) != 0)
+      {
+        int const err = errno;
+        ::close(fd);
+        errno = err;
+        detail::throw_mmap_error("mmap_buffer: cannot resize", path);
+      }
+      return mmap_buffer(fd, n, mmap_mode::read_write, path);
+    }
+
+    [[nodiscard]] T* data() noexcept { return data_; }
+    [[nodiscard]] T const* data() const noexcept { return data_; }
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] T& operator[](size_type i) noexcept { return data_[i]; }
+    [[nodiscard]] T const& operator[](size_type i) const noexcept { return data_[i]; }
+
+    [[nodiscard]] iterator begin() noexcept { return data_; }
+    [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+    [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+
+    /// \brief Access mode of the mapping; anonymous memory counts as \ref mmap_mode::copy_on_write.
+    [[nodiscard]] mmap_mode mode() const noexcept { return mode_; }
+
+    /// \brief Whether the elements may be modified.
+    [[nodiscard]] bool writable() const noexcept { return mode_ != mmap_mode::read_only; }
+
+    /// \brief Whether the elements are mapped from a file rather than from anonymous memory.
+    [[nodiscard]] bool file_backed() const noexcept { return file_backed_; }
+
+    /// \brief Tell the system how elements [\p first, \p first + \p count) will be accessed.
+    /// \details The range is widened to whole pages. The advice is only a hint, and a failure to apply it is
+    ///          ignored; \ref mmap_advice::dontneed discards modifications of a \ref mmap_mode::copy_on_write
+    ///          mapping, which then reads as the file (or as zeros for anonymous memory) again.
+    void advise(mmap_advice advice, size_type first = 0, size_type count = size_type(-1)) const noexcept
+    {
+      if (!data_ || first >= size_) return;
+      count = std::min(count, size_ - first);
+      auto const page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+      auto const begin = reinterpret_cast<std::uintptr_t>(data_ + first) / page * page;
+      auto const end = reinterpret_cast<std::uintptr_t>(data_ + first + count);
+      ::madvise(reinterpret_cast<void*>(begin), end - begin, detail::to_madvise(advice));
+    }
+
+    /// \brief Write modified elements of a \ref mmap_mode::read_write mapping back to the file; a no-op for other
+    ///        mappings.
+    /// \param wait If true, return only once the data has been written; otherwise only schedule the write.
+    /// \throws std::system_error If msync fails.
+    void flush(bool wait = true) const
+    {
+      if (!data_ || mode_ != mmap_mode::read_write) return;
+      if (::msync(data_, size_ * sizeof(T), wait ? MS_SYNC : MS_ASYNC) != 0)
+        detail::throw_mmap_error("mmap_buffer: msync failed");
+    }
+
+  private:
+    /// \brief Map \p n elements of the open file \p fd, and close it.
+    mmap_buffer(int fd, size_type n, mmap_mode mode, std::filesystem::path const& path)
+        : size_(n), mode_(mode), file_backed_(true)
+    {
+      if (n != 0)
+      {
+        int const prot = mode == mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        int const flags = mode == mmap_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+        void* p = ::mmap(nullptr, n * sizeof(T), prot, flags, fd, 0);
+        if (p == MAP_FAILED)
+        {
+          int const err = errno;
+          ::close(fd);
+          errno = err;
+          detail::throw_mmap_error("mmap_buffer: mmap failed", path);
+        }
+        data_ = static_cast<T*>(p);
+      }
+      ::close(fd);
+    }
+
+    T* data_ = nullptr;
+    size_type size_ = 0;
+    mmap_mode mode_ = mmap_mode::copy_on_write;
+    bool file_backed_ = false;
+};
+
+/// \brief Storage policy holding the elements of a tensor in an mmap_buffer; see \ref mmapstorage.hpp.
+/// \details Mutable access to a tensor over a \ref mmap_mode::read_only mapping is a precondition failure, rather
+///          than a segmentation fault on the first write.
+/// \ingroup tensor
+struct MmapStorage
+{
+    template <typename ElementType> using storage_t = mmap_buffer<ElementType>;
+
+    using default_layout_policy = stdex::layout_stride;
+    using default_mapping_builder = layout::LayoutRight;
+
+    template <typename ElementType> static auto make_handle(storage_t<ElementType>& storage) noexcept -> ElementType*
+    {
+      return storage.data();
+    }
+
+    template <typename ElementType>
+    static auto make_handle(storage_t<ElementType> const& storage) noexcept -> ElementType const*
+    {
+      return storage.data();
+    }
+
+    /// \brief Called by BasicTensor before mutable access; the mapping never moves.
+    template <typename ElementType> static bool prepare_write(storage_t<ElementType>& storage)
+    {
+      PRECONDITION(storage.writable(), "MmapStorage: mutable access to a read-only mapping");
+      return false;
+    }
+
+    using default_tag = cpu_tag;
+};
+
+} // namespace uni20
@@ -0,0 +1,194 @@
+#pragma once
+
+/**
+ * \file sharedstorage.hpp
+ * \ingroup tensor
+ * \brief Reference-counted storage policy, giving BasicTensor cheap copies with copy-on-write.
+ * \details A copy of a BasicTensor over SharedStorage shares the buffer of the original and only increments an
+ *          atomic count, so tensors can be returned, captured and handed to asynchronous tasks by value at constant
+ *          cost. The first mutable access through a tensor whose buffer is shared gives that tensor a private copy
+ *          of the elements, so a copy behaves as an independent value.
+ */
+
+#include <uni20/common/aligned_buffer.hpp>
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/cpu/cpu.hpp>
+#include <uni20/storage/heap_buffer.hpp>
+#include <uni20/tensor/layout.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace uni20
+{
+
+/// \brief Reference-counted, contiguous buffer of \p T, with the count and the elements in a single allocation.
+/// \details Copies share the elements. detach() gives a buffer a private copy of them if they are shared, and is
+///          what BasicTensor calls before it hands out mutable access. The count is atomic, so copies may be made
+///          and destroyed concurrently by different threads; the elements themselves are not synchronised.
+/// \tparam T     Element type.
+/// \tparam Align Alignment of the first element, in bytes.
+/// \ingroup tensor
+template <typename T, std::size_t Align = 64> class shared_buffer {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+    static constexpr std::size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+
+    shared_buffer() = default;
+
+    /// \brief Allocate \p n value-initialised elements.
+    explicit shared_buffer(size_type n)
+        : shared_buffer(init_tag{}, n, [](T* p, size_type count) { std::uninitialized_value_construct_n(p, count); })
+    {}
+
+    /// \brief Allocate \p n default-initialised elements, which leaves elements of arithmetic type indeterminate.
+    shared_buffer(size_type n, uninitialized_t)
+        : shared_buffer(init_tag{}, n, [](T* p, size_type count) { std::uninitialized_default_construct_n(p, count); })
+    {}
+
+    /// \brief Share the elements of \p other.
+    shared_buffer(shared_buffer const& other) noexcept : block_(other.block_)
+    {
+      if (block_) block_->count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    shared_buffer(shared_buffer&& other) noexcept : block_(std::exchange(other.block_, nullptr)) {}
+
+    shared_buffer& operator=(shared_buffer other) noexcept
+    {
+      this->swap(other);
+      return *this;
+    }
+
+    ~shared_buffer() { release(block_); }
+
+    void swap(shared_buffer& other) noexcept { std::swap(block_, other.block_); }
+
+    [[nodiscard]] T* data() noexcept { return block_ ? elements(block_) : nullptr; }
+    [[nodiscard]] T const* data() const noexcept { return block_ ? elements(block_) : nullptr; }
+    [[nodiscard]] size_type size() const noexcept { return block_ ? block_->size : 0; }
+    [[nodiscard]] bool empty() const noexcept { return this->size() == 0; }
+
+    [[nodiscard]] T& operator[](size_type i) noexcept { return this->data()[i]; }
+    [[nodiscard]] T const& operator[](size_type i) const noexcept { return this->data()[i]; }
+
+    [[nodiscard]] iterator begin() noexcept { return this->data(); }
+    [[nodiscard]] iterator end() noexcept { return this->data() + this->size(); }
+    [[nodiscard]] const_iterator begin() const noexcept { return this->data(); }
+    [[nodiscard]] const_iterator end() const noexcept { return this->data() + this->size(); }
+
+    /// \brief Number of buffers sharing the elements, or 0 for an empty buffer.
+    [[nodiscard]] std::size_t use_count() const noexcept
+    {
+      return block_ ? block_->count.load(std::memory_order_acquire) : 0;
+    }
+
+    /// \brief Whether no other buffer shares the elements.
+    [[nodiscard]] bool unique() const noexcept { return this->use_count() <= 1; }
+
+    /// \brief Replace shared elements by a private copy of them.
+    /// \return Whether a copy was made, which moves data().
+    bool detach()
+    {
+      if (this->unique()) return false;
+      T const* src = elements(block_);
+      shared_buffer copy(init_tag{}, block_->size,
+                         [src](T* p, size_type count) { std::uninitialized_copy_n(src, count, p); });
+      this->swap(copy);
+      return true;
+    }
+
+  private:
+    struct init_tag
+    {};
+
+    struct control_block
+    {
+        std::atomic<std::size_t> count;
+        std::size_t size;
+    };
+
+    /// \brief Offset of the first element from the start of the allocation.
+    static constexpr std::size_t header_bytes = (sizeof(control_block) + alignment - 1) / alignment * alignment;
+
+    static T* elements(control_block* block) noexcept
+    {
+      return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(block) + header_bytes);
+    }
+
+    template <typename Init> shared_buffer(init_tag, size_type n, Init&& init)
+    {
+      if (n == 0) return;
+      std::byte* raw = allocate_uninitialized_buffer<std::byte>(header_bytes + n * sizeof(T), alignment).release();
+      auto* block = ::new (raw) control_block{{1}, n};
+      try
+      {
+        init(elements(block), n);
+      }
+      catch (...)
+      {
+        block->~control_block();
+        detail::aligned_deleter<std::byte>{}(raw);
+        throw;
+      }
+      block_ = block;
+    }
+
+    static void release(control_block* block) noexcept
+    {
+      if (!block || block->count.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+      std::destroy_n(elements(block), block->size);
+      block->~control_block();
+      detail::aligned_deleter<std::byte>{}(reinterpret_cast<std::byte*>(block));
+    }
+
+    control_block* block_ = nullptr;
+};
+
+/// \brief Storage policy whose buffers are shared between copies of a tensor and copied on first mutable access.
+/// \details BasicTensor detaches the buffer, through prepare_write(), before every mutable access: operator[],
+///          mutable_mdspan(), mutable_handle(), the mutable view(), remap() and storage(). A mutable view or mdspan
+///          taken before a copy is made still refers to the shared elements, so writes through it are seen by the
+///          copy; take mutable views after copying. shared_view() gives a read-only view that keeps the elements
+///          alive.
+/// \ingroup tensor
+struct SharedStorage
+{
+    /// \brief Alignment of the first element of every buffer, in bytes.
+    static constexpr std::size_t alignment = 64;
+
+    template <typename ElementType> using storage_t = shared_buffer<ElementType, alignment>;
+
+    using default_layout_policy = stdex::layout_stride;
+    using default_mapping_builder = layout::LayoutRight;
+
+    template <typename ElementType> static auto make_handle(storage_t<ElementType>& storage) noexcept -> ElementType*
+    {
+      return storage.data();
+    }
+
+    template <typename ElementType>
+    static auto make_handle(storage_t<ElementType> const& storage) noexcept -> ElementType const*
+    {
+      return storage.data();
+    }
+
+    /// \brief Called by BasicTensor before mutable access: detach the buffer, returning whether the elements moved.
+    template <typename ElementType> static bool prepare_write(storage_t<ElementType>& storage)
+    {
+      return storage.detach();
+    }
+
+    using default_tag = cpu_tag;
+};
+
+} // namespace uni20
@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * \file uninitializedstorage.hpp
+ * \ingroup tensor
+ * \brief Storage policy whose buffers can be allocated without initialising their elements.
+ * \details std::vector value-initialises every element it allocates, which for arithmetic types is a full pass
+ *          of zeros over memory that an output tensor is about to overwrite anyway. A BasicTensor constructed with
+ *          the \ref uninitialized tag over UninitializedStorage skips that pass, and the cost of the allocation is
+ *          only that of the page faults when the elements are first written.
+ */
+
+#include <uni20/storage/alignedstorage.hpp>
+#include <uni20/storage/heap_buffer.hpp>
+
+namespace uni20
+{
+
+/// \brief Storage policy holding the elements of a tensor in a heap_buffer, so that a BasicTensor constructed with
+///        the \ref uninitialized tag does not initialise them.
+/// \details Without the tag the elements are value-initialised, as with VectorStorage. This is AlignedStorage with
+///          its default, cache-line alignment.
+/// \ingroup tensor
+using UninitializedStorage = AlignedStorage<>;
+
+} // namespace uni20
@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * \file workspace_arena.hpp
+ * \ingroup tensor
+ * \brief Scoped bump allocator for the scratch tensors of one computation.
+ * \details A WorkspaceArena takes chunks from BufferPool::global() and hands out consecutive, aligned pieces of
+ *          them, so a computation that needs many intermediate buffers makes one pool request per chunk rather
+ *          than one per buffer. Nothing is freed individually: every chunk goes back to the pool when the arena
+ *          is reset or leaves scope, and the views it handed out must not outlive it.
+ */
+
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/core/types.hpp>
+#include <uni20/storage/buffer_pool.hpp>
+#include <uni20/tensor/tensor_view.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace uni20
+{
+
+/// \brief Scoped bump allocator drawing chunks from BufferPool::global(); see \ref workspace_arena.hpp.
+/// \ingroup tensor
+class WorkspaceArena {
+  public:
+    /// \brief Create an arena that takes chunks of at least \p chunk_bytes bytes from the pool, on first use.
+    explicit WorkspaceArena(std::size_t chunk_bytes = std::size_t(1) << 20) : chunk_bytes_(chunk_bytes) {}
+
+    WorkspaceArena(WorkspaceArena const&) = delete;
+    WorkspaceArena& operator=(WorkspaceArena const&) = delete;
+
+    ~WorkspaceArena() { this->release(); }
+
+    /// \brief Uninitialised memory for \p bytes bytes aligned to \p align, a power of two of at most
+    ///        BufferPool::alignment.
+    [[nodiscard]] void* allocate(std::size_t bytes, std::size_t align = BufferPool::alignment)
+    {
+      PRECONDITION(align > 0 && align <= BufferPool::alignment && (align & (align - 1)) == 0,
+                   "WorkspaceArena: unsupported alignment", align);
+      std::size_t offset = (used_ + align - 1) & ~(align - 1);
+      if (chunks_.empty() || offset + bytes > chunks_.back().bytes)
+      {
+        std::size_t const size = std::max(chunk_bytes_, bytes);
+        chunks_.push_back({BufferPool::global().allocate(size), size});
+        offset = 0;
+      }
+      used_ = offset + bytes;
+      return static_cast<std::byte*>(chunks_.back().data) + offset;
+    }
+
+    /// \brief Uninitialised memory for \p n elements of \p T, which must be trivially destructible.
+    template <typename T> [[nodiscard]] T* allocate(std::size_t n)
+    {
+      static_assert(std::is_trivially_destructible_v<T>, "WorkspaceArena: elements are never destroyed");
+      static_assert(alignof(T) <= BufferPool::alignment, "WorkspaceArena: over-aligned element type");
+      return static_cast<T*>(this->allocate(n * sizeof(T), BufferPool::alignment));
+    }
+
+    /// \brief Mutable row-major tensor view of uninitialised elements of \p T with the given extents.
+    template <typename T, std::size_t R> [[nodiscard]] auto make_view(std::array<index_type, R> const& extents)
+    {
+      using extents_type = stdex::dextents<index_type, R>;
+      std::size_t n = 1;
+      for (index_type e : extents)
+        n *= std::size_t(e);
+      return TensorView<T, mutable_tensor_traits<extents_type>>(this->allocate<T>(n), extents_type(extents));
+    }
+
+    /// \brief Return every chunk to the pool, invalidating all memory handed out so far.
+    void reset() noexcept { this->release(); }
+
+    /// \brief Bytes handed out from the current chunk, including alignment padding.
+    [[nodiscard]] std::size_t bytes_used() const noexcept { return used_; }
+
+    /// \brief Total size of the chunks held, in bytes.
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+      std::size_t total = 0;
+      for (auto const& c : chunks_)
+        total += c.bytes;
+      return total;
+    }
+
+  private:
+    struct chunk
+    {
+        void* data;
+        std::size_t bytes;
+    };
+
+    void release() noexcept
+    {
+      for (auto const& c : chunks_)
+        BufferPool::global().deallocate(c.data, c.bytes);
+      chunks_.clear();
+      used_ = 0;
+    }
+
+    std::size_t chunk_bytes_;
+    std::vector<chunk> chunks_;
+    std::size_t used_ = 0;
+};
+
+} // namespace uni20
@@ -2,6 +2,10 @@
 
 #include "layout.hpp"
 #include "tensor_view.hpp"
+#include <uni20/common/trace.hpp>
+#include <uni20/storage/alignedstorage.hpp>
+#include <uni20/storage/sharedstorage.hpp>
+#include <uni20/storage/uninitializedstorage.hpp>
 
 #include <array>
 #include <concepts>
@@ -12,7 +16,43 @@
 namespace uni20
 {
 
+/// \brief Tensor view that also holds a reference to the storage it views, keeping the elements alive.
+/// \details Returned by BasicTensor::shared_view() for storage policies whose buffers are reference counted, such as
+///          SharedStorage. It is a \p View, so it can be passed wherever one is expected; views derived from it,
+///          for example by subrange(), do not hold the reference.
+/// \tparam View    Tensor view type.
+/// \tparam Storage Reference-counted storage type.
+/// \ingroup tensor
+template <typename View, typename Storage> class RetainingView : public View {
+  public:
+    RetainingView(View view, Storage storage) : View(std::move(view)), storage_(std::move(storage)) {}
+
+    /// \brief The storage whose elements the view refers to.
+    [[nodiscard]] auto storage() const noexcept -> Storage const& { return storage_; }
+
+  private:
+    Storage storage_;
+};
+
+namespace detail
+{
+
+/// \brief True if \p StoragePolicy must be told before the elements of a buffer of \p T are modified, through a
+///        static \c prepare_write(storage) that returns whether the elements moved; for example to detach shared
+///        storage, or to check that a mapping is writable.
+/// \ingroup internal
+template <typename StoragePolicy, typename T>
+concept storage_prepares_write = requires(typename StoragePolicy::template storage_t<T>& storage) {
+  { StoragePolicy::prepare_write(storage) } -> std::convertible_to<bool>;
+};
+
+} // namespace detail
+
 /// \brief Owning tensor that allocates storage and exposes mdspan-based access.
+/// \details The tensor is a TensorView of its elements. If the storage policy must prepare the elements for
+///          modification (detail::storage_prepares_write), as SharedStorage and MmapStorage do, the tensor derives
+///          only from the read-only view: every route to mutable access goes through a member of the tensor that
+///          prepares the elements first, and a function taking a mutable TensorView must be passed view().
 /// \ingroup tensor
 /// \tparam ElementType Value type stored by the tensor.
 /// \tparam Extents Extents type describing the tensor shape.
@@ -22,11 +62,16 @@ namespace uni20
 template <typename ElementType, typename Extents, typename StoragePolicy = VectorStorage,
           typename LayoutPolicy = stdex::layout_stride, typename AccessorFactory = DefaultAccessorFactory>
 class BasicTensor
-    : public TensorView<ElementType, mutable_tensor_traits<Extents, StoragePolicy, LayoutPolicy, AccessorFactory>> {
+    : public TensorView<std::conditional_t<detail::storage_prepares_write<StoragePolicy, ElementType>,
+                                           ElementType const, ElementType>,
+                        mutable_tensor_traits<Extents, StoragePolicy, LayoutPolicy, AccessorFactory>> {
   private:
     using traits_type = mutable_tensor_traits<Extents, StoragePolicy, LayoutPolicy, AccessorFactory>;
     using const_traits = tensor_traits<Extents, StoragePolicy, LayoutPolicy, AccessorFactory>;
-    using base_type = TensorView<ElementType, traits_type>;
+    using view_type = TensorView<ElementType, traits_type>;
+    using const_base_type = TensorView<ElementType const, traits_type>;
+    static constexpr bool prepares_write = detail::storage_prepares_write<StoragePolicy, ElementType>;
+    using base_type = std::conditional_t<prepares_write, const_base_type, view_type>;
 
   public:
     using element_type = ElementType;
@@ -44,8 +89,11 @@ class BasicTensor
 
     using storage_type = typename storage_policy::template storage_t<element_type>;
 
+    /// \brief Alignment in bytes guaranteed for the first element of the storage; see storage_alignment_v.
+    /// \details For callers to query; kernels test the alignment of the pointers they are given at run time.
+    static constexpr std::size_t alignment = storage_alignment_v<storage_policy, element_type>;
+
     using base_type::mdspan;
-    using base_type::mutable_mdspan;
 
     /// \brief Default-construct an empty tensor without allocated storage.
     BasicTensor() = default;
@@ -82,9 +130,133 @@ class BasicTensor
         : BasicTensor(internal_tag{}, make_payload(mapping_type{exts, strides}, std::move(accessor_factory)))
     {}
 
-    /// \brief Access the owned storage container.
+    /// \brief Construct a tensor with default layout whose elements are left uninitialised.
+    /// \details For a tensor that is fully overwritten before it is read, such as the output of a contraction with
+    ///          beta = 0. Only storage policies that support it, such as UninitializedStorage, skip the
+    ///          initialisation; others initialise the elements as usual.
+    /// \param exts Extents that describe the tensor shape.
+    /// \param accessor_factory Factory used to create the accessor for the storage handle.
+    BasicTensor(uninitialized_t, extents_type const& exts,
+                accessor_factory_type accessor_factory = accessor_factory_type{})
+        : BasicTensor(internal_tag{},
+                      make_payload(make_default_mapping(exts), std::move(accessor_factory), uninitialized))
+    {}
+
+    /// \brief Construct a tensor from explicit extents and strides whose elements are left uninitialised.
+    /// \param exts Extents that describe the tensor shape.
+    /// \param strides Stride specification per dimension for the layout mapping.
+    /// \param accessor_factory Factory used to create the accessor for the storage handle.
+    BasicTensor(uninitialized_t, extents_type const& exts, std::array<index_type, extents_type::rank()> const& strides,
+                accessor_factory_type accessor_factory = accessor_factory_type{})
+        : BasicTensor(internal_tag{},
+                      make_payload(mapping_type{exts, strides}, std::move(accessor_factory), uninitialized))
+    {}
+
+    /// \brief Construct a tensor with default layout over an existing storage object, such as a mapped file.
+    /// \param storage Storage holding at least as many elements as the layout requires.
+    /// \param exts Extents that describe the tensor shape.
+    /// \param accessor_factory Factory used to create the accessor for the storage handle.
+    BasicTensor(storage_type storage, extents_type const& exts,
+                accessor_factory_type accessor_factory = accessor_factory_type{})
+        : BasicTensor(internal_tag{},
+                      adopt_payload(make_default_mapping(exts), std::move(storage), std::move(accessor_factory)))
+    {}
+
+    /// \brief Construct a tensor from explicit extents and strides over an existing storage object.
+    /// \param storage Storage holding at least as many elements as the layout requires.
+    /// \param exts Extents that describe the tensor shape.
+    /// \param strides Stride specification per dimension for the layout mapping.
+    /// \param accessor_factory Factory used to create the accessor for the storage handle.
+    BasicTensor(storage_type storage, extents_type const& exts,
+                std::array<index_type, extents_type::rank()> const& strides,
+                accessor_factory_type accessor_factory = accessor_factory_type{})
+        : BasicTensor(internal_tag{},
+                      adopt_payload(mapping_type{exts, strides}, std::move(storage), std::move(accessor_factory)))
+    {}
+
+    /// \brief Copy the elements, or share them if the storage policy is reference counted.
+    BasicTensor(BasicTensor const& other) : base_type(other), data_(other.data_) { this->rebind_handle(); }
+
+    BasicTensor(BasicTensor&& other) noexcept(std::is_nothrow_move_constructible_v<storage_type>)
+        : base_type(std::move(other)), data_(std::move(other.data_))
+    {
+      this->rebind_handle();
+    }
+
+    BasicTensor& operator=(BasicTensor const& other)
+    {
+      if (this != &other)
+      {
+        base_type::operator=(other);
+        data_ = other.data_;
+        this->rebind_handle();
+      }
+      return *this;
+    }
+
+    BasicTensor& operator=(BasicTensor&& other) noexcept(std::is_nothrow_move_assignable_v<storage_type>)
+    {
+      if (this != &other)
+      {
+        base_type::operator=(std::move(other));
+        data_ = std::move(other.data_);
+        this->rebind_handle();
+      }
+      return *this;
+    }
+
+    /// \brief Mutable element access; detaches shared storage first.
+    template <typename... Idx>
+    requires(sizeof...(Idx) == extents_type::rank()) auto operator[](Idx... idxs) -> typename view_type::reference
+    {
+      this->prepare_write();
+      return this->unchecked_view()[idxs...];
+    }
+
+    /// \brief Read-only element access.
+    template <typename... Idx>
+    requires(sizeof...(Idx) == extents_type::rank()) auto operator[](Idx... idxs) const ->
+        typename const_base_type::reference
+    {
+      return const_base_type::operator[](idxs...);
+    }
+
+    /// \brief Mutable mdspan of the elements; detaches shared storage first.
+    auto mutable_mdspan() -> typename view_type::mdspan_type
+    {
+      this->prepare_write();
+      return this->unchecked_view().mutable_mdspan();
+    }
+
+    /// \brief Mutable handle to the elements; detaches shared storage first.
+    [[nodiscard]] auto mutable_handle() -> typename view_type::mutable_handle_type
+    {
+      this->prepare_write();
+      return this->mutable_handle_ref();
+    }
+
+    /// \brief Mutable strided view of the elements; detaches shared storage first. See TensorView::remap().
+    template <typename NewExtents>
+    [[nodiscard]] auto remap(index_type offset, stdex::layout_stride::mapping<NewExtents> const& mapping)
+    {
+      this->prepare_write();
+      return this->unchecked_view().remap(offset, mapping);
+    }
+
+    /// \brief Read-only strided view of the elements. See TensorView::remap().
+    template <typename NewExtents>
+    [[nodiscard]] auto remap(index_type offset, stdex::layout_stride::mapping<NewExtents> const& mapping) const
+    {
+      return const_base_type::remap(offset, mapping);
+    }
+
+    /// \brief Access the owned storage container; detaches shared storage first.
     /// \return Mutable reference to the underlying storage.
-    [[nodiscard]] storage_type& storage() noexcept { return data_; }
+    [[nodiscard]] storage_type& storage()
+    {
+      this->prepare_write();
+      return data_;
+    }
 
     /// \brief Access the owned storage container.
     /// \return Constant reference to the underlying storage.
@@ -92,10 +264,10 @@ class BasicTensor
 
     /// \brief Create a mutable tensor view referencing the owned storage.
     /// \return TensorView exposing mutable element access with the current mapping and accessor.
-    [[nodiscard]] auto view() noexcept -> TensorView<element_type, traits_type>
+    [[nodiscard]] auto view() -> view_type
     {
-      return TensorView<element_type, traits_type>(storage_policy::make_handle(data_), this->mapping(),
-                                                   this->accessor());
+      this->prepare_write();
+      return this->unchecked_view();
     }
 
     /// \brief Create a const tensor view referencing the owned storage.
@@ -103,17 +275,48 @@ class BasicTensor
     [[nodiscard]] auto view() const noexcept -> TensorView<element_type const, const_traits>
     {
       return TensorView<element_type const, const_traits>(storage_policy::make_handle(const_cast<storage_type&>(data_)),
-                                                          this->mapping(), this->accessor());
+                                                          this->mapping(), this->mutable_accessor_ref());
     }
 
     /// \brief Create a const tensor view alias for readability.
     /// \return TensorView exposing read-only access with the current mapping and accessor.
     [[nodiscard]] auto const_view() const noexcept -> TensorView<element_type const, const_traits> { return view(); }
 
+    /// \brief Read-only view that shares ownership of the elements, for reference-counted storage such as
+    ///        SharedStorage.
+    /// \details The view stays valid after the tensor is destroyed. It keeps showing the elements as they were when
+    ///          it was made: since the view shares them, modifying the tensor afterwards detaches the tensor instead.
+    [[nodiscard]] auto shared_view() const
+        -> RetainingView<TensorView<element_type const, const_traits>, storage_type>
+    requires requires(storage_type const& s) { s.use_count(); }
+    {
+      return {this->view(), data_};
+    }
+
   private:
     struct internal_tag
     {};
 
+    /// \brief Point the handle of the view base at the first element of the owned storage.
+    void rebind_handle() noexcept { this->mutable_handle_ref() = storage_policy::make_handle(data_); }
+
+    /// \brief Mutable view of the elements, without preparing them for modification.
+    view_type unchecked_view() noexcept
+    {
+      return view_type(this->mutable_handle_ref(), this->mapping(), this->mutable_accessor_ref());
+    }
+
+    /// \brief Let the storage policy prepare the elements for modification, for example by detaching shared
+    ///        storage; a no-op for policies without a \c prepare_write(storage), which returns whether the elements
+    ///        moved.
+    void prepare_write()
+    {
+      if constexpr (prepares_write)
+      {
+        if (storage_policy::prepare_write(data_)) this->rebind_handle();
+      }
+    }
+
     struct ctor_payload
     {
         mapping_type mapping;
@@ -133,6 +336,29 @@ class BasicTensor
       return ctor_payload{std::move(mapping), std::move(storage), std::move(accessor_factory)};
     }
 
+    static ctor_payload adopt_payload(mapping_type mapping, storage_type storage,
+                                      accessor_factory_type accessor_factory)
+    {
+      PRECONDITION(static_cast<std::size_t>(mapping.required_span_size()) <= std::size(storage),
+                   "BasicTensor: storage is smaller than the layout requires", mapping.required_span_size(),
+                   std::size(storage));
+      return ctor_payload{std::move(mapping), std::move(storage), std::move(accessor_factory)};
+    }
+
+    static ctor_payload make_payload(mapping_type mapping, accessor_factory_type accessor_factory, uninitialized_t)
+    {
+      auto const span_size = static_cast<size_type>(mapping.required_span_size());
+      if constexpr (std::is_constructible_v<storage_type, std::size_t, uninitialized_t>)
+      {
+        storage_type storage(static_cast<std::size_t>(span_size), uninitialized);
+        return ctor_payload{std::move(mapping), std::move(storage), std::move(accessor_factory)};
+      }
+      else
+      {
+        return make_payload(std::move(mapping), std::move(accessor_factory));
+      }
+    }
+
     static storage_type make_storage(mapping_type const& mapping)
     {
       auto const span_size = static_cast<size_type>(mapping.required_span_size());
@@ -0,0 +1,819 @@
+#pragma once
+
+/**
+ * \file expression.hpp
+ * \ingroup tensor
+ * \brief Lazy tensor expressions: elementwise arithmetic, scaling, conjugation, permutation and contraction.
+ * \details The operators and functions below take TensorView and BasicTensor operands and build an expression tree
+ *          that references the operands without evaluating anything. assign() lowers the tree onto a destination
+ *          tensor. The terms of a top-level sum that are scaled contractions are accumulated straight into the
+ *          destination by kernel::contract(), and the rest of the sum is evaluated in one fused level-1 pass over its
+ *          leaves. Scaling and conjugation of a contraction operand are folded into the kernel call. A temporary is
+ *          allocated only where a contraction is nested inside an elementwise operation, or is itself an operand of
+ *          a contraction, and for an operand that overlaps the destination other than element for element.
+ *
+ *          Permutation is resolved at construction: permuting a leaf permutes its strides, and permuting a
+ *          contraction permutes its output legs. A permuted tensor assigned on its own is copied by the tiled
+ *          level-1 permute kernel.
+ */
+
+#include "basic_tensor.hpp"
+#include "tensor_view.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/core/math.hpp>
+#include <uni20/core/scalar_concepts.hpp>
+#include <uni20/core/types.hpp>
+#include <uni20/kernel/contract.hpp>
+#include <uni20/level1/assign.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/level1/flatten.hpp>
+#include <uni20/level1/permute.hpp>
+#include <uni20/mdspan/concepts.hpp>
+#include <uni20/mdspan/iteration_plan.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uni20
+{
+
+template <typename T, std::size_t R> class TensorRef;
+template <typename F, typename... Children> class MapExpr;
+template <typename L, typename Rt, std::size_t N> class ContractExpr;
+
+/// \brief True for the node types of a tensor expression.
+/// \ingroup tensor
+template <typename E> struct is_tensor_expression : std::false_type
+{};
+
+template <typename T, std::size_t R> struct is_tensor_expression<TensorRef<T, R>> : std::true_type
+{};
+
+template <typename F, typename... Children> struct is_tensor_expression<MapExpr<F, Children...>> : std::true_type
+{};
+
+template <typename L, typename Rt, std::size_t N>
+struct is_tensor_expression<ContractExpr<L, Rt, N>> : std::true_type
+{};
+
+/// \brief Variable form of is_tensor_expression.
+/// \ingroup tensor
+template <typename E> inline constexpr bool is_tensor_expression_v = is_tensor_expression<E>::value;
+
+/// \concept TensorExpression
+/// \brief A node of a lazy tensor expression.
+/// \ingroup tensor
+template <typename E>
+concept TensorExpression = is_tensor_expression_v<std::remove_cvref_t<E>>;
+
+/// \concept TensorLike
+/// \brief A TensorView or BasicTensor, which exposes its elements as a strided mdspan.
+/// \ingroup tensor
+template <typename E>
+concept TensorLike = requires(std::remove_cvref_t<E> const& t)
+{
+  typename std::remove_cvref_t<E>::default_tag;
+  {
+    t.mdspan()
+    } -> StridedMdspan;
+};
+
+/// \concept MutableTensorLike
+/// \brief A TensorView or BasicTensor with mutable elements, usable as the destination of assign().
+/// \ingroup tensor
+template <typename E>
+concept MutableTensorLike = TensorLike<E> && requires(std::remove_cvref_t<E>& t)
+{
+  {
+    t.mutable_mdspan()
+    } -> MutableStridedMdspan;
+};
+
+/// \concept TensorOperand
+/// \brief A valid operand of the expression operators: an expression node or a tensor.
+/// \ingroup tensor
+template <typename E>
+concept TensorOperand = TensorExpression<E> || TensorLike<E>;
+
+/// \brief Leaf of a tensor expression: a read-only strided view of the elements of a tensor.
+/// \tparam T Value type of the elements.
+/// \tparam R Rank of the tensor.
+/// \ingroup tensor
+template <typename T, std::size_t R> class TensorRef {
+  public:
+    using value_type = T;
+    using extents_type = stdex::dextents<index_type, R>;
+    using mdspan_type = stdex::mdspan<T const, extents_type, stdex::layout_stride>;
+
+    /// \brief Construct from the strided view of the elements.
+    explicit TensorRef(mdspan_type span) : span_(std::move(span)) {}
+
+    static constexpr std::size_t rank() noexcept { return R; }
+
+    /// \brief The extents of the tensor.
+    [[nodiscard]] extents_type const& extents() const noexcept { return span_.extents(); }
+
+    /// \brief The strided view of the elements.
+    [[nodiscard]] mdspan_type const& mdspan() const noexcept { return span_; }
+
+    /// \brief The same elements with axis \c i of the result taken from axis \c perm[i].
+    [[nodiscard]] TensorRef permuted(std::array<std::size_t, R> const& perm) const
+    {
+      std::array<index_type, R> extents{};
+      std::array<index_type, R> strides{};
+      for (std::size_t r = 0; r < R; ++r)
+      {
+        extents[r] = span_.extent(perm[r]);
+        strides[r] = span_.stride(perm[r]);
+      }
+      return TensorRef(
+          mdspan_type(span_.data_handle(), typename mdspan_type::mapping_type(extents_type(extents), strides)));
+    }
+
+  private:
+    mdspan_type span_;
+};
+
+/// \brief Elementwise node of a tensor expression: \p F applied to the corresponding elements of its children.
+/// \tparam F        Functor applied to one element of each child.
+/// \tparam Children Expression node types of the children, all of the same rank.
+/// \ingroup tensor
+template <typename F, typename... Children> class MapExpr {
+    static_assert(sizeof...(Children) > 0, "MapExpr: at least one child is required");
+    using first_type = std::tuple_element_t<0, std::tuple<Children...>>;
+    static_assert(((Children::rank() == first_type::rank()) && ...), "tensor expression: rank mismatch");
+
+  public:
+    using value_type = std::remove_cvref_t<std::invoke_result_t<F const&, typename Children::value_type const&...>>;
+    using extents_type = stdex::dextents<index_type, first_type::rank()>;
+
+    /// \brief Construct from the functor and the children, which must all have the same extents.
+    MapExpr(F f, Children... children) : f_(std::move(f)), children_(std::move(children)...)
+    {
+      std::apply(
+          [](auto const& c0, auto const&... c) {
+            (
+                [&] {
+                  PRECONDITION_EQUAL(c0.extents(), c.extents(), "tensor expression: shape mismatch");
+                }(),
+                ...);
+          },
+          children_);
+    }
+
+    static constexpr std::size_t rank() noexcept { return first_type::rank(); }
+
+    /// \brief The extents of the result.
+    [[nodiscard]] extents_type extents() const { return std::get<0>(children_).extents(); }
+
+    /// \brief The elementwise functor.
+    [[nodiscard]] F const& func() const noexcept { return f_; }
+
+    /// \brief The child nodes.
+    [[nodiscard]] std::tuple<Children...> const& children() const noexcept { return children_; }
+
+    /// \brief The same expression with axis \c i of the result taken from axis \c perm[i].
+    [[nodiscard]] MapExpr permuted(std::array<std::size_t, rank()> const& perm) const
+    {
+      return std::apply([&](auto const&... c) { return MapExpr(f_, c.permuted(perm)...); }, children_);
+    }
+
+  private:
+    F f_;
+    std::tuple<Children...> children_;
+};
+
+/// \brief Contraction node of a tensor expression.
+/// \details The natural order of the result legs is the uncontracted legs of the left operand followed by those of
+///          the right operand, as for kernel::contract(); axis \c i of the result is natural leg \c perm()[i].
+/// \tparam L  Expression node type of the left operand.
+/// \tparam Rt Expression node type of the right operand.
+/// \tparam N  Number of contracted pairs of legs.
+/// \ingroup tensor
+template <typename L, typename Rt, std::size_t N> class ContractExpr {
+    static_assert(std::is_same_v<typename L::value_type, typename Rt::value_type>,
+                  "contract: operands must have the same value type");
+    static_assert(L::rank() >= N && Rt::rank() >= N, "contract: more contracted pairs than legs");
+
+  public:
+    using value_type = typename L::value_type;
+    using extents_type = stdex::dextents<index_type, L::rank() + Rt::rank() - 2 * N>;
+    using dims_type = std::array<std::pair<std::size_t, std::size_t>, N>;
+    using perm_type = std::array<std::size_t, L::rank() + Rt::rank() - 2 * N>;
+
+    /// \brief Construct from the operands and the pairs (left leg, right leg) of contracted legs.
+    ContractExpr(L left, Rt right, dims_type const& dims)
+        : left_(std::move(left)), right_(std::move(right)), dims_(dims)
+    {
+      std::array<bool, L::rank()> left_used{};
+      std::array<bool, Rt::rank()> right_used{};
+      for (auto [a, b] : dims_)
+      {
+        PRECONDITION(a < L::rank() && b < Rt::rank(), "contract: leg out of range", a, b);
+        PRECONDITION(!left_used[a] && !right_used[b], "contract: leg contracted twice", a, b);
+        PRECONDITION_EQUAL(left_.extents().extent(a), right_.extents().extent(b), "contract: extent mismatch", a, b);
+        left_used[a] = right_used[b] = true;
+      }
+      for (std::size_t i = 0; i < rank(); ++i)
+        perm_[i] = i;
+    }
+
+    static constexpr std::size_t rank() noexcept { return L::rank() + Rt::rank() - 2 * N; }
+
+    /// \brief The extents of the result.
+    [[nodiscard]] extents_type extents() const
+    {
+      auto const natural = natural_extents();
+      std::array<index_type, rank()> extents{};
+      for (std::size_t i = 0; i < rank(); ++i)
+        extents[i] = natural[perm_[i]];
+      return extents_type(extents);
+    }
+
+    /// \brief The left operand.
+    [[nodiscard]] L const& left() const noexcept { return left_; }
+
+    /// \brief The right operand.
+    [[nodiscard]] Rt const& right() const noexcept { return right_; }
+
+    /// \brief The pairs of contracted legs.
+    [[nodiscard]] dims_type const& dims() const noexcept { return dims_; }
+
+    /// \brief The natural leg of each axis of the result.
+    [[nodiscard]] perm_type const& perm() const noexcept { return perm_; }
+
+    /// \brief The same contraction with axis \c i of the result taken from axis \c perm[i].
+    [[nodiscard]] ContractExpr permuted(perm_type const& perm) const
+    {
+      ContractExpr result = *this;
+      for (std::size_t i = 0; i < rank(); ++i)
+        result.perm_[i] = perm_[perm[i]];
+      return result;
+    }
+
+  private:
+    std::array<index_type, rank()> natural_extents() const
+    {
+      std::array<bool, L::rank()> left_used{};
+      std::array<bool, Rt::rank()> right_used{};
+      for (auto [a, b] : dims_)
+        left_used[a] = right_used[b] = true;
+      std::array<index_type, rank()> extents{};
+      std::size_t next = 0;
+      for (std::size_t a = 0; a < L::rank(); ++a)
+        if (!left_used[a]) extents[next++] = left_.extents().extent(a);
+      for (std::size_t b = 0; b < Rt::rank(); ++b)
+        if (!right_used[b]) extents[next++] = right_.extents().extent(b);
+      return extents;
+    }
+
+    L left_;
+    Rt right_;
+    dims_type dims_;
+    perm_type perm_{};
+};
+
+namespace detail
+{
+
+/// \brief Elementwise functor of scaling by \p s.
+/// \ingroup internal
+template <typename S> struct scale_by
+{
+    S s;
+
+    template <typename T> constexpr auto operator()(T const& x) const { return s * x; }
+};
+
+/// \brief Elementwise functor of complex conjugation.
+/// \ingroup internal
+struct conj_elements
+{
+    template <typename T> constexpr auto operator()(T const& x) const { return uni20::conj(x); }
+};
+
+} // namespace detail
+
+/// \brief View a tensor as the leaf of an expression; an expression node is returned unchanged.
+/// \ingroup tensor
+template <TensorOperand E> auto as_expression(E const& e)
+{
+  if constexpr (TensorExpression<E>)
+  {
+    return e;
+  }
+  else
+  {
+    auto m = e.mdspan();
+    using M = decltype(m);
+    static_assert(detail::is_default_accessor<typename M::accessor_type>,
+                  "tensor expression: operands must use the default accessor");
+    using leaf_type = TensorRef<typename M::value_type, M::rank()>;
+    return leaf_type(typename leaf_type::mdspan_type(m.data_handle(), detail::dynamic_stride_mapping(m)));
+  }
+}
+
+/// \brief Lazy elementwise sum.
+/// \ingroup tensor
+template <TensorOperand A, TensorOperand B> auto operator+(A const& a, B const& b)
+{
+  return MapExpr(std::plus<>{}, as_expression(a), as_expression(b));
+}
+
+/// \brief Lazy elementwise difference.
+/// \ingroup tensor
+template <TensorOperand A, TensorOperand B> auto operator-(A const& a, B const& b)
+{
+  return MapExpr(std::minus<>{}, as_expression(a), as_expression(b));
+}
+
+/// \brief Lazy elementwise negation.
+/// \ingroup tensor
+template <TensorOperand A> auto operator-(A const& a) { return MapExpr(std::negate<>{}, as_expression(a)); }
+
+/// \brief Lazy scaling by a scalar.
+/// \ingroup tensor
+template <Scalar S, TensorOperand A> auto operator*(S const& s, A const& a)
+{
+  return MapExpr(detail::scale_by<S>{s}, as_expression(a));
+}
+
+/// \brief Lazy scaling by a scalar.
+/// \ingroup tensor
+template <TensorOperand A, Scalar S> auto operator*(A const& a, S const& s)
+{
+  return MapExpr(detail::scale_by<S>{s}, as_expression(a));
+}
+
+/// \brief Lazy elementwise (Hadamard) product.
+/// \ingroup tensor
+template <TensorOperand A, TensorOperand B> auto hadamard(A const& a, B const& b)
+{
+  return MapExpr(std::multiplies<>{}, as_expression(a), as_expression(b));
+}
+
+/// \brief Lazy contraction of \p a with \p b over the pairs (leg of a, leg of b) in \p dims.
+/// \details The legs of the result are the uncontracted legs of \p a followed by those of \p b.
+/// \ingroup tensor
+template <TensorOperand A, TensorOperand B, std::size_t N>
+auto contract(A const& a, B const& b, std::array<std::pair<std::size_t, std::size_t>, N> const& dims)
+{
+  auto left = as_expression(a);
+  auto right = as_expression(b);
+  return ContractExpr<decltype(left), decltype(right), N>(std::move(left), std::move(right), dims);
+}
+
+/// \brief Lazy contraction, with the pairs of contracted legs given as a braced list.
+/// \ingroup tensor
+template <TensorOperand A, TensorOperand B, std::size_t N>
+auto contract(A const& a, B const& b, std::pair<std::size_t, std::size_t> const (&dims)[N])
+{
+  return uni20::contract(a, b, std::to_array(dims));
+}
+
+/// \brief Lazy complex conjugation; the conjugate of a contraction is the contraction of the conjugates.
+/// \ingroup tensor
+template <TensorOperand A> auto conj(A const& a)
+{
+  auto e = as_expression(a);
+  using E = decltype(e);
+  if constexpr (requires { e.dims(); })
+  {
+    auto left = uni20::conj(e.left());
+    auto right = uni20::conj(e.right());
+    constexpr std::size_t N = std::tuple_size_v<typename E::dims_type>;
+    return ContractExpr<decltype(left), decltype(right), N>(std::move(left), std::move(right), e.dims())
+        .permuted(e.perm());
+  }
+  else
+  {
+    return MapExpr(detail::conj_elements{}, std::move(e));
+  }
+}
+
+/// \brief Lazy permutation: axis \c i of the result is axis \c perm[i] of \p a.
+/// \details Resolved immediately into the strides of the leaves and the leg order of the contractions, so it costs
+///          nothing at evaluation.
+/// \ingroup tensor
+template <TensorOperand A, std::size_t R> auto permute(A const& a, std::array<std::size_t, R> const& perm)
+{
+  auto e = as_expression(a);
+  static_assert(decltype(e)::rank() == R, "permute: permutation length must equal the rank");
+  std::array<bool, R> seen{};
+  for (std::size_t axis : perm)
+  {
+    PRECONDITION(axis < R && !seen[axis], "permute: not a permutation", axis);
+    seen[axis] = true;
+  }
+  return e.permuted(perm);
+}
+
+namespace detail
+{
+
+/// \brief Owner of the temporaries allocated while an expression is assigned.
+/// \ingroup internal
+class expression_workspace {
+  public:
+    /// \brief Allocate a row-major temporary of the given extents.
+    template <typename T, std::size_t R>
+    stdex::mdspan<T, stdex::dextents<index_type, R>, stdex::layout_stride>
+    allocate(stdex::dextents<index_type, R> const& extents)
+    {
+      auto mapping = layout::LayoutRight{}(extents);
+      auto buffer = std::make_shared<std::vector<T>>(std::size_t(mapping.required_span_size()));
+      buffers_.push_back(buffer);
+      return {buffer->data(), mapping};
+    }
+
+    /// \brief Number of temporaries allocated so far.
+    [[nodiscard]] std::size_t size() const noexcept { return buffers_.size(); }
+
+  private:
+    std::vector<std::shared_ptr<void>> buffers_;
+};
+
+/// \brief Half-open range of byte addresses spanned by the elements of \p s; empty if \p s has no elements.
+/// \ingroup internal
+template <StridedMdspan S> std::pair<std::uintptr_t, std::uintptr_t> address_range(S const& s)
+{
+  if (s.size() == 0) return {0, 0};
+  std::ptrdiff_t lo = 0, hi = 0;
+  for (std::size_t r = 0; r < S::rank(); ++r)
+  {
+    std::ptrdiff_t const span = std::ptrdiff_t(s.extent(r) - 1) * std::ptrdiff_t(s.stride(r));
+    (span < 0 ? lo : hi) += span;
+  }
+  constexpr std::ptrdiff_t size = sizeof(typename S::element_type);
+  auto const base = reinterpret_cast<std::uintptr_t>(s.data_handle());
+  return {base + std::uintptr_t(lo * size), base + std::uintptr_t((hi + 1) * size)};
+}
+
+/// \brief True if \p a and \p b may share an element.
+/// \ingroup internal
+template <StridedMdspan S1, StridedMdspan S2> bool overlaps(S1 const& a, S2 const& b)
+{
+  auto const [a_lo, a_hi] = address_range(a);
+  auto const [b_lo, b_hi] = address_range(b);
+  return a_lo < b_hi && b_lo < a_hi;
+}
+
+/// \brief True if \p a and \p b address the same element at every multi-index.
+/// \ingroup internal
+template <StridedMdspan S1, StridedMdspan S2> bool same_elements(S1 const& a, S2 const& b)
+{
+  if constexpr (S1::rank() != S2::rank())
+  {
+    return false;
+  }
+  else
+  {
+    if (static_cast<void const*>(a.data_handle()) != static_cast<void const*>(b.data_handle())) return false;
+    for (std::size_t r = 0; r < S1::rank(); ++r)
+      if (a.extent(r) != b.extent(r) || (a.extent(r) > 1 && a.stride(r) != b.stride(r))) return false;
+    return true;
+  }
+}
+
+/// \brief \p ref, or a copy of it if it overlaps \p out and is not \p out itself (when \p allow_same is set).
+/// \ingroup internal
+template <typename T, std::size_t R, StridedMdspan Out>
+TensorRef<T, R> unaliased(TensorRef<T, R> const& ref, Out const& out, expression_workspace& ws, bool allow_same)
+{
+  auto const& s = ref.mdspan();
+  if (!overlaps(s, out) || (allow_same && same_elements(s, out))) return ref;
+  auto copy = ws.template allocate<T, R>(s.extents());
+  uni20::assign(s, copy);
+  return TensorRef<T, R>(typename TensorRef<T, R>::mdspan_type(copy));
+}
+
+/// \brief Evaluate \p e into \p out, allocating any temporaries in \p ws.
+/// \ingroup internal
+template <ExecutionPolicy Policy, typename Tag, typename E, MutableStridedMdspan Out>
+void evaluate_into(Policy const& policy, Tag tag, E const& e, Out out, expression_workspace& ws);
+
+/// \brief Evaluate \p e into a new temporary in \p ws and return it as a leaf.
+/// \ingroup internal
+template <ExecutionPolicy Policy, typename Tag, typename E>
+auto evaluate_temporary(Policy const& policy, Tag tag, E const& e, expression_workspace& ws)
+{
+  using T = typename E::value_type;
+  constexpr std::size_t R = E::rank();
+  auto t = ws.template allocate<T, R>(e.extents());
+  evaluate_into(policy, tag, e, t, ws);
+  return TensorRef<T, R>(typename TensorRef<T, R>::mdspan_type(t));
+}
+
+/// \brief Lower an expression with no top-level contraction term to its leaves and an evaluator, numbering the
+///        leaves from \p First; see flatten_expression().
+/// \ingroup internal
+template <std::size_t First, ExecutionPolicy Policy, typename Tag, typename E, StridedMdspan Out>
+auto lower_expression(Policy const& policy, Tag tag, E const& e, Out const& out, expression_workspace& ws);
+
+/// \brief Lower the children of a node, numbering their leaves consecutively from \p First.
+/// \ingroup internal
+template <std::size_t First, ExecutionPolicy Policy, typename Tag, typename Children, StridedMdspan Out>
+auto lower_children(Policy const& policy, Tag tag, Children const& children, Out const& out, expression_workspace& ws)
+{
+  if constexpr (std::tuple_size_v<Children> == 0)
+  {
+    return std::pair{std::tuple{}, std::tuple{}};
+  }
+  else
+  {
+    auto head = lower_expression<First>(policy, tag, std::get<0>(children), out, ws);
+    constexpr std::size_t next = First + std::tuple_size_v<decltype(head.first)>;
+    auto rest = std::apply([](auto const&, auto const&... c) { return std::tie(c...); }, children);
+    auto tail = lower_children<next>(policy, tag, rest, out, ws);
+    return std::pair{std::tuple_cat(head.first, tail.first), std::tuple_cat(std::tuple{head.second}, tail.second)};
+  }
+}
+
+template <std::size_t First, ExecutionPolicy Policy, typename Tag, typename E, StridedMdspan Out>
+auto lower_expression(Policy const& policy, Tag tag, E const& e, Out const& out, expression_workspace& ws)
+{
+  if constexpr (requires { e.children(); })
+  {
+    auto lowered = lower_children<First>(policy, tag, e.children(), out, ws);
+    return std::apply(
+        [&](auto const&... c) {
+          using F = std::remove_cvref_t<decltype(e.func())>;
+          return std::pair{lowered.first, node_eval<F, std::remove_cvref_t<decltype(c)>...>{e.func(), {c...}}};
+        },
+        lowered.second);
+  }
+  else if constexpr (requires { e.dims(); })
+  {
+    // contraction boundary: the contraction is evaluated into a temporary, which becomes a leaf
+    return std::pair{std::tuple{evaluate_temporary(policy, tag, e, ws).mdspan()}, leaf_eval<First>{}};
+  }
+  else
+  {
+    return std::pair{std::tuple{unaliased(e, out, ws, true).mdspan()}, leaf_eval<First>{}};
+  }
+}
+
+/// \brief Operand of a contraction as passed to kernel::contract(): the leaf, a scale factor and a conjugation flag.
+/// \ingroup internal
+template <typename T, std::size_t R> struct contraction_operand
+{
+    TensorRef<T, R> ref;
+    T factor;
+    bool conj;
+};
+
+/// \brief Resolve an operand of a contraction; any operand that is not a leaf, scaled or conjugated, is
+///        evaluated into a temporary.
+/// \ingroup internal
+template <ExecutionPolicy Policy, typename Tag, typename E, StridedMdspan Out>
+auto resolve_operand(Policy const& policy, Tag tag, E const& e, Out const& out, expression_workspace& ws)
+    -> contraction_operand<typename E::value_type, E::rank()>
+{
+  using T = typename E::value_type;
+  if constexpr (std::is_same_v<E, TensorRef<T, E::rank()>>)
+  {
+    return {unaliased(e, out, ws, false), T(1), false};
+  }
+  else if constexpr (requires { e.children(); } && std::tuple_size_v<std::remove_cvref_t<decltype(e.children())>> == 1)
+  {
+    using C = std::tuple_element_t<0, std::remove_cvref_t<decltype(e.children())>>;
+    using F = std::remove_cvref_t<decltype(e.func())>;
+    if constexpr (std::is_same_v<typename C::value_type, T>)
+    {
+      if constexpr (std::is_same_v<F, std::negate<>>)
+      {
+        auto op = resolve_operand(policy, tag, std::get<0>(e.children()), out, ws);
+        op.factor = -op.factor;
+        return op;
+      }
+      else if constexpr (std::is_same_v<F, conj_elements>)
+      {
+        auto op = resolve_operand(policy, tag, std::get<0>(e.children()), out, ws);
+        op.factor = uni20::conj(op.factor);
+        op.conj = !op.conj;
+        return op;
+      }
+      else if constexpr (requires { e.func().s; })
+      {
+        auto op = resolve_operand(policy, tag, std::get<0>(e.children()), out, ws);
+        op.factor = T(e.func().s) * op.factor;
+        return op;
+      }
+    }
+    return {evaluate_temporary(policy, tag, e, ws), T(1), false};
+  }
+  else
+  {
+    return {evaluate_temporary(policy, tag, e, ws), T(1), false};
+  }
+}
+
+/// \brief Placeholder for the empty elementwise part of a sum.
+/// \ingroup internal
+struct no_rest
+{};
+
+/// \brief A contraction term of a sum, with its scale factor.
+/// \ingroup internal
+template <typename C, typename V> struct contraction_term
+{
+    C const* expr;
+    V factor;
+};
+
+/// \brief Combine the elementwise parts of the children of a sum node.
+/// \ingroup internal
+template <typename F, typename X, typename Y> auto combine_rest(F f, X x, Y y)
+{
+  if constexpr (std::is_same_v<Y, no_rest>)
+    return x;
+  else if constexpr (std::is_same_v<X, no_rest> && std::is_same_v<F, std::minus<>>)
+    return MapExpr(std::negate<>{}, std::move(y));
+  else if constexpr (std::is_same_v<X, no_rest>)
+    return y;
+  else
+    return MapExpr(f, std::move(x), std::move(y));
+}
+
+/// \brief Split f·\p e into f·rest + Σ terms, where each term is a contraction of value type \p V that
+///        kernel::contract() can accumulate into the destination, and rest is the elementwise remainder.
+/// \details Sums, differences, negation and scaling are split through; any other node is part of the rest.
+/// \return Pair of the rest, or no_rest, and the tuple of contraction_term.
+/// \ingroup internal
+template <typename V, typename E> auto split_sum(E const& e, V factor)
+{
+  if constexpr (requires { e.dims(); } && std::is_same_v<typename E::value_type, V>)
+  {
+    return std::pair{no_rest{}, std::tuple{contraction_term<E, V>{&e, factor}}};
+  }
+  else if constexpr (requires { e.children(); } && std::is_same_v<typename E::value_type, V>)
+  {
+    using F = std::remove_cvref_t<decltype(e.func())>;
+    auto const& children = e.children();
+    if constexpr (std::is_same_v<F, std::plus<>> || std::is_same_v<F, std::minus<>>)
+    {
+      auto x = split_sum(std::get<0>(children), factor);
+      auto y = split_sum(std::get<1>(children), std::is_same_v<F, std::plus<>> ? factor : V(-factor));
+      return std::pair{combine_rest(F{}, std::move(x.first), std::move(y.first)), std::tuple_cat(x.second, y.second)};
+    }
+    else if constexpr (std::is_same_v<F, std::negate<>> || requires { e.func().s; })
+    {
+      auto x = [&] {
+        if constexpr (std::is_same_v<F, std::negate<>>)
+          return split_sum(std::get<0>(children), V(-factor));
+        else
+          return split_sum(std::get<0>(children), V(factor * V(e.func().s)));
+      }();
+      if constexpr (std::is_same_v<decltype(x.first), no_rest>)
+        return x;
+      else
+        return std::pair{MapExpr(e.func(), std::move(x.first)), std::move(x.second)};
+    }
+    else
+    {
+      return std::pair{e, std::tuple{}};
+    }
+  }
+  else
+  {
+    return std::pair{e, std::tuple{}};
+  }
+}
+
+/// \brief A contraction term whose operands have been resolved, ready for kernel::contract().
+/// \ingroup internal
+template <typename V, typename A, typename B, typename Dims, typename Perm> struct prepared_contraction
+{
+    A a;
+    B b;
+    Dims dims;
+    Perm perm;
+    V factor;
+};
+
+/// \brief Resolve the operands of a contraction term against the destination \p out.
+/// \ingroup internal
+template <ExecutionPolicy Policy, typename Tag, typename C, typename V, StridedMdspan Out>
+auto prepare_contraction(Policy const& policy, Tag tag, contraction_term<C, V> const& term, Out const& out,
+                         expression_workspace& ws)
+{
+  auto a = resolve_operand(policy, tag, term.expr->left(), out, ws);
+  auto b = resolve_operand(policy, tag, term.expr->right(), out, ws);
+  return prepared_contraction<V, decltype(a), decltype(b), typename C::dims_type, typename C::perm_type>{
+      std::move(a), std::move(b), term.expr->dims(), term.expr->perm(), term.factor};
+}
+
+/// \brief out = beta·out + term, through kernel::contract().
+/// \ingroup internal
+template <typename V, typename A, typename B, typename Dims, typename Perm, MutableStridedMdspan Out, typename Tag>
+void run_contraction(prepared_contraction<V, A, B, Dims, Perm> const& p, V beta, Out out, Tag tag)
+{
+  // present the output in the natural leg order of the contraction
+  constexpr std::size_t R = Out::rank();
+  using extents_type = stdex::dextents<index_type, R>;
+  std::array<index_type, R> extents{};
+  std::array<index_type, R> strides{};
+  for (std::size_t i = 0; i < R; ++i)
+  {
+    extents[p.perm[i]] = out.extent(i);
+    strides[p.perm[i]] = out.stride(i);
+  }
+  stdex::mdspan<typename Out::element_type, extents_type, stdex::layout_stride> natural(
+      out.data_handle(), stdex::layout_stride::mapping<extents_type>(extents_type(extents), strides));
+
+  kernel::contract(p.factor * p.a.factor * p.b.factor, p.a.ref.mdspan(), p.b.ref.mdspan(), p.dims, beta, natural, tag,
+                   kernel::contract_options<>{.conj_a = p.a.conj, .conj_b = p.b.conj});
+}
+
+template <ExecutionPolicy Policy, typename Tag, typename E, MutableStridedMdspan Out>
+void evaluate_into(Policy const& policy, Tag tag, E const& e, Out out, expression_workspace& ws)
+{
+  using V = std::remove_const_t<typename Out::element_type>;
+
+  auto split = split_sum(e, V(1));
+  using rest_type = decltype(split.first);
+
+  // resolve the contraction operands before the destination is written
+  auto prepared = std::apply(
+      [&](auto const&... term) { return std::tuple{prepare_contraction(policy, tag, term, out, ws)...}; },
+      split.second);
+
+  V beta{};
+  if constexpr (!std::is_same_v<rest_type, no_rest>)
+  {
+    auto lowered = lower_expression<0>(policy, tag, split.first, out, ws);
+    if constexpr (std::is_same_v<rest_type, TensorRef<typename rest_type::value_type, rest_type::rank()>>)
+    {
+      // a lone tensor, permuted or not, is copied by the tiled permute kernel
+      permute_aligned(policy, std::get<0>(lowered.first), out,
+                      simd::simd_op{[](auto const&, auto const& x) { return x; }});
+    }
+    else
+    {
+      assign_flattened(policy, lowered.first, lowered.second, out);
+    }
+    beta = V(1);
+  }
+  std::apply(
+      [&](auto const&... p) {
+        (
+            [&] {
+              run_contraction(p, beta, out, tag);
+              beta = V(1);
+            }(),
+            ...);
+      },
+      prepared);
+}
+
+} // namespace detail
+
+/// \brief Evaluate a tensor expression into \p dst.
+/// \details Contraction terms of a top-level sum are accumulated into \p dst by kernel::contract() for the backend
+///          of \p dst, and the rest of the sum is evaluated in one fused pass under \p policy. \p dst may appear in
+///          the expression.
+/// \tparam Policy Execution policy of the elementwise passes, \ref seq or \ref par.
+/// \param policy Execution policy.
+/// \param e      Expression, or a tensor to copy.
+/// \param dst    Destination tensor or mutable view, of the same shape as \p e.
+/// \ingroup tensor
+template <ExecutionPolicy Policy, TensorOperand E, MutableTensorLike Dst>
+void assign(Policy const& policy, E const& e, Dst&& dst)
+{
+  auto expr = as_expression(e);
+  auto out = detail::as_dynamic_strided(dst.mutable_mdspan());
+  static_assert(decltype(expr)::rank() == decltype(out)::rank(), "assign: rank mismatch");
+  PRECONDITION_EQUAL(expr.extents(), out.extents(), "assign: shape mismatch");
+
+  detail::expression_workspace ws;
+  detail::evaluate_into(policy, typename std::remove_cvref_t<Dst>::default_tag{}, expr, out, ws);
+}
+
+/// \brief Evaluate a tensor expression into \p dst, serially.
+/// \ingroup tensor
+template <TensorOperand E, MutableTensorLike Dst> void assign(E const& e, Dst&& dst)
+{
+  uni20::assign(seq, e, std::forward<Dst>(dst));
+}
+
+/// \brief Evaluate a tensor expression into a new row-major tensor.
+/// \details The result is held in UninitializedStorage, so its elements are written once, by the evaluation.
+/// \ingroup tensor
+template <TensorExpression E> auto evaluate(E const& e)
+{
+  using value_type = typename E::value_type;
+  BasicTensor<value_type, stdex::dextents<index_type, E::rank()>, UninitializedStorage> result(uninitialized,
+                                                                                            e.extents());
+  uni20::assign(e, result);
+  return result;
+}
+
+} // namespace uni20
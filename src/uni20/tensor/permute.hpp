@@ -0,0 +1,101 @@
+#pragma once
+
+/**
+ * \file permute.hpp
+ * \ingroup tensor
+ * \brief Permutation of the axes of TensorView and BasicTensor operands, into a given tensor or a new one.
+ * \details These overloads forward to the level-1 permute kernel on the mdspans of the operands; see
+ *          level1/permute.hpp. The lazy permute() of two arguments in expression.hpp reorders strides without
+ *          moving any data, and is materialised by the same kernel when it is assigned on its own.
+ */
+
+#include "basic_tensor.hpp"
+#include "expression.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/core/types.hpp>
+#include <uni20/level1/execution.hpp>
+#include <uni20/level1/permute.hpp>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace uni20
+{
+
+/// \brief Permute the axes of a tensor: dst = alpha·permute(src) + beta·dst, where axis \c k of \p dst is axis
+///        \c perm[k] of \p src.
+/// \details \p dst is not read if \p beta is zero. \p src and \p dst must not overlap.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \param policy Execution policy.
+/// \param alpha  Scale factor of the source.
+/// \param src    Tensor to permute.
+/// \param perm   Permutation of the axes.
+/// \param beta   Scale factor of the previous contents of \p dst.
+/// \param dst    Destination tensor or mutable view.
+/// \ingroup tensor
+template <ExecutionPolicy Policy, TensorLike Src, MutableTensorLike Dst, std::size_t R>
+void permute(Policy const& policy, typename std::remove_cvref_t<Dst>::value_type alpha, Src const& src,
+             std::array<std::size_t, R> const& perm, typename std::remove_cvref_t<Dst>::value_type beta, Dst&& dst)
+{
+  uni20::permute(policy, alpha, src.mdspan(), perm, beta, dst.mutable_mdspan());
+}
+
+/// \brief Permute the axes of a tensor into \p dst.
+/// \ingroup tensor
+template <ExecutionPolicy Policy, TensorLike Src, MutableTensorLike Dst, std::size_t R>
+void permute(Policy const& policy, Src const& src, std::array<std::size_t, R> const& perm, Dst&& dst)
+{
+  uni20::permute(policy, src.mdspan(), perm, dst.mutable_mdspan());
+}
+
+/// \brief Permute the axes of a tensor into \p dst, serially.
+/// \ingroup tensor
+template <TensorLike Src, MutableTensorLike Dst, std::size_t R>
+void permute(Src const& src, std::array<std::size_t, R> const& perm, Dst&& dst)
+{
+  uni20::permute(seq, src.mdspan(), perm, dst.mutable_mdspan());
+}
+
+/// \brief Scaled permutation dst = alpha·permute(src) + beta·dst, serially.
+/// \ingroup tensor
+template <TensorLike Src, MutableTensorLike Dst, std::size_t R>
+void permute(typename std::remove_cvref_t<Dst>::value_type alpha, Src const& src,
+             std::array<std::size_t, R> const& perm, typename std::remove_cvref_t<Dst>::value_type beta, Dst&& dst)
+{
+  uni20::permute(seq, alpha, src.mdspan(), perm, beta, dst.mutable_mdspan());
+}
+
+/// \brief A new row-major tensor holding \p src with its axes permuted: axis \c k of the result is axis \c perm[k]
+///        of \p src.
+/// \details The result is held in UninitializedStorage, so its elements are written once, by the permutation.
+/// \tparam Policy Execution policy, \ref seq or \ref par.
+/// \ingroup tensor
+template <ExecutionPolicy Policy, TensorLike Src, std::size_t R>
+auto permuted(Policy const& policy, Src const& src, std::array<std::size_t, R> const& perm)
+{
+  auto s = src.mdspan();
+  using S = decltype(s);
+  static_assert(S::rank() == R, "permuted: permutation length must equal the rank");
+
+  std::array<index_type, R> extents{};
+  for (std::size_t k = 0; k < R; ++k)
+  {
+    PRECONDITION(perm[k] < R, "permuted: not a permutation", perm[k]);
+    extents[k] = index_type(s.extent(perm[k]));
+  }
+  BasicTensor<std::remove_const_t<typename S::element_type>, stdex::dextents<index_type, R>, UninitializedStorage>
+      result(uninitialized, stdex::dextents<index_type, R>(extents));
+  uni20::permute(policy, s, perm, result.mutable_mdspan());
+  return result;
+}
+
+/// \brief A new row-major tensor holding \p src with its axes permuted, computed serially.
+/// \ingroup tensor
+template <TensorLike Src, std::size_t R> auto permuted(Src const& src, std::array<std::size_t, R> const& perm)
+{
+  return uni20::permuted(seq, src, perm);
+}
+
+} // namespace uni20
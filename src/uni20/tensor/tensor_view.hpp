@@ -65,6 +65,9 @@ struct tensor_traits
     using accessor_policy = AccessorPolicy;
     /// \brief Adaptor to provide the actual storage type of the given ElementType
     template <typename ElementType> using storage_type = ElementType;
+    /// \brief Trait bundle of a strided view of the same storage with extents \p NewExtents.
+    template <typename NewExtents>
+    using strided_view_traits = tensor_traits<NewExtents, StoragePolicy, stdex::layout_stride, AccessorPolicy>;
 };
 
 template <typename Extents, typename StoragePolicy = VectorStorage, typename LayoutPolicy = stdex::layout_stride,
@@ -73,6 +76,9 @@ struct mutable_tensor_traits : tensor_traits<Extents, StoragePolicy, LayoutPolic
 {
     /// \brief Adaptor to provide the actual storage type of the given ElementType for mutable access patterns.
     template <typename ElementType> using storage_type = std::remove_cv_t<ElementType>;
+    /// \brief Trait bundle of a strided view of the same storage with extents \p NewExtents.
+    template <typename NewExtents>
+    using strided_view_traits = mutable_tensor_traits<NewExtents, StoragePolicy, stdex::layout_stride, AccessorPolicy>;
 };
 
 /// \brief Trait bundle describing the policies required to build tensor views.
@@ -241,7 +247,33 @@ template <typename T, typename Traits> class TensorView<T const, Traits> {
       }
     }
 
+    /// \brief View of elements of the same buffer, with the same accessor, through a strided mapping.
+    /// \tparam NewExtents Extents type of the new view.
+    /// \param offset Offset, in elements, of the first element of the new view from the first element of this one.
+    /// \param mapping Strided mapping of the new view, relative to that element.
+    /// \return Read-only view of the selected elements.
+    template <typename NewExtents>
+    [[nodiscard]] auto remap(index_type offset, stdex::layout_stride::mapping<NewExtents> const& mapping) const
+        -> TensorView<element_type, typename traits_type::template strided_view_traits<NewExtents>>
+    {
+      return TensorView<element_type, typename traits_type::template strided_view_traits<NewExtents>>(
+          offset_handle(offset), mapping, accessor_);
+    }
+
   protected:
+    /// \brief Mutable handle advanced by \p offset elements.
+    [[nodiscard]] auto offset_handle(index_type offset) const -> mutable_handle_type
+    {
+      if constexpr (std::is_pointer_v<mutable_handle_type>)
+      {
+        return handle_ + offset;
+      }
+      else
+      {
+        return accessor_.offset(handle_, static_cast<std::size_t>(offset));
+      }
+    }
+
     template <typename Handle> static constexpr auto to_mutable_handle(Handle&& handle) -> mutable_handle_type
     {
       if constexpr (std::convertible_to<Handle, mutable_handle_type>)
@@ -398,6 +430,22 @@ template <typename T, typename Traits> class TensorView : public TensorView<T co
     /// \return Accessor providing mutable semantics, exposed as a const reference.
     [[nodiscard]] auto accessor() const noexcept -> accessor_type const& { return this->mutable_accessor_ref(); }
 
+    /// \brief Mutable view of elements of the same buffer, with the same accessor, through a strided mapping.
+    /// \tparam NewExtents Extents type of the new view.
+    /// \param offset Offset, in elements, of the first element of the new view from the first element of this one.
+    /// \param mapping Strided mapping of the new view, relative to that element.
+    /// \return Mutable view of the selected elements.
+    template <typename NewExtents>
+    [[nodiscard]] auto remap(typename base_type::index_type offset,
+                             stdex::layout_stride::mapping<NewExtents> const& mapping)
+        -> TensorView<element_type, typename traits_type::template strided_view_traits<NewExtents>>
+    {
+      return TensorView<element_type, typename traits_type::template strided_view_traits<NewExtents>>(
+          this->offset_handle(offset), mapping, this->mutable_accessor_ref());
+    }
+
+    using base_type::remap;
+
     using base_type::cols;
     using base_type::rows;
 };
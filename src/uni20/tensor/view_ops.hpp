@@ -0,0 +1,346 @@
+#pragma once
+
+/**
+ * \file view_ops.hpp
+ * \ingroup tensor
+ * \brief Zero-copy views of a tensor: subranges, slices, diagonals, and splitting, fusing and reshaping legs.
+ * \details Each operation computes a new strided mapping and a handle offset and returns a TensorView of the same
+ *          buffer with the same accessor, through TensorView::remap(). A mutable tensor or view gives a mutable
+ *          view, and a const one a read-only view. Subranges, slices, diagonals and split legs are always views.
+ *          Fusing legs and reshaping, which follow row-major order, are only views if the strides of the legs
+ *          concerned nest; the try_ forms report the case that would need a copy by returning std::nullopt, and
+ *          the plain forms require that it does not arise. broadcast_to() gives a read-only view that repeats a
+ *          tensor along axes of stride 0.
+ */
+
+#include "tensor_view.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/common/trace.hpp>
+#include <uni20/mdspan/broadcast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace uni20
+{
+
+/// \brief A TensorView, or a BasicTensor, that can be viewed through a new strided mapping with remap().
+/// \ingroup tensor
+template <typename V>
+concept StridedTensorView =
+    requires(std::remove_cvref_t<V>& v, stdex::layout_stride::mapping<stdex::dextents<index_type, 1>> m) {
+      typename std::remove_cvref_t<V>::extents_type;
+      v.mapping();
+      v.remap(index_type{}, m);
+    };
+
+namespace detail
+{
+
+/// \brief Extents and strides of a tensor view, as arrays of its index type.
+/// \ingroup internal
+template <typename V> struct view_layout
+{
+    using index_type = typename std::remove_cvref_t<V>::index_type;
+    static constexpr std::size_t rank = std::remove_cvref_t<V>::rank();
+
+    std::array<index_type, rank> extents{};
+    std::array<index_type, rank> strides{};
+
+    explicit view_layout(V const& v)
+    {
+      for (std::size_t r = 0; r < rank; ++r)
+      {
+        extents[r] = index_type(v.extents().extent(r));
+        strides[r] = index_type(v.mapping().stride(r));
+      }
+    }
+};
+
+/// \brief View of \p v through the strided mapping with the given extents and strides, starting \p offset elements
+///        from its first element.
+/// \ingroup internal
+template <typename V, typename I, std::size_t N>
+auto remap_view(V&& v, I offset, std::array<I, N> const& extents, std::array<I, N> const& strides)
+{
+  using extents_type = stdex::dextents<I, N>;
+  return v.remap(offset, stdex::layout_stride::mapping<extents_type>(extents_type(extents), strides));
+}
+
+/// \brief Strides for viewing a tensor with extents \p old_extents and strides \p old_strides as one with extents
+///        \p new_extents in row-major order, or std::nullopt if that needs a copy.
+/// \details Runs of old legs whose extents multiply to the same value as a run of new legs are matched up; each
+///          run of old legs must be nested, with every stride equal to the next stride times the next extent, once
+///          legs of extent 1 are dropped.
+/// \ingroup internal
+template <typename I, std::size_t R, std::size_t N>
+std::optional<std::array<I, N>> reshape_strides(std::array<I, R> const& old_extents,
+                                                std::array<I, R> const& old_strides,
+                                                std::array<I, N> const& new_extents)
+{
+  I old_size = 1, new_size = 1;
+  for (I e : old_extents)
+    old_size *= e;
+  for (I e : new_extents)
+    new_size *= e;
+  PRECONDITION_EQUAL(old_size, new_size, "reshape: the number of elements must not change");
+
+  std::array<I, N> strides{};
+  if (new_size == 0)
+  {
+    // no element is ever addressed, so any strides will do
+    for (std::size_t j = N; j-- > 0;)
+      strides[j] = j + 1 < N ? strides[j + 1] * std::max<I>(new_extents[j + 1], 1) : 1;
+    return strides;
+  }
+
+  // legs of extent 1 can take any stride
+  std::array<I, R> oe{}, os{};
+  std::size_t rank = 0;
+  for (std::size_t i = 0; i < R; ++i)
+  {
+    if (old_extents[i] == 1) continue;
+    oe[rank] = old_extents[i];
+    os[rank++] = old_strides[i];
+  }
+
+  std::size_t i = 0, j = 0;
+  while (i < rank && j < N)
+  {
+    std::size_t oi = i + 1, nj = j + 1;
+    I op = oe[i], np = new_extents[j];
+    while (op != np)
+    {
+      if (np < op)
+        np *= new_extents[nj++];
+      else
+        op *= oe[oi++];
+    }
+    for (std::size_t k = i; k + 1 < oi; ++k)
+    {
+      if (os[k] != os[k + 1] * oe[k + 1]) return std::nullopt;
+    }
+    strides[nj - 1] = os[oi - 1];
+    for (std::size_t k = nj - 1; k > j; --k)
+      strides[k - 1] = strides[k] * new_extents[k];
+    i = oi;
+    j = nj;
+  }
+  for (; j < N; ++j)
+    strides[j] = 1;
+  return strides;
+}
+
+} // namespace detail
+
+/// \brief View of the elements of \p v with index in [\p first[r], \p last[r]) along each axis \c r.
+/// \param v     Tensor or view.
+/// \param first First index along each axis.
+/// \param last  One past the last index along each axis.
+/// \return View of the same rank, indexed from zero.
+/// \ingroup tensor
+template <StridedTensorView V, std::size_t R>
+auto subrange(V&& v, std::array<index_type, R> const& first, std::array<index_type, R> const& last)
+{
+  detail::view_layout<V> l(v);
+  static_assert(R == l.rank, "subrange: one range per axis is required");
+  index_type offset = 0;
+  for (std::size_t r = 0; r < R; ++r)
+  {
+    PRECONDITION(0 <= first[r] && first[r] <= last[r] && last[r] <= l.extents[r], "subrange: range out of bounds", r,
+                 first[r], last[r], l.extents[r]);
+    offset += first[r] * l.strides[r];
+    l.extents[r] = last[r] - first[r];
+  }
+  return detail::remap_view(v, offset, l.extents, l.strides);
+}
+
+/// \brief View of the elements of \p v with index in [\p first, \p last) along \p axis.
+/// \ingroup tensor
+template <StridedTensorView V> auto subrange(V&& v, std::size_t axis, index_type first, index_type last)
+{
+  detail::view_layout<V> l(v);
+  PRECONDITION(axis < l.rank, "subrange: axis out of range", axis);
+  PRECONDITION(0 <= first && first <= last && last <= l.extents[axis], "subrange: range out of bounds", first, last,
+               l.extents[axis]);
+  l.extents[axis] = last - first;
+  return detail::remap_view(v, first * l.strides[axis], l.extents, l.strides);
+}
+
+/// \brief View of the elements of \p v with index \p index along \p axis, which is removed.
+/// \return View of rank one less than \p v.
+/// \ingroup tensor
+template <StridedTensorView V> auto slice(V&& v, std::size_t axis, index_type index)
+{
+  detail::view_layout<V> l(v);
+  constexpr std::size_t R = decltype(l)::rank;
+  static_assert(R > 0, "slice: cannot slice a rank-0 tensor");
+  PRECONDITION(axis < R, "slice: axis out of range", axis);
+  PRECONDITION(0 <= index && index < l.extents[axis], "slice: index out of bounds", index, l.extents[axis]);
+
+  using I = typename decltype(l)::index_type;
+  std::array<I, R - 1> extents{}, strides{};
+  for (std::size_t r = 0, k = 0; r < R; ++r)
+  {
+    if (r == axis) continue;
+    extents[k] = l.extents[r];
+    strides[k++] = l.strides[r];
+  }
+  return detail::remap_view(v, I(index * l.strides[axis]), extents, strides);
+}
+
+/// \brief View of the diagonal of \p v over the pair of axes \p axis1 and \p axis2, of equal extent.
+/// \details The two axes are replaced by a single axis at the position of the smaller of them, with the sum of
+///          their strides; the other axes keep their order.
+/// \return View of rank one less than \p v.
+/// \ingroup tensor
+template <StridedTensorView V> auto diagonal(V&& v, std::size_t axis1, std::size_t axis2)
+{
+  detail::view_layout<V> l(v);
+  constexpr std::size_t R = decltype(l)::rank;
+  static_assert(R >= 2, "diagonal: the tensor must have at least two axes");
+  PRECONDITION(axis1 < R && axis2 < R && axis1 != axis2, "diagonal: invalid pair of axes", axis1, axis2);
+  PRECONDITION_EQUAL(l.extents[axis1], l.extents[axis2], "diagonal: the axes differ in extent");
+
+  if (axis2 < axis1) std::swap(axis1, axis2);
+  using I = typename decltype(l)::index_type;
+  std::array<I, R - 1> extents{}, strides{};
+  for (std::size_t r = 0, k = 0; r < R; ++r)
+  {
+    if (r == axis2) continue;
+    extents[k] = l.extents[r];
+    strides[k++] = r == axis1 ? l.strides[axis1] + l.strides[axis2] : l.strides[r];
+  }
+  return detail::remap_view(v, I(0), extents, strides);
+}
+
+/// \brief View of \p v with \p axis split into N axes of the given extents, in row-major order.
+/// \param v       Tensor or view.
+/// \param axis    Axis to split.
+/// \param extents Extents of the new axes, whose product must be the extent of \p axis.
+/// \return View of rank N - 1 more than \p v.
+/// \ingroup tensor
+template <StridedTensorView V, std::size_t N>
+auto split_leg(V&& v, std::size_t axis, std::array<index_type, N> const& extents)
+{
+  static_assert(N > 0, "split_leg: at least one new axis is required");
+  detail::view_layout<V> l(v);
+  constexpr std::size_t R = decltype(l)::rank;
+  PRECONDITION(axis < R, "split_leg: axis out of range", axis);
+
+  using I = typename decltype(l)::index_type;
+  std::array<I, N> split_extents{};
+  for (std::size_t k = 0; k < N; ++k)
+    split_extents[k] = I(extents[k]);
+  // splitting one leg never needs a copy
+  auto split_strides = *detail::reshape_strides(std::array<I, 1>{l.extents[axis]},
+                                                std::array<I, 1>{l.strides[axis]}, split_extents);
+
+  std::array<I, R + N - 1> new_extents{}, new_strides{};
+  for (std::size_t r = 0, k = 0; r < R; ++r)
+  {
+    if (r != axis)
+    {
+      new_extents[k] = l.extents[r];
+      new_strides[k++] = l.strides[r];
+      continue;
+    }
+    for (std::size_t s = 0; s < N; ++s, ++k)
+    {
+      new_extents[k] = split_extents[s];
+      new_strides[k] = split_strides[s];
+    }
+  }
+  return detail::remap_view(v, I(0), new_extents, new_strides);
+}
+
+/// \brief View of \p v with the N consecutive axes starting at \p first fused into one axis, in row-major order,
+///        or std::nullopt if their strides do not nest and the fused tensor would need a copy.
+/// \return View of rank N - 1 less than \p v, if one exists.
+/// \ingroup tensor
+template <std::size_t N, StridedTensorView V> auto try_fuse_legs(V&& v, std::size_t first)
+{
+  detail::view_layout<V> l(v);
+  constexpr std::size_t R = decltype(l)::rank;
+  static_assert(N > 0 && N <= R, "fuse_legs: the number of fused axes must be between 1 and the rank");
+  PRECONDITION(first + N <= R, "fuse_legs: axes out of range", first, N);
+
+  using I = typename decltype(l)::index_type;
+  std::array<I, N> group_extents{}, group_strides{};
+  I fused = 1;
+  for (std::size_t k = 0; k < N; ++k)
+  {
+    group_extents[k] = l.extents[first + k];
+    group_strides[k] = l.strides[first + k];
+    fused *= group_extents[k];
+  }
+
+  using view_type = decltype(detail::remap_view(v, I(0), std::array<I, R - N + 1>{}, std::array<I, R - N + 1>{}));
+  auto stride = detail::reshape_strides(group_extents, group_strides, std::array<I, 1>{fused});
+  if (!stride) return std::optional<view_type>{};
+
+  std::array<I, R - N + 1> new_extents{}, new_strides{};
+  for (std::size_t r = 0, k = 0; r < R; ++r)
+  {
+    if (r > first && r < first + N) continue;
+    new_extents[k] = r == first ? fused : l.extents[r];
+    new_strides[k++] = r == first ? (*stride)[0] : l.strides[r];
+  }
+  return std::optional<view_type>(detail::remap_view(v, I(0), new_extents, new_strides));
+}
+
+/// \brief View of \p v with the N consecutive axes starting at \p first fused into one axis, in row-major order.
+/// \pre The fused axes nest, so that no copy is needed; see try_fuse_legs().
+/// \ingroup tensor
+template <std::size_t N, StridedTensorView V> auto fuse_legs(V&& v, std::size_t first)
+{
+  auto fused = try_fuse_legs<N>(std::forward<V>(v), first);
+  PRECONDITION(fused.has_value(), "fuse_legs: the axes are not contiguous, so fusing them needs a copy", first, N);
+  return *fused;
+}
+
+/// \brief View of \p v with the given extents, taking elements in row-major order, or std::nullopt if the strides
+///        of \p v do not allow it and the reshaped tensor would need a copy.
+/// \ingroup tensor
+template <StridedTensorView V, std::size_t N> auto try_reshape(V&& v, std::array<index_type, N> const& extents)
+{
+  detail::view_layout<V> l(v);
+  using I = typename decltype(l)::index_type;
+  std::array<I, N> new_extents{};
+  for (std::size_t k = 0; k < N; ++k)
+    new_extents[k] = I(extents[k]);
+
+  using view_type = decltype(detail::remap_view(v, I(0), new_extents, new_extents));
+  auto strides = detail::reshape_strides(l.extents, l.strides, new_extents);
+  if (!strides) return std::optional<view_type>{};
+  return std::optional<view_type>(detail::remap_view(v, I(0), new_extents, *strides));
+}
+
+/// \brief View of \p v with the given extents, taking elements in row-major order.
+/// \pre The strides of \p v allow it without a copy; see try_reshape().
+/// \ingroup tensor
+template <StridedTensorView V, std::size_t N> auto reshape(V&& v, std::array<index_type, N> const& extents)
+{
+  auto reshaped = try_reshape(std::forward<V>(v), extents);
+  PRECONDITION(reshaped.has_value(), "reshape: the view is not contiguous enough, so reshaping it needs a copy");
+  return *reshaped;
+}
+
+/// \brief Read-only view of \p v broadcast to the given extents, repeating it with stride 0 along new leading axes
+///        and along its axes of extent 1.
+/// \details The rules are those of broadcast_mapping(). The view can be combined elementwise with a tensor of the
+///          full extents without materialising the broadcast operand.
+/// \return Read-only view of rank N.
+/// \ingroup tensor
+template <StridedTensorView V, std::size_t N> auto broadcast_to(V&& v, std::array<index_type, N> const& extents)
+{
+  using I = typename std::remove_cvref_t<V>::index_type;
+  using extents_type = stdex::dextents<I, N>;
+  return std::as_const(v).remap(I(0), broadcast_mapping(v.mapping(), extents_type(extents)));
+}
+
+} // namespace uni20
@@ -0,0 +1,84 @@
+#include <uni20/core/simd.hpp>
+#include "gtest/gtest.h"
+#include <complex>
+#include <numeric>
+#include <vector>
+
+using namespace uni20;
+
+TEST(Simd, SimdOpDetection)
+{
+  auto f = [](auto x) { return x + x; };
+  EXPECT_FALSE(simd::is_simd_op<decltype(f)>);
+  EXPECT_TRUE(simd::is_simd_op<decltype(simd::simd_op{f})>);
+  EXPECT_FALSE(simd::vectorizable<std::complex<double>>);
+}
+
+// Lengths around the vector width exercise both the SIMD body and the scalar remainder.
+TEST(Simd, TransformInplaceRemainder)
+{
+  auto twice_plus_one = simd::simd_op{[](auto x) { return x * 2 + 1; }};
+  for (std::ptrdiff_t n : {0, 1, 3, 7, 8, 9, 33})
+  {
+    std::vector<float> v(n);
+    std::iota(v.begin(), v.end(), 0.0f);
+    simd::transform_inplace(v.data(), n, twice_plus_one);
+    for (std::ptrdiff_t i = 0; i < n; ++i)
+      EXPECT_EQ(v[i], 2.0f * float(i) + 1) << n;
+  }
+}
+
+TEST(Simd, TransformPlainFunctor)
+{
+  auto relu = [](double x) { return x > 0 ? x : 0.0; };
+  std::vector<double> v{-2, -1, 0, 1, 2};
+  simd::transform_inplace(v.data(), std::ptrdiff_t(v.size()), relu);
+  EXPECT_EQ(v, (std::vector<double>{0, 0, 0, 1, 2}));
+}
+
+TEST(Simd, TransformInPlaceAlias)
+{
+  auto axpy = simd::simd_op{[](auto y, auto x) { return y + 3 * x; }};
+  std::vector<double> y(13), x(13);
+  std::iota(y.begin(), y.end(), 1.0);
+  std::iota(x.begin(), x.end(), -4.0);
+  simd::transform(std::ptrdiff_t(y.size()), axpy, y.data(), static_cast<double const*>(y.data()),
+                  static_cast<double const*>(x.data()));
+  for (std::size_t i = 0; i < y.size(); ++i)
+    EXPECT_EQ(y[i], double(i + 1) + 3 * (double(i) - 4));
+}
+
+TEST(Simd, TransformBroadcastSource)
+{
+  auto fma = simd::simd_op{[](auto, auto x, auto a, auto b) { return a * x + b; }};
+  for (std::ptrdiff_t n : {1, 5, 8, 19})
+  {
+    std::vector<double> y(n), x(n);
+    std::iota(x.begin(), x.end(), 0.0);
+    double const a = 3, b = -1;
+    simd::transform_broadcast(n, fma, {false, false, true, true}, y.data(), static_cast<double const*>(y.data()),
+                              static_cast<double const*>(x.data()), &a, &b);
+    for (std::ptrdiff_t i = 0; i < n; ++i)
+      EXPECT_EQ(y[i], 3 * double(i) - 1) << n;
+  }
+}
+
+TEST(Simd, TransformAlignedAndMisaligned)
+{
+  auto add = simd::simd_op{[](auto, auto x, auto y) { return x + y; }};
+  alignas(64) double x[40], y[40], z[40];
+  std::iota(x, x + 40, 0.0);
+  std::iota(y, y + 40, 100.0);
+  EXPECT_TRUE(simd::is_aligned<simd::vector_alignment<double>>(x));
+
+  simd::transform(37, add, z, static_cast<double const*>(z), static_cast<double const*>(x),
+                  static_cast<double const*>(y));
+  for (int i = 0; i < 37; ++i)
+    EXPECT_EQ(z[i], 100.0 + 2 * i);
+
+  // one element past an aligned address takes the unaligned path
+  simd::transform(38, add, z + 1, static_cast<double const*>(z + 1), static_cast<double const*>(x + 1),
+                  static_cast<double const*>(y));
+  for (int i = 0; i < 38; ++i)
+    EXPECT_EQ(z[i + 1], double(i + 1) + 100.0 + i);
+}
@@ -17,6 +17,15 @@ auto make_mapping(std::array<std::size_t, N> const& extents, std::array<index_ty
   return mapping_t(extents_t(extents), strides);
 }
 
+/// \brief  Build a rank-R mdspan with layout_stride over a std::vector of any element type
+template <std::size_t R, typename T>
+auto make_strided_view(std::vector<T>& v, std::array<std::size_t, R> const& extents,
+                       std::array<index_t, R> const& strides)
+{
+  using extents_t = stdex::dextents<index_t, R>;
+  return stdex::mdspan<T, extents_t, stdex::layout_stride>(v.data(), make_mapping<R>(extents, strides));
+}
+
 /// \brief  A helper to build a 1D mdspan over a std::vector using layout_stride
 inline auto make_mdspan_1d(std::vector<double>& v)
 {
@@ -2,6 +2,9 @@
 #include <uni20/common/mdspan.hpp>
 #include <uni20/kernel/contract.hpp>
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <complex>
+#include <limits>
 #include <numeric>
 
 using namespace uni20;
@@ -253,3 +256,279 @@ TEST(ContractKernel2x2, AllLayoutCombinations)
   run_and_check(Acol, Bcol, Crow);
   run_and_check(Acol, Bcol, Ccol);
 }
+
+template <typename T> class ContractKernelBlocked : public ::testing::Test
+{};
+
+using BlockedScalarTypes = ::testing::Types<float, double, std::complex<float>, std::complex<double>>;
+TYPED_TEST_SUITE(ContractKernelBlocked, BlockedScalarTypes);
+
+// Test: cache-blocked engine over permuted legs, with M, N not multiples of the register tile and K spanning
+// several cache blocks so that β is only applied once.
+TYPED_TEST(ContractKernelBlocked, PermutedLegsMatchReference)
+{
+  using T = TypeParam;
+  using real_t = decltype(std::abs(T{}));
+  constexpr std::size_t I = 7, J = 5, P = 29, Q = 23;
+  using stdex3 = stdex::dextents<ptrdiff_t, 3>;
+
+  std::vector<T> va(I * P * Q), vb(J * Q * P), vc(J * I);
+  for (std::size_t n = 0; n < va.size(); ++n)
+    va[n] = T(real_t(int(n % 11) - 5) / 4);
+  for (std::size_t n = 0; n < vb.size(); ++n)
+    vb[n] = T(real_t(int(n % 7) - 3) / 2);
+  if constexpr (!std::is_floating_point_v<T>)
+  {
+    for (std::size_t n = 0; n < va.size(); ++n)
+      va[n] += T(0, real_t(int(n % 5) - 2) / 8);
+  }
+  for (std::size_t n = 0; n < vc.size(); ++n)
+    vc[n] = T(real_t(n));
+
+  // A(i,p,q) row-major, B(q,j,p) with j outermost in memory, C(i,j) column-major
+  stdex::mdspan<T, stdex3, stdex::layout_stride> A(
+      va.data(), make_mapping<3>(std::array{I, P, Q}, std::array<ptrdiff_t, 3>{P * Q, Q, 1}));
+  stdex::mdspan<T, stdex3, stdex::layout_stride> B(
+      vb.data(), make_mapping<3>(std::array{Q, J, P}, std::array<ptrdiff_t, 3>{1, Q * P, Q}));
+  stdex::mdspan<T, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+      vc.data(), make_mapping<2>(std::array{I, J}, std::array<ptrdiff_t, 2>{1, I}));
+
+  T alpha = T(real_t(0.5)), beta = T(real_t(-1));
+  std::vector<T> cref(I * J);
+  for (std::size_t i = 0; i < I; ++i)
+    for (std::size_t j = 0; j < J; ++j)
+    {
+      T acc{};
+      for (std::size_t p = 0; p < P; ++p)
+        for (std::size_t q = 0; q < Q; ++q)
+          acc += va[(i * P + p) * Q + q] * vb[j * Q * P + p * Q + q];
+      cref[i * J + j] = beta * vc[i + j * I] + alpha * acc;
+    }
+
+  std::array<std::pair<std::size_t, std::size_t>, 2> Kdims{{{1, 2}, {2, 0}}};
+  contract(alpha, A, B, Kdims, beta, C, cpu_tag{});
+
+  for (std::size_t i = 0; i < I; ++i)
+    for (std::size_t j = 0; j < J; ++j)
+      EXPECT_NEAR(std::abs((C[i, j]) - cref[i * J + j]), 0.0, 1e-3 * (1 + std::abs(cref[i * J + j])));
+}
+
+// Test: blocked engine with a contracted extent of zero only scales C by β
+TEST(ContractKernelBlocked2D, EmptyContractionScalesC)
+{
+  static_vector<extent_strides<2>, 1> Mg{{{64, {0, 64}}}};
+  static_vector<extent_strides<2>, 1> Ng{{{64, {0, 1}}}};
+  static_vector<extent_strides<2>, 1> Kg{{{0, {1, 1}}}};
+  std::vector<double> cv(64 * 64, 3.0);
+  double a = 0, b = 0;
+
+  cpu::BlockedGemm<double> Engine(Mg, Ng, Kg, 1.0, 2.0);
+  Engine.run(&a, &b, cv.data());
+
+  for (double c : cv)
+    EXPECT_EQ(c, 6.0);
+}
+
+// Test: with a wider accumulator, run() with caller scratch keeps the accumulator tile and its offset tables in
+// the scratch and matches the engine allocating its own
+TEST(ContractKernelBlocked2D, WideAccumulatorRunsInWorkspace)
+{
+  constexpr index_type M = 37, K = 45, N = 29;
+  static_vector<extent_strides<2>, 1> Mg{{{M, {K, N}}}};
+  static_vector<extent_strides<2>, 1> Ng{{{N, {1, 1}}}};
+  static_vector<extent_strides<2>, 1> Kg{{{K, {1, N}}}};
+  std::vector<float> av(M * K), bv(K * N), c1(M * N);
+  for (std::size_t x = 0; x < av.size(); ++x)
+    av[x] = float(x % 7) - 3;
+  for (std::size_t x = 0; x < bv.size(); ++x)
+    bv[x] = float(x % 5) / 4;
+  for (std::size_t x = 0; x < c1.size(); ++x)
+    c1[x] = float(x % 3);
+  std::vector<float> c2(c1);
+
+  cpu::BlockedGemm<float, double> Engine(Mg, Ng, Kg, 1.5f, 0.5f);
+  Engine.run(av.data(), bv.data(), c1.data());
+
+  auto workspace = allocate_uninitialized_buffer<double>(Engine.workspace_size());
+  std::fill_n(workspace.get(), Engine.workspace_size(), std::numeric_limits<double>::quiet_NaN());
+  Engine.run(1.5f, av.data(), bv.data(), 0.5f, c2.data(), workspace.get());
+  for (std::size_t x = 0; x < c1.size(); ++x)
+    EXPECT_EQ(c2[x], c1[x]) << x;
+}
+
+// Test: with β = 0 the previous contents of C are not read, so NaN in C does not reach the result, in the loop
+// engine (small), the blocked engine (large), with a wider accumulator and with an epilogue
+TEST(ContractKernelBeta, ZeroBetaIgnoresNaNInC)
+{
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  for (std::size_t n : {4, 32})
+  {
+    std::vector<double> av(n * n), bv(n * n);
+    for (std::size_t x = 0; x < av.size(); ++x)
+    {
+      av[x] = double(x % 5) - 2;
+      bv[x] = double(x % 3) + 0.5;
+    }
+    stdex::mdspan<double const, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> A(
+        av.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+    stdex::mdspan<double const, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> B(
+        bv.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+
+    std::vector<double> ref(n * n, 0.0);
+    naive_matmul_2d(n, n, n, 1.0, av.data(), n, 1, bv.data(), n, 1, 0.0, ref.data(), n, 1);
+
+    auto run = [&](auto&&... options) {
+      std::vector<double> cv(n * n, nan);
+      stdex::mdspan<double, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+          cv.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+      contract(1.0, A, B, {{1, 0}}, 0.0, C, cpu_tag{}, options...);
+      for (std::size_t x = 0; x < n * n; ++x)
+        EXPECT_EQ(cv[x], ref[x]) << n << " " << x;
+    };
+    run();
+    run(contract_options<long double>{});
+    auto twice = [](double x) { return 2 * x; };
+    std::vector<double> cv(n * n, nan);
+    stdex::mdspan<double, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+        cv.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+    contract(1.0, A, B, {{1, 0}}, 0.0, C, cpu_tag{}, contract_epilogue<double, 2, decltype(twice)>{{}, twice});
+    for (std::size_t x = 0; x < n * n; ++x)
+      EXPECT_EQ(cv[x], 2 * ref[x]) << n << " " << x;
+  }
+}
+
+// Test: conjugation flags on both the loop engine (small) and the blocked engine (large)
+TEST(ContractKernelOptions, ConjugatedOperands)
+{
+  using T = std::complex<double>;
+  for (std::size_t n : {3, 40})
+  {
+    std::vector<T> av(n * n), bv(n * n);
+    for (std::size_t x = 0; x < av.size(); ++x)
+    {
+      av[x] = T(double(x % 7) - 3, double(x % 5) - 2);
+      bv[x] = T(double(x % 3) - 1, double(x % 4) - 1.5);
+    }
+    stdex::mdspan<T, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> A(
+        av.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+    stdex::mdspan<T, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> B(
+        bv.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{1, ptrdiff_t(n)}));
+
+    for (int flags = 0; flags < 4; ++flags)
+    {
+      bool const ca = flags & 1, cb = flags & 2;
+      std::vector<T> cv(n * n, T(1, 1));
+      stdex::mdspan<T, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+          cv.data(), make_mapping<2>(std::array{n, n}, std::array<ptrdiff_t, 2>{ptrdiff_t(n), 1}));
+      contract(T(2), A, B, {{1, 0}}, T(0.5), C, cpu_tag{}, contract_options<>{.conj_a = ca, .conj_b = cb});
+
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+        {
+          T acc{};
+          for (std::size_t k = 0; k < n; ++k)
+          {
+            T a = A[i, k], b = B[k, j];
+            acc += (ca ? std::conj(a) : a) * (cb ? std::conj(b) : b);
+          }
+          T ref = T(0.5) * T(1, 1) + T(2) * acc;
+          EXPECT_NEAR(std::abs((C[i, j]) - ref), 0.0, 1e-10) << n << ' ' << flags;
+        }
+    }
+  }
+}
+
+// Test: float tensors accumulated in double over a long contracted extent match a double reference to float
+// rounding, in both the loop engine and the blocked engine.
+TEST(ContractKernelOptions, DoubleAccumulation)
+{
+  for (std::size_t m : {1, 8})
+  {
+    constexpr std::size_t K = 1 << 15;
+    std::vector<float> av(m * K), bv(K * m), cv(m * m, 0.0f);
+    for (std::size_t x = 0; x < av.size(); ++x)
+      av[x] = 1.0f + float(x % 13) / 1024;
+    for (std::size_t x = 0; x < bv.size(); ++x)
+      bv[x] = 1.0f - float(x % 11) / 2048;
+    stdex::mdspan<float, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> A(
+        av.data(), make_mapping<2>(std::array{m, K}, std::array<ptrdiff_t, 2>{ptrdiff_t(K), 1}));
+    stdex::mdspan<float, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> B(
+        bv.data(), make_mapping<2>(std::array{K, m}, std::array<ptrdiff_t, 2>{1, ptrdiff_t(K)}));
+    stdex::mdspan<float, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+        cv.data(), make_mapping<2>(std::array{m, m}, std::array<ptrdiff_t, 2>{ptrdiff_t(m), 1}));
+
+    contract(1.0f, A, B, {{1, 0}}, 0.0f, C, cpu_tag{}, contract_options<double>{});
+
+    for (std::size_t i = 0; i < m; ++i)
+      for (std::size_t j = 0; j < m; ++j)
+      {
+        double ref = 0;
+        for (std::size_t k = 0; k < K; ++k)
+          ref += double(av[i * K + k]) * double(bv[j * K + k]);
+        EXPECT_EQ((C[i, j]), float(ref)) << m;
+      }
+  }
+}
+
+// Test: a diagonal scaling on one M leg and one N leg plus an elementwise functor, with C stored in a permuted
+// layout, matches a reference in both the loop engine (small) and the blocked engine (large).
+TEST(ContractKernelEpilogue, LegScalingAndFunctor)
+{
+  auto leaky = [](double x) { return x > 0 ? x : 0.125 * x; };
+  for (std::size_t n : {2, 12})
+  {
+    std::size_t const I = n, P = 3, K = n + 1, Q = 2, J = n;
+    // A(i,k,p) stored as (p,k,i), B(k,q,j) as (k,j,q) and C(i,p,q,j) as (j,i,q,p), so the merged groups
+    // enumerate the output legs in a different order from C
+    std::vector<double> av(I * K * P), bv(K * Q * J), cv(I * P * Q * J);
+    for (std::size_t x = 0; x < av.size(); ++x)
+      av[x] = double(x % 7) - 3;
+    for (std::size_t x = 0; x < bv.size(); ++x)
+      bv[x] = double(x % 5) - 1.5;
+    for (std::size_t x = 0; x < cv.size(); ++x)
+      cv[x] = double(x % 3) - 1;
+    std::vector<double> const c0 = cv;
+    std::vector<double> dp(P), dj(J);
+    for (std::size_t x = 0; x < P; ++x)
+      dp[x] = 0.5 + double(x);
+    for (std::size_t x = 0; x < J; ++x)
+      dj[x] = double(x % 4) - 1;
+
+    stdex::mdspan<double, stdex::dextents<ptrdiff_t, 3>, stdex::layout_stride> A(
+        av.data(), make_mapping<3>(std::array{I, K, P}, std::array<ptrdiff_t, 3>{1, ptrdiff_t(I), ptrdiff_t(I * K)}));
+    stdex::mdspan<double, stdex::dextents<ptrdiff_t, 3>, stdex::layout_stride> B(
+        bv.data(), make_mapping<3>(std::array{K, Q, J}, std::array<ptrdiff_t, 3>{ptrdiff_t(Q * J), 1, ptrdiff_t(Q)}));
+    std::array<ptrdiff_t, 4> const sC{ptrdiff_t(Q * P), 1, ptrdiff_t(P), ptrdiff_t(I * Q * P)};
+    stdex::mdspan<double, stdex::dextents<ptrdiff_t, 4>, stdex::layout_stride> C(
+        cv.data(), make_mapping<4>(std::array{I, P, Q, J}, sC));
+
+    contract_epilogue<double, 4, decltype(leaky)> ep{{std::span<double const>{}, dp, {}, dj}, leaky};
+    contract(2.0, A, B, {{1, 0}}, -0.5, C, cpu_tag{}, ep);
+
+    for (std::size_t i = 0; i < I; ++i)
+      for (std::size_t p = 0; p < P; ++p)
+        for (std::size_t q = 0; q < Q; ++q)
+          for (std::size_t j = 0; j < J; ++j)
+          {
+            double acc = 0;
+            for (std::size_t k = 0; k < K; ++k)
+              acc += (A[i, k, p]) * (B[k, q, j]);
+            double const c = c0[i * sC[0] + p * sC[1] + q * sC[2] + j * sC[3]];
+            EXPECT_DOUBLE_EQ((C[i, p, q, j]), leaky(-0.5 * c + 2.0 * acc * dp[p] * dj[j])) << n;
+          }
+  }
+}
+
+// Test: a scale vector whose length does not match its output leg is rejected.
+TEST(ContractKernelEpilogue, ScaleExtentMismatch)
+{
+  std::vector<double> av(4, 1.0), bv(4, 1.0), cv(4, 0.0), d(3, 1.0);
+  stdex::mdspan<double, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> A(
+      av.data(), make_mapping<2>(std::array<std::size_t, 2>{2, 2}, std::array<ptrdiff_t, 2>{2, 1}));
+  stdex::mdspan<double, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> B(
+      bv.data(), make_mapping<2>(std::array<std::size_t, 2>{2, 2}, std::array<ptrdiff_t, 2>{2, 1}));
+  stdex::mdspan<double, stdex::dextents<ptrdiff_t, 2>, stdex::layout_stride> C(
+      cv.data(), make_mapping<2>(std::array<std::size_t, 2>{2, 2}, std::array<ptrdiff_t, 2>{2, 1}));
+  contract_epilogue<double, 2> ep{{d, {}}};
+  EXPECT_DEATH(contract(1.0, A, B, {{1, 0}}, 0.0, C, cpu_tag{}, ep), "does not match the extent");
+}
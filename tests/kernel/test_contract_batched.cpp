@@ -0,0 +1,90 @@
+#include "../helpers.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/contract.hpp>
+#include "gtest/gtest.h"
+#include <oneapi/tbb/task_arena.h>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+namespace
+{
+
+// A is (b, i, k) row-major, B is (k, b, j) row-major and C is (b, i, j) with j slowest.
+template <typename T> struct batched_problem
+{
+    std::size_t nb, m, k, n;
+    std::vector<T> a, b, c, ref;
+
+    batched_problem(std::size_t nb_, std::size_t m_, std::size_t k_, std::size_t n_)
+        : nb(nb_), m(m_), k(k_), n(n_), a(nb * m * k), b(k * nb * n), c(nb * m * n), ref(nb * m * n)
+    {
+      for (std::size_t x = 0; x < a.size(); ++x)
+        a[x] = T(static_cast<double>(x % 11) * 0.25 - 1.0);
+      for (std::size_t x = 0; x < b.size(); ++x)
+        b[x] = T(static_cast<double>(x % 7) * 0.5 - 1.5);
+      for (std::size_t x = 0; x < c.size(); ++x)
+        c[x] = ref[x] = T(static_cast<double>(x % 5));
+    }
+
+    auto A() { return make_strided_view<3>(a, {nb, m, k}, {index_t(m * k), index_t(k), 1}); }
+    auto B() { return make_strided_view<3>(b, {k, nb, n}, {index_t(nb * n), index_t(n), 1}); }
+    auto C() { return make_strided_view<3>(c, {nb, m, n}, {1, index_t(nb), index_t(nb * m)}); }
+
+    void reference(T alpha, T beta)
+    {
+      for (std::size_t p = 0; p < nb; ++p)
+        for (std::size_t i = 0; i < m; ++i)
+          for (std::size_t j = 0; j < n; ++j)
+          {
+            T sum{};
+            for (std::size_t q = 0; q < k; ++q)
+              sum += a[(p * m + i) * k + q] * b[(q * nb + p) * n + j];
+            T& r = ref[p + i * nb + j * nb * m];
+            r = beta * r + alpha * sum;
+          }
+    }
+};
+
+constexpr std::array<std::pair<std::size_t, std::size_t>, 1> contract_dims{{{2, 0}}};
+constexpr std::array<std::pair<std::size_t, std::size_t>, 1> batch_dims{{{0, 1}}};
+
+} // namespace
+
+TEST(ContractBatched, SmallMatchesReference)
+{
+  batched_problem<double> P(3, 2, 4, 5);
+  contract_batched(2.0, P.A(), P.B(), contract_dims, batch_dims, 0.5, P.C(), cpu_tag{});
+  P.reference(2.0, 0.5);
+  for (std::size_t x = 0; x < P.c.size(); ++x)
+    EXPECT_NEAR(P.c[x], P.ref[x], 1e-12) << x;
+}
+
+TEST(ContractBatched, BlockedMatchesReference)
+{
+  batched_problem<float> P(4, 24, 20, 18);
+  contract_batched(1.0f, P.A(), P.B(), contract_dims, batch_dims, -1.0f, P.C(), cpu_tag{});
+  P.reference(1.0f, -1.0f);
+  for (std::size_t x = 0; x < P.c.size(); ++x)
+    EXPECT_NEAR(P.c[x], P.ref[x], 1e-3) << x;
+}
+
+TEST(ContractBatched, ParallelMatchesSerial)
+{
+  oneapi::tbb::task_arena arena(4);
+  for (auto [nb, m] : {std::pair<std::size_t, std::size_t>{64, 40}, {2, 160}})
+  {
+    batched_problem<double> P(nb, m, 48, 40);
+    contract_batched_parallel(1.5, P.A(), P.B(), contract_dims, batch_dims, 0.25, P.C(), cpu_tag{}, &arena);
+    P.reference(1.5, 0.25);
+    for (std::size_t x = 0; x < P.c.size(); ++x)
+      ASSERT_NEAR(P.c[x], P.ref[x], 1e-9) << nb << ' ' << x;
+  }
+}
+
+TEST(ContractBatched, EmptyBatchIsNoOp)
+{
+  batched_problem<double> P(0, 3, 3, 3);
+  contract_batched(1.0, P.A(), P.B(), contract_dims, batch_dims, 0.0, P.C(), cpu_tag{});
+  EXPECT_TRUE(P.c.empty());
+}
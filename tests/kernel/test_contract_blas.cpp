@@ -0,0 +1,491 @@
+#include "../helpers.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/contract.hpp>
+#include <uni20/kernel/contraction_plan.hpp>
+#include "gtest/gtest.h"
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <oneapi/tbb/task_arena.h>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+namespace
+{
+
+using extents3 = stdex::dextents<index_t, 3>;
+
+// Reference C = alpha * A * B + beta * C over arbitrary 2D mdspans.
+template <typename T, typename AType, typename BType>
+std::vector<T> reference_matmul(T alpha, AType A, BType B, T beta, std::vector<T> const& c0, std::size_t N)
+{
+  std::vector<T> cref(c0);
+  for (index_t i = 0; i < A.extent(0); ++i)
+    for (index_t j = 0; j < B.extent(1); ++j)
+    {
+      T acc{};
+      for (index_t k = 0; k < A.extent(1); ++k)
+        acc += A[i, k] * B[k, j];
+      cref[i * N + j] = beta * cref[i * N + j] + alpha * acc;
+    }
+  return cref;
+}
+
+} // namespace
+
+TEST(ContractBlasGemmParams, RowMajorOperandsUseSwappedGemm)
+{
+  static_vector<extent_strides<2>, 1> M{{{3, {4, 5}}}};
+  static_vector<extent_strides<2>, 1> N{{{5, {1, 1}}}};
+  static_vector<extent_strides<2>, 1> K{{{4, {1, 5}}}};
+
+  auto p = kernel::blas::make_gemm_params(M, N, K);
+  ASSERT_TRUE(p.has_value());
+  EXPECT_TRUE(p->swap_operands);
+  EXPECT_EQ(p->m, 5);
+  EXPECT_EQ(p->n, 3);
+  EXPECT_EQ(p->k, 4);
+  EXPECT_EQ(p->ldc, 5);
+  EXPECT_EQ(p->a.trans, 'N');
+  EXPECT_EQ(p->a.ld, 5);
+  EXPECT_EQ(p->b.trans, 'N');
+  EXPECT_EQ(p->b.ld, 4);
+}
+
+TEST(ContractBlasGemmParams, NonUnitStrideIsRejected)
+{
+  static_vector<extent_strides<2>, 1> M{{{3, {2, 8}}}};
+  static_vector<extent_strides<2>, 1> N{{{4, {1, 2}}}};
+  static_vector<extent_strides<2>, 1> K{{{2, {1, 4}}}};
+
+  EXPECT_FALSE(kernel::blas::make_gemm_params(M, N, K).has_value());
+}
+
+TEST(ContractBlas2D, AllLayoutCombinations)
+{
+  constexpr std::size_t M = 3, K = 4, N = 5;
+  std::vector<double> av(M * K), bv(K * N);
+  std::iota(av.begin(), av.end(), 1.0);
+  std::iota(bv.begin(), bv.end(), -7.0);
+
+  std::array<std::array<index_t, 2>, 2> a_strides{{{K, 1}, {1, M}}};
+  std::array<std::array<index_t, 2>, 2> b_strides{{{N, 1}, {1, K}}};
+  std::array<std::array<index_t, 2>, 2> c_strides{{{N, 1}, {1, M}}};
+
+  for (auto sa : a_strides)
+    for (auto sb : b_strides)
+      for (auto sc : c_strides)
+      {
+        auto A = make_strided_view<2>(av, {M, K}, sa);
+        auto B = make_strided_view<2>(bv, {K, N}, sb);
+        std::vector<double> cv(M * N);
+        std::iota(cv.begin(), cv.end(), 2.0);
+        auto C = make_strided_view<2>(cv, {M, N}, sc);
+
+        std::vector<double> c0(M * N);
+        for (std::size_t i = 0; i < M; ++i)
+          for (std::size_t j = 0; j < N; ++j)
+            c0[i * N + j] = C[i, j];
+        auto cref = reference_matmul(2.0, A, B, 0.5, c0, N);
+
+        contract(2.0, A, B, {{1, 0}}, 0.5, C, blas_tag{});
+
+        for (std::size_t i = 0; i < M; ++i)
+          for (std::size_t j = 0; j < N; ++j)
+            EXPECT_DOUBLE_EQ((C[i, j]), cref[i * N + j]);
+      }
+}
+
+TEST(ContractBlas3D, FusedLegsAndPermutedOutput)
+{
+  // C(i,j) = sum_{k,l} A(i,k,l) B(k,l,j), with C stored column-major against row-major operands.
+  constexpr std::size_t I = 3, Kd = 2, L = 4, J = 5;
+  std::vector<double> va(I * Kd * L), vb(Kd * L * J), vc(I * J, 1.0);
+  std::iota(va.begin(), va.end(), 1.0);
+  std::iota(vb.begin(), vb.end(), 3.0);
+
+  stdex::mdspan<double, extents3, stdex::layout_stride> A(
+      va.data(), make_mapping<3>(std::array{I, Kd, L}, std::array<index_t, 3>{Kd * L, L, 1}));
+  stdex::mdspan<double, extents3, stdex::layout_stride> B(
+      vb.data(), make_mapping<3>(std::array{Kd, L, J}, std::array<index_t, 3>{L * J, J, 1}));
+  auto C = make_strided_view<2>(vc, {I, J}, {1, I});
+
+  std::array<std::pair<std::size_t, std::size_t>, 2> Kdims{{{1, 0}, {2, 1}}};
+  contract(1.0, A, B, Kdims, 1.0, C, blas_tag{});
+
+  for (std::size_t i = 0; i < I; ++i)
+    for (std::size_t j = 0; j < J; ++j)
+    {
+      double acc = 1.0;
+      for (std::size_t k = 0; k < Kd; ++k)
+        for (std::size_t l = 0; l < L; ++l)
+          acc += va[i * Kd * L + k * L + l] * vb[k * L * J + l * J + j];
+      EXPECT_DOUBLE_EQ((C[i, j]), acc);
+    }
+}
+
+TEST(ContractBlas2D, ComplexRowMajor)
+{
+  using cplx = std::complex<double>;
+  constexpr std::size_t M = 2, K = 3, N = 2;
+  std::vector<cplx> av(M * K), bv(K * N), cv(M * N, cplx{1.0, -1.0});
+  for (std::size_t i = 0; i < av.size(); ++i)
+    av[i] = cplx(double(i), double(i) + 0.5);
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    bv[i] = cplx(1.0 - double(i), double(i));
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {N, 1});
+  cplx alpha{0.5, 1.0}, beta{2.0, 0.0};
+  auto cref = reference_matmul(alpha, A, B, beta, cv, N);
+
+  contract(alpha, A, B, {{1, 0}}, beta, C, blas_tag{});
+
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+    {
+      EXPECT_DOUBLE_EQ((C[i, j]).real(), cref[i * N + j].real());
+      EXPECT_DOUBLE_EQ((C[i, j]).imag(), cref[i * N + j].imag());
+    }
+}
+
+TEST(ContractBlas2D, NonUnitStrideFallsBack)
+{
+  // Every leg of C has a non-unit stride, so the contraction is not a single GEMM.
+  constexpr std::size_t M = 3, K = 2, N = 4;
+  std::vector<double> av(M * K), bv(K * N), cv(2 * M * N, 0.0);
+  std::iota(av.begin(), av.end(), 1.0);
+  std::iota(bv.begin(), bv.end(), 2.0);
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {2 * N, 2});
+  auto cref = reference_matmul(1.0, A, B, 0.0, std::vector<double>(M * N, 0.0), N);
+
+  contract(1.0, A, B, {{1, 0}}, 0.0, C, blas_tag{});
+
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), cref[i * N + j]);
+  for (std::size_t i = 1; i < cv.size(); i += 2)
+    EXPECT_EQ(cv[i], 0.0);
+}
+
+TEST(ContractBlasTtgt, SmallContractionKeepsLoop)
+{
+  static_vector<extent_strides<2>, 1> M{{{4, {2, 8}}}};
+  static_vector<extent_strides<2>, 1> N{{{4, {1, 2}}}};
+  static_vector<extent_strides<2>, 1> K{{{2, {1, 4}}}};
+
+  auto plan = kernel::blas::make_ttgt_plan(M, N, K);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_FALSE(plan->pack_a);
+  EXPECT_FALSE(plan->pack_b);
+  EXPECT_TRUE(plan->pack_c);
+  EXPECT_FALSE(kernel::blas::prefer_ttgt(*plan));
+}
+
+TEST(ContractBlasTtgt, StridedOutputIsPackedAndScattered)
+{
+  constexpr std::size_t M = 24, K = 24, N = 24;
+  std::vector<double> av(M * K), bv(K * N), cv(2 * M * N);
+  std::iota(av.begin(), av.end(), -100.0);
+  std::iota(bv.begin(), bv.end(), 3.0);
+  std::iota(cv.begin(), cv.end(), 1.0);
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {2 * N, 2});
+
+  auto [Mgrp, Ngrp, Kgrp] = extract_strides(A, B, std::array<std::pair<std::size_t, std::size_t>, 1>{{{1, 0}}}, C);
+  auto plan = kernel::blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_TRUE(plan->pack_c);
+  EXPECT_TRUE(kernel::blas::prefer_ttgt(*plan));
+
+  std::vector<double> c0(M * N);
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      c0[i * N + j] = C[i, j];
+  auto cref = reference_matmul(0.5, A, B, -2.0, c0, N);
+  std::vector<double> untouched(cv);
+
+  contract(0.5, A, B, {{1, 0}}, -2.0, C, blas_tag{});
+
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), cref[i * N + j]);
+  for (std::size_t i = 1; i < cv.size(); i += 2)
+    EXPECT_EQ(cv[i], untouched[i]);
+}
+
+TEST(ContractBlasTtgt, PackedOutputWithZeroBetaIgnoresNaN)
+{
+  constexpr std::size_t M = 24, K = 24, N = 24;
+  std::vector<double> av(M * K), bv(K * N), cv(2 * M * N, std::numeric_limits<double>::quiet_NaN());
+  std::iota(av.begin(), av.end(), -100.0);
+  std::iota(bv.begin(), bv.end(), 3.0);
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {2 * N, 2});
+  auto cref = reference_matmul(0.5, A, B, 0.0, std::vector<double>(M * N, 0.0), N);
+
+  contract(0.5, A, B, {{1, 0}}, 0.0, C, blas_tag{});
+
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), cref[i * N + j]);
+}
+
+TEST(ContractBlasTtgt, InterleavedLegsArePacked)
+{
+  // C(a,b,c) = sum_{k1,k2} A(a,k1,b,k2) B(k2,c,k1); the contracted legs of A and B are interleaved.
+  constexpr std::size_t Da = 6, Dk1 = 6, Db = 6, Dk2 = 6, Dc = 6;
+  using extents4 = stdex::dextents<index_t, 4>;
+  std::vector<double> va(Da * Dk1 * Db * Dk2), vb(Dk2 * Dc * Dk1), vc(Da * Db * Dc, 0.0);
+  for (std::size_t i = 0; i < va.size(); ++i)
+    va[i] = double(i % 17) - 8.0;
+  for (std::size_t i = 0; i < vb.size(); ++i)
+    vb[i] = double(i % 13) * 0.5;
+
+  stdex::mdspan<double, extents4, stdex::layout_stride> A(
+      va.data(), make_mapping<4>(std::array{Da, Dk1, Db, Dk2}, std::array<index_t, 4>{Dk1 * Db * Dk2, Db * Dk2, Dk2, 1}));
+  stdex::mdspan<double, extents3, stdex::layout_stride> B(
+      vb.data(), make_mapping<3>(std::array{Dk2, Dc, Dk1}, std::array<index_t, 3>{Dc * Dk1, Dk1, 1}));
+  stdex::mdspan<double, extents3, stdex::layout_stride> C(
+      vc.data(), make_mapping<3>(std::array{Da, Db, Dc}, std::array<index_t, 3>{Db * Dc, Dc, 1}));
+
+  std::array<std::pair<std::size_t, std::size_t>, 2> Kdims{{{1, 2}, {3, 0}}};
+  auto [Mgrp, Ngrp, Kgrp] = extract_strides(A, B, Kdims, C);
+  auto plan = kernel::blas::make_ttgt_plan(Mgrp, Ngrp, Kgrp);
+  ASSERT_TRUE(plan.has_value());
+  EXPECT_TRUE(plan->pack_a);
+  EXPECT_FALSE(plan->pack_c);
+  EXPECT_TRUE(kernel::blas::prefer_ttgt(*plan));
+
+  contract(1.0, A, B, Kdims, 0.0, C, blas_tag{});
+
+  for (std::size_t a = 0; a < Da; ++a)
+    for (std::size_t b = 0; b < Db; ++b)
+      for (std::size_t c = 0; c < Dc; ++c)
+      {
+        double acc = 0.0;
+        for (std::size_t k1 = 0; k1 < Dk1; ++k1)
+          for (std::size_t k2 = 0; k2 < Dk2; ++k2)
+            acc += va[((a * Dk1 + k1) * Db + b) * Dk2 + k2] * vb[(k2 * Dc + c) * Dk1 + k1];
+        EXPECT_DOUBLE_EQ((C[a, b, c]), acc);
+      }
+}
+
+TEST(ContractBlasParallel, TiledGemmMatchesSerial)
+{
+  constexpr std::size_t M = 300, K = 64, N = 257;
+  std::vector<double> av(M * K), bv(K * N), cv(M * N, 1.0), cs(M * N, 1.0);
+  for (std::size_t i = 0; i < av.size(); ++i)
+    av[i] = double(int(i % 13) - 6);
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    bv[i] = double(int(i % 11) - 5) / 2;
+
+  auto A = make_strided_view<2>(av, {M, K}, {1, M});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {N, 1});
+  auto Cs = make_strided_view<2>(cs, {M, N}, {N, 1});
+
+  oneapi::tbb::task_arena arena(4);
+  contract_parallel(1.5, A, B, {{1, 0}}, -1.0, C, blas_tag{}, &arena);
+  contract(1.5, A, B, {{1, 0}}, -1.0, Cs, blas_tag{});
+
+  for (std::size_t i = 0; i < cv.size(); ++i)
+    EXPECT_DOUBLE_EQ(cv[i], cs[i]);
+}
+
+TEST(ContractBlasPlan, RecordsGemmBackend)
+{
+  std::vector<double> v(4 * 4, 1.0), w(4 * 4, 0.0);
+  auto A = make_strided_view<2>(v, {4, 4}, {4, 1});
+  auto C = make_strided_view<2>(w, {4, 4}, {4, 1});
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+
+  auto plan = make_contraction_plan(A, A, dims, C, blas_tag{});
+  EXPECT_EQ(plan.backend(), ContractionBackend::Gemm);
+  EXPECT_EQ(plan.scratch_bytes(), 0u);
+  plan.execute(1.0, A.data_handle(), A.data_handle(), 0.0, C.data_handle());
+  for (double c : w)
+    EXPECT_DOUBLE_EQ(c, 4.0);
+}
+
+TEST(ContractBlasPlan, TtgtPlanReusesOffsetsAndScratch)
+{
+  constexpr std::size_t M = 24, K = 24, N = 24;
+  std::vector<double> av(M * K), bv(K * N), cv(2 * M * N), cs(2 * M * N);
+  std::iota(av.begin(), av.end(), -100.0);
+  std::iota(bv.begin(), bv.end(), 3.0);
+  std::iota(cv.begin(), cv.end(), 1.0);
+  cs = cv;
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {2 * N, 2});
+  auto Cs = make_strided_view<2>(cs, {M, N}, {2 * N, 2});
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+
+  auto plan = make_contraction_plan(A, B, dims, C, blas_tag{});
+  ASSERT_EQ(plan.backend(), ContractionBackend::TTGT);
+  EXPECT_EQ(plan.scratch_bytes(), M * N * sizeof(double));
+
+  for (int rep = 0; rep < 2; ++rep)
+  {
+    plan.execute(0.5, A.data_handle(), B.data_handle(), -2.0, C.data_handle());
+    contract(0.5, A, B, dims, -2.0, Cs, blas_tag{});
+  }
+  for (std::size_t i = 0; i < cv.size(); ++i)
+    EXPECT_DOUBLE_EQ(cv[i], cs[i]);
+}
+
+TEST(ContractBlasBatched, StridedBatchedGemm)
+{
+  // C(p, i, j) = Σ_q A(p, i, q) B(q, p, j) for every batch index p; C has no unit stride, so every batch is packed
+  // through TTGT scratch. With 64 batches the parallel version runs whole batches concurrently, with 16 it tiles
+  // each gemm.
+  constexpr std::size_t M = 24, K = 20, N = 18;
+  for (std::size_t NB : {std::size_t(16), std::size_t(64)})
+  {
+    index_t const nb = static_cast<index_t>(NB);
+    std::vector<double> av(NB * M * K), bv(K * NB * N), cv(NB * M * N, 1.0), ref(cv);
+    std::iota(av.begin(), av.end(), -100.0);
+    for (std::size_t x = 0; x < bv.size(); ++x)
+      bv[x] = static_cast<double>(x % 9) - 4.0;
+    stdex::mdspan<double, stdex::dextents<index_t, 3>, stdex::layout_stride> A(
+        av.data(), make_mapping<3>(std::array{NB, M, K}, std::array<index_t, 3>{M * K, K, 1}));
+    stdex::mdspan<double, stdex::dextents<index_t, 3>, stdex::layout_stride> B(
+        bv.data(), make_mapping<3>(std::array{K, NB, N}, std::array<index_t, 3>{nb * index_t(N), N, 1}));
+    stdex::mdspan<double, stdex::dextents<index_t, 3>, stdex::layout_stride> C(
+        cv.data(), make_mapping<3>(std::array{NB, M, N}, std::array<index_t, 3>{1, nb, nb * index_t(M)}));
+
+    for (std::size_t p = 0; p < NB; ++p)
+      for (std::size_t i = 0; i < M; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+        {
+          double sum = 0;
+          for (std::size_t q = 0; q < K; ++q)
+            sum += av[(p * M + i) * K + q] * bv[(q * NB + p) * N + j];
+          ref[p + i * NB + j * NB * M] = 3.0 * ref[p + i * NB + j * NB * M] + 0.5 * sum;
+        }
+
+    std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{2, 0}}};
+    std::array<std::pair<std::size_t, std::size_t>, 1> batch{{{0, 1}}};
+    std::vector<double> cp(cv);
+    contract_batched(0.5, A, B, dims, batch, 3.0, C, blas_tag{});
+    for (std::size_t x = 0; x < cv.size(); ++x)
+      ASSERT_NEAR(cv[x], ref[x], 1e-8) << NB << ' ' << x;
+
+    oneapi::tbb::task_arena arena(4);
+    stdex::mdspan<double, stdex::dextents<index_t, 3>, stdex::layout_stride> Cp(cp.data(), C.mapping());
+    contract_batched_parallel(0.5, A, B, dims, batch, 3.0, Cp, blas_tag{}, &arena);
+    for (std::size_t x = 0; x < cp.size(); ++x)
+      ASSERT_NEAR(cp[x], ref[x], 1e-8) << NB << ' ' << x;
+  }
+}
+
+TEST(ContractBlasConj, TransposedOperandUsesConjTrans)
+{
+  using T = std::complex<double>;
+  constexpr std::size_t M = 40, K = 36, N = 32;
+  std::vector<T> av(M * K), bv(K * N), c0(M * N, T(1, -1));
+  for (std::size_t x = 0; x < av.size(); ++x)
+    av[x] = T(double(x % 9) - 4, double(x % 4) - 1.5);
+  for (std::size_t x = 0; x < bv.size(); ++x)
+    bv[x] = T(double(x % 5) - 2, double(x % 6) - 2.5);
+
+  // row-major A is a transposed column-major operand, so conj(A) is a single gemm with 'C'
+  auto Arow = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto Acol = make_strided_view<2>(av, {M, K}, {1, M});
+  auto B = make_strided_view<2>(bv, {K, N}, {1, K});
+  std::vector<T> cv(c0);
+  auto C = make_strided_view<2>(cv, {M, N}, {1, M});
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+  auto [Mg, Ng, Kg] = extract_strides(Arow, B, dims, C);
+  auto plan = kernel::blas::make_ttgt_plan(Mg, Ng, Kg, true, false);
+  ASSERT_TRUE(plan);
+  EXPECT_TRUE(plan->is_direct());
+  EXPECT_EQ(plan->gemm.a.trans, 'C');
+
+  // column-major A would be passed untransposed, so it is conjugated while packing instead
+  auto [Mg2, Ng2, Kg2] = extract_strides(Acol, B, dims, C);
+  auto plan2 = kernel::blas::make_ttgt_plan(Mg2, Ng2, Kg2, true, false);
+  ASSERT_TRUE(plan2);
+  EXPECT_TRUE(plan2->pack_a);
+  EXPECT_TRUE(plan2->conj_a);
+
+  for (auto A : {Arow, Acol})
+  {
+    for (int flags = 0; flags < 4; ++flags)
+    {
+      bool const ca = flags & 1, cb = flags & 2;
+      std::fill(cv.begin(), cv.end(), T(1, -1));
+      contract(T(0.5), A, B, dims, T(2), C, blas_tag{}, contract_options<>{.conj_a = ca, .conj_b = cb});
+      for (std::size_t i = 0; i < M; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+        {
+          T acc{};
+          for (std::size_t k = 0; k < K; ++k)
+          {
+            T a = A[i, k], b = B[k, j];
+            acc += (ca ? std::conj(a) : a) * (cb ? std::conj(b) : b);
+          }
+          ASSERT_NEAR(std::abs((C[i, j]) - (T(2) * T(1, -1) + T(0.5) * acc)), 0.0, 1e-9) << flags;
+        }
+    }
+  }
+}
+
+// Test: an epilogue functor is applied after an in-place gemm, and a scaled epilogue routes C through TTGT
+// scratch so that the scaling is applied in the scatter pass.
+TEST(ContractBlasEpilogue, FunctorAndScaling)
+{
+  constexpr std::size_t M = 48, K = 40, N = 36;
+  std::vector<double> av(M * K), bv(K * N), c0(M * N), dm(M), dn(N);
+  for (std::size_t x = 0; x < av.size(); ++x)
+    av[x] = double(x % 9) - 4;
+  for (std::size_t x = 0; x < bv.size(); ++x)
+    bv[x] = double(x % 7) - 3;
+  for (std::size_t x = 0; x < c0.size(); ++x)
+    c0[x] = double(x % 5) - 2;
+  for (std::size_t x = 0; x < M; ++x)
+    dm[x] = 0.25 * double(x % 6);
+  for (std::size_t x = 0; x < N; ++x)
+    dn[x] = 1.0 - 0.5 * double(x % 3);
+
+  auto A = make_strided_view<2>(av, {M, K}, {1, M});
+  auto B = make_strided_view<2>(bv, {K, N}, {1, K});
+  std::vector<double> cv(c0);
+  auto C = make_strided_view<2>(cv, {M, N}, {ptrdiff_t(N), 1});
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+  auto [Mg, Ng, Kg] = extract_strides(A, B, dims, C);
+  auto direct = kernel::blas::make_ttgt_plan(Mg, Ng, Kg);
+  ASSERT_TRUE(direct);
+  EXPECT_TRUE(direct->is_direct());
+  auto packed = kernel::blas::make_ttgt_plan(Mg, Ng, Kg, false, false, true);
+  ASSERT_TRUE(packed);
+  EXPECT_TRUE(packed->pack_c);
+  EXPECT_FALSE(packed->pack_a || packed->pack_b);
+
+  auto leaky = [](double x) { return x > 0 ? x : 0.125 * x; };
+  auto ref = reference_matmul(2.0, A, B, 0.0, c0, N);
+
+  contract(2.0, A, B, dims, -1.0, C, blas_tag{}, contract_epilogue<double, 2, decltype(leaky)>{{}, leaky});
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), leaky(ref[i * N + j] - c0[i * N + j]));
+
+  std::copy(c0.begin(), c0.end(), cv.begin());
+  contract(2.0, A, B, dims, -1.0, C, blas_tag{}, contract_epilogue<double, 2, decltype(leaky)>{{dm, dn}, leaky});
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), leaky(ref[i * N + j] * dm[i] * dn[j] - c0[i * N + j]));
+}
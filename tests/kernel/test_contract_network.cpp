@@ -0,0 +1,197 @@
+#include "../helpers.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/contract_network.hpp>
+#include "gtest/gtest.h"
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+namespace
+{
+
+// resize v to hold a row-major tensor of the given extents
+template <std::size_t R> auto make_row_major(std::vector<double>& v, std::array<std::size_t, R> ext)
+{
+  std::array<index_t, R> strides{};
+  index_t s = 1;
+  for (std::size_t i = R; i-- > 0;)
+  {
+    strides[i] = s;
+    s *= static_cast<index_t>(ext[i]);
+  }
+  v.resize(static_cast<std::size_t>(s));
+  return make_strided_view<R>(v, ext, strides);
+}
+
+void fill(std::vector<double>& v, double start)
+{
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = start + 0.25 * static_cast<double>(i % 7) - 0.1 * static_cast<double>(i % 3);
+}
+
+} // namespace
+
+TEST(ContractNetwork, ParseSpec)
+{
+  auto s = parse_network_spec("ab, bc ,cd->ad");
+  ASSERT_EQ(s.inputs.size(), 3u);
+  EXPECT_EQ(s.inputs[0], "ab");
+  EXPECT_EQ(s.inputs[1], "bc");
+  EXPECT_EQ(s.inputs[2], "cd");
+  EXPECT_EQ(s.output, "ad");
+
+  EXPECT_DEATH(parse_network_spec("ab,bc"), "requires '->'");
+  EXPECT_DEATH(parse_network_spec("ab,bc,bd->ad"), "exactly twice"); // hyperedge
+  EXPECT_DEATH(parse_network_spec("ab,bc->a"), "exactly twice");     // dangling leg
+  EXPECT_DEATH(parse_network_spec("ab,b->ad"), "exactly one input"); // output-only label
+  EXPECT_DEATH(parse_network_spec("aa,bc->bc"), "traces");           // trace within an input
+}
+
+TEST(ContractNetwork, OptimalMatrixChain)
+{
+  // (AB)C costs 10·1000·5 + 10·5·800 multiply-adds; A(BC) costs 100 times more
+  std::vector<std::vector<index_type>> ext{{10, 1000}, {1000, 5}, {5, 800}};
+  auto path = plan_network("ab,bc,cd->ad", ext, NetworkOrder::Optimal);
+  ASSERT_EQ(path.steps.size(), 2u);
+  EXPECT_EQ(path.steps[0], (std::pair<std::size_t, std::size_t>(0, 1)));
+  EXPECT_EQ(path.steps[1], (std::pair<std::size_t, std::size_t>(3, 2)));
+  EXPECT_DOUBLE_EQ(path.flops, 10.0 * 1000 * 5 + 10.0 * 5 * 800);
+  EXPECT_DOUBLE_EQ(path.peak_size, 10.0 * 800);
+
+  auto greedy = plan_network("ab,bc,cd->ad", ext, NetworkOrder::Greedy);
+  EXPECT_DOUBLE_EQ(greedy.flops, path.flops);
+}
+
+TEST(ContractNetwork, OptimalSearchRejectsLargeNetworks)
+{
+  // a chain of network_optimal_max_inputs + 1 matrices
+  std::size_t const n = network_optimal_max_inputs + 1;
+  std::string spec;
+  for (std::size_t t = 0; t < n; ++t)
+    spec += std::string(t ? "," : "") + char('a' + t) + char('a' + t + 1);
+  spec += std::string("->a") + char('a' + n);
+  std::vector<std::vector<index_type>> ext(n, std::vector<index_type>{2, 2});
+
+  EXPECT_EQ(plan_network(spec, ext).steps.size(), n - 1);
+  EXPECT_DEATH(plan_network(spec, ext, NetworkOrder::Optimal), "exhaustive order search");
+}
+
+TEST(ContractNetwork, GreedyAvoidsOuterProducts)
+{
+  // A and C share no leg; contracting them first would build a 100×100×100 intermediate
+  std::vector<std::vector<index_type>> ext{{100, 2}, {2, 100}, {100, 100}};
+  auto path = plan_network("ab,bc,dc->ad", ext, NetworkOrder::Greedy);
+  ASSERT_EQ(path.steps.size(), 2u);
+  auto [a, b] = path.steps[0];
+  EXPECT_TRUE((a == 1 && b == 2) || (a == 0 && b == 1));
+  EXPECT_LE(path.peak_size, 100.0 * 100);
+}
+
+TEST(ContractNetwork, ExecuteMatchesReference)
+{
+  constexpr std::size_t I = 3, J = 4, K = 5, L = 2, M = 3;
+  std::vector<double> av, bv, cv, dv;
+  auto A = make_row_major<3>(av, {I, J, K}); // ijk
+  auto B = make_row_major<2>(bv, {K, L});    // kl
+  auto C = make_row_major<3>(cv, {J, L, M}); // jlm
+  auto D = make_row_major<2>(dv, {M, I});    // qp
+  fill(av, 1.0);
+  fill(bv, -0.5);
+  fill(cv, 0.75);
+  fill(dv, 0.1);
+
+  std::vector<double> ev;
+  auto E = make_row_major<2>(ev, {I, M}); // pq
+  fill(ev, 2.0);
+  std::vector<double> outv;
+  auto Out = make_row_major<2>(outv, {M, I});
+  std::fill(outv.begin(), outv.end(), 1.0);
+
+  // Out(m,i) = 2·Out(m,i) + 0.5·Σ A(i,j,k) B(k,l) C(j,l,m) · Σ E(p,q) D(q,p)
+  contract_network("ijk,kl,jlm,pq,qp->mi", 0.5, 2.0, Out, cpu_tag{}, A, B, C, E, D);
+
+  double trace = 0;
+  for (std::size_t p = 0; p < I; ++p)
+    for (std::size_t q = 0; q < M; ++q)
+      trace += E[p, q] * D[q, p];
+
+  for (std::size_t m = 0; m < M; ++m)
+    for (std::size_t i = 0; i < I; ++i)
+    {
+      double sum = 0;
+      for (std::size_t j = 0; j < J; ++j)
+        for (std::size_t k = 0; k < K; ++k)
+          for (std::size_t l = 0; l < L; ++l)
+            sum += A[i, j, k] * B[k, l] * C[j, l, m];
+      EXPECT_NEAR((Out[m, i]), 2.0 + 0.5 * sum * trace, 1e-10) << m << ' ' << i;
+    }
+}
+
+TEST(ContractNetwork, ExplicitPathAndRing)
+{
+  constexpr std::size_t N = 4;
+  std::vector<double> av, bv, cv, dv, outv;
+  auto A = make_row_major<2>(av, {N, N});
+  auto B = make_row_major<2>(bv, {N, N});
+  auto C = make_row_major<2>(cv, {N, N});
+  auto D = make_row_major<2>(dv, {N, N});
+  auto Out = make_row_major<2>(outv, {N, N});
+  fill(av, 0.3);
+  fill(bv, -0.2);
+  fill(cv, 0.1);
+  fill(dv, 0.5);
+
+  // Out(a,e) = Σ A(a,b) B(b,c) C(c,d) D(d,e), pairing (A,B) and (C,D) first
+  network_path path;
+  path.steps = {{0, 1}, {2, 3}, {4, 5}};
+  execute_network("ab,bc,cd,de->ae", path, 1.0, 0.0, Out, cpu_tag{}, A, B, C, D);
+
+  for (std::size_t a = 0; a < N; ++a)
+    for (std::size_t e = 0; e < N; ++e)
+    {
+      double ref = 0;
+      for (std::size_t b = 0; b < N; ++b)
+        for (std::size_t c = 0; c < N; ++c)
+          for (std::size_t d = 0; d < N; ++d)
+            ref += A[a, b] * B[b, c] * C[c, d] * D[d, e];
+      EXPECT_NEAR((Out[a, e]), ref, 1e-12);
+    }
+}
+
+TEST(ContractNetwork, RejectsInvalidPathsAndExtents)
+{
+  std::vector<double> av, bv, cv, dv, outv, badv;
+  auto A = make_row_major<2>(av, {3, 4});
+  auto B = make_row_major<2>(bv, {4, 5});
+  auto C = make_row_major<2>(cv, {5, 6});
+  auto D = make_row_major<2>(dv, {5, 6});
+  auto Out = make_row_major<2>(outv, {3, 6});
+  auto Bad = make_row_major<2>(badv, {3, 5});
+
+  network_path path;
+  path.steps = {{0, 1}, {0, 2}}; // A is contracted twice and the intermediate never
+  EXPECT_DEATH(execute_network("ab,bc,cd->ad", path, 1.0, 0.0, Out, cpu_tag{}, A, B, C), "already contracted");
+
+  path.steps = {{0, 1}, {3, 2}};
+  EXPECT_DEATH(execute_network("ab,bc,cd->ad", path, 1.0, 0.0, Bad, cpu_tag{}, A, B, C), "output extent");
+  EXPECT_DEATH(execute_network("ab,bc,cd->ad", path, 1.0, 0.0, Out, cpu_tag{}, A, C, D), "inconsistent extent");
+
+  network_path empty;
+  EXPECT_DEATH(execute_network("ab->ab", empty, 1.0, 0.0, A, cpu_tag{}, A), "at least two inputs");
+}
+
+TEST(ContractNetwork, BufferPoolReuse)
+{
+  kernel::detail::network_buffer_pool<double> pool;
+  auto a = pool.acquire(100);
+  auto b = pool.acquire(10);
+  pool.release(a);
+  pool.release(b);
+  EXPECT_EQ(pool.acquire(50), a); // smallest buffer that fits
+  EXPECT_EQ(pool.acquire(5), b);
+  EXPECT_EQ(pool.allocated(), 2u);
+  EXPECT_EQ(pool.data(b)[4], 0.0);
+}
@@ -0,0 +1,102 @@
+#include "../helpers.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/contract.hpp>
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <oneapi/tbb/task_arena.h>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+TEST(ContractPartition, SmallContractionIsSerial)
+{
+  auto p = cpu::partition_contraction(16, 16, 16, 64, 4, 8, 256);
+  EXPECT_TRUE(p.is_serial(16, 16));
+}
+
+TEST(ContractPartition, LargeOutputIsTiled)
+{
+  auto p = cpu::partition_contraction(1024, 1024, 512, 8, 4, 8, 256);
+  EXPECT_FALSE(p.is_serial(1024, 1024));
+  EXPECT_EQ(p.k_chunks, 1);
+  EXPECT_EQ(p.tile_m % 4, 0);
+  EXPECT_EQ(p.tile_n % 8, 0);
+  EXPECT_GE(((1024 + p.tile_m - 1) / p.tile_m) * ((1024 + p.tile_n - 1) / p.tile_n), 8);
+}
+
+TEST(ContractPartition, SmallOutputSplitsK)
+{
+  auto p = cpu::partition_contraction(8, 8, 100000, 4, 4, 8, 256);
+  EXPECT_GT(p.k_chunks, 1);
+  auto q = cpu::partition_contraction(8, 8, 100000, 4, 4, 8, 256, false);
+  EXPECT_EQ(q.k_chunks, 1);
+}
+
+TEST(ContractParallel, MatchesSerialOnArena)
+{
+  constexpr std::size_t M = 150, K = 130, N = 170;
+  std::vector<double> av(M * K), bv(K * N), cv(M * N), cs(M * N);
+  for (std::size_t i = 0; i < av.size(); ++i)
+    av[i] = double(int(i % 19) - 9) / 8;
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    bv[i] = double(int(i % 23) - 11) / 4;
+  std::iota(cv.begin(), cv.end(), 0.0);
+  cs = cv;
+
+  // A transposed in memory and C column-major, to exercise strided groups
+  auto A = make_strided_view<2>(av, {M, K}, {1, M});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {1, M});
+  auto Cs = make_strided_view<2>(cs, {M, N}, {1, M});
+
+  oneapi::tbb::task_arena arena(4);
+  contract_parallel(0.5, A, B, {{1, 0}}, 2.0, C, cpu_tag{}, &arena);
+  contract(0.5, A, B, {{1, 0}}, 2.0, Cs, cpu_tag{});
+
+  for (std::size_t i = 0; i < cv.size(); ++i)
+    EXPECT_DOUBLE_EQ(cv[i], cs[i]);
+}
+
+TEST(ContractParallel, SplitKReduction)
+{
+  using cplx = std::complex<double>;
+  constexpr std::size_t M = 4, K = 40000, N = 3;
+  std::vector<cplx> av(M * K), bv(K * N), cv(M * N, cplx{1.0, 1.0});
+  for (std::size_t i = 0; i < av.size(); ++i)
+    av[i] = cplx(double(i % 5) - 2, double(i % 3));
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    bv[i] = cplx(double(i % 7) / 7, -1.0);
+
+  auto A = make_strided_view<2>(av, {M, K}, {K, 1});
+  auto B = make_strided_view<2>(bv, {K, N}, {N, 1});
+  auto C = make_strided_view<2>(cv, {M, N}, {N, 1});
+
+  std::vector<cplx> cref(M * N);
+  for (std::size_t i = 0; i < M; ++i)
+    for (std::size_t j = 0; j < N; ++j)
+    {
+      cplx acc{};
+      for (std::size_t k = 0; k < K; ++k)
+        acc += av[i * K + k] * bv[k * N + j];
+      cref[i * N + j] = cplx{-1.0, 0.0} * cv[i * N + j] + acc;
+    }
+
+  oneapi::tbb::task_arena arena(4);
+  contract_parallel(cplx{1.0}, A, B, {{1, 0}}, cplx{-1.0}, C, cpu_tag{}, &arena);
+
+  for (std::size_t i = 0; i < cv.size(); ++i)
+    EXPECT_NEAR(std::abs(cv[i] - cref[i]), 0.0, 1e-9 * std::abs(cref[i]));
+
+  // with beta = 0 the previous contents of C are not read
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  std::fill(cv.begin(), cv.end(), cplx{nan, nan});
+  contract_parallel(cplx{1.0}, A, B, {{1, 0}}, cplx{}, C, cpu_tag{}, &arena);
+  for (std::size_t i = 0; i < cv.size(); ++i)
+  {
+    cplx const acc = cref[i] - cplx{-1.0, 0.0} * cplx{1.0, 1.0};
+    EXPECT_NEAR(std::abs(cv[i] - acc), 0.0, 1e-9 * std::abs(acc));
+  }
+}
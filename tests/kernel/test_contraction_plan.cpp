@@ -0,0 +1,115 @@
+#include "../helpers.hpp"
+#include <uni20/common/mdspan.hpp>
+#include <uni20/kernel/contraction_plan.hpp>
+#include "gtest/gtest.h"
+#include <numeric>
+
+using namespace uni20;
+using namespace uni20::kernel;
+
+TEST(ContractionPlan, SelectsBackendBySize)
+{
+  std::vector<double> small(16), large(64 * 64);
+  auto As = make_mdspan_2d(small, 4, 4, {4, 1});
+  auto Al = make_mdspan_2d(large, 64, 64, {64, 1});
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+  auto ps = make_contraction_plan(As, As, dims, As, cpu_tag{});
+  EXPECT_EQ(ps.backend(), ContractionBackend::Loop);
+  EXPECT_EQ(ps.scratch_bytes(), 0u);
+
+  auto pl = make_contraction_plan(Al, Al, dims, Al, cpu_tag{});
+  EXPECT_EQ(pl.backend(), ContractionBackend::Blocked);
+  EXPECT_GT(pl.scratch_bytes(), 0u);
+  ASSERT_EQ(pl.m_group().size(), 1u);
+  EXPECT_EQ(pl.m_group()[0].extent, 64);
+}
+
+TEST(ContractionPlan, ExecuteMatchesContract)
+{
+  constexpr std::size_t M = 3, K = 5, N = 4;
+  std::vector<double> av(M * K), bv(K * N), c1(M * N, 1.0), c2(M * N, 1.0);
+  std::iota(av.begin(), av.end(), 1.0);
+  std::iota(bv.begin(), bv.end(), -4.0);
+  auto A = make_mdspan_2d(av, M, K, {1, M});
+  auto B = make_mdspan_2d(bv, K, N, {N, 1});
+  auto C1 = make_mdspan_2d(c1, M, N, {N, 1});
+  auto C2 = make_mdspan_2d(c2, M, N, {N, 1});
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+  auto plan = make_contraction_plan(A, B, dims, C1, cpu_tag{});
+  plan.execute(2.0, A.data_handle(), B.data_handle(), 3.0, C1.data_handle());
+  plan.execute(2.0, A.data_handle(), B.data_handle(), 3.0, C1.data_handle());
+  contract(2.0, A, B, dims, 3.0, C2, cpu_tag{});
+  contract(2.0, A, B, dims, 3.0, C2, cpu_tag{});
+
+  for (std::size_t i = 0; i < c1.size(); ++i)
+    EXPECT_DOUBLE_EQ(c1[i], c2[i]);
+}
+
+TEST(ContractionPlan, BlockedPlanReusesEngineAndScratch)
+{
+  constexpr std::size_t M = 40, K = 48, N = 36;
+  std::vector<double> av(M * K), bv(K * N), c1(M * N, 1.0), c2(M * N, 1.0);
+  for (std::size_t i = 0; i < av.size(); ++i)
+    av[i] = double(int(i % 13) - 6);
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    bv[i] = double(int(i % 11) - 5) / 2;
+  auto A = make_mdspan_2d(av, M, K, {1, M});
+  auto B = make_mdspan_2d(bv, K, N, {N, 1});
+  auto C1 = make_mdspan_2d(c1, M, N, {N, 1});
+  auto C2 = make_mdspan_2d(c2, M, N, {N, 1});
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+  auto plan = make_contraction_plan(A, B, dims, C1, cpu_tag{});
+  ASSERT_EQ(plan.backend(), ContractionBackend::Blocked);
+  cpu::BlockedGemm<double> Engine(plan.m_group(), plan.n_group(), plan.k_group(), 1.0, 0.0);
+  EXPECT_EQ(plan.scratch_bytes(), static_cast<std::size_t>(Engine.workspace_size()) * sizeof(double));
+
+  for (int rep = 0; rep < 2; ++rep)
+  {
+    plan.execute(2.0, A.data_handle(), B.data_handle(), -1.0, C1.data_handle());
+    contract(2.0, A, B, dims, -1.0, C2, cpu_tag{});
+  }
+  for (std::size_t i = 0; i < c1.size(); ++i)
+    EXPECT_DOUBLE_EQ(c1[i], c2[i]);
+}
+
+TEST(ContractionPlanCache, ReusesPlansForSameLayout)
+{
+  auto& cache = contraction_plan_cache<double, 2, 2, 2, 1, cpu_tag>();
+  cache.clear();
+
+  std::vector<double> av(6, 1.0), bv(6, 2.0), cv(4, 0.0), dv(9, 0.0);
+  auto A = make_mdspan_2d(av, 2, 3, {3, 1});
+  auto B = make_mdspan_2d(bv, 3, 2, {2, 1});
+  auto C = make_mdspan_2d(cv, 2, 2, {2, 1});
+  std::array<std::pair<std::size_t, std::size_t>, 1> dims{{{1, 0}}};
+
+  contract_cached(1.0, A, B, dims, 0.0, C, cpu_tag{});
+  contract_cached(1.0, A, B, dims, 1.0, C, cpu_tag{});
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.misses(), 1u);
+  EXPECT_EQ(cache.hits(), 1u);
+  for (double c : cv)
+    EXPECT_DOUBLE_EQ(c, 12.0);
+
+  // Same extents, different output strides: a new plan.
+  auto Ct = make_mdspan_2d(dv, 2, 2, {1, 3});
+  contract_cached(1.0, A, B, dims, 0.0, Ct, cpu_tag{});
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_DOUBLE_EQ((Ct[1, 1]), 6.0);
+}
+
+TEST(ContractionPlanCache, EvictsLeastRecentlyUsed)
+{
+  ContractionPlanCache<int, int, std::hash<int>> cache(2);
+  auto make = [](int v) { return [v] { return v; }; };
+  cache.get_or_create(1, make(10));
+  cache.get_or_create(2, make(20));
+  cache.get_or_create(1, make(-1)); // touch 1
+  cache.get_or_create(3, make(30)); // evicts 2
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(*cache.get_or_create(1, make(-1)), 10);
+  EXPECT_EQ(*cache.get_or_create(2, make(21)), 21);
+}
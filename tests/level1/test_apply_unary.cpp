@@ -2,6 +2,7 @@
 #include <uni20/level1/apply_unary.hpp>
 #include "gtest/gtest.h"
 #include <numeric>
+#include <oneapi/tbb/task_arena.h>
 
 using namespace uni20;
 
@@ -114,3 +115,53 @@ TEST(ApplyUnaryInplace, NonMergeable4DDispatchesDynamically)
           EXPECT_DOUBLE_EQ(storage[idx], expected);
         }
 }
+
+TEST(ApplyUnaryInplace, SimdOpWithStridedOuterDim)
+{
+  // 4 rows of 11 contiguous elements, every other row of a 8×11 buffer: the inner loop runs through the SIMD
+  // path with a scalar remainder, the outer loop is strided
+  std::vector<double> v(8 * 11);
+  std::iota(v.begin(), v.end(), 0.0);
+  auto m = make_mdspan_2d(v, 4, 11, {22, 1});
+
+  apply_unary_inplace(m, simd::simd_op{[](auto x) { return x * 3 - 1; }});
+
+  for (std::size_t r = 0; r < 8; ++r)
+    for (std::size_t c = 0; c < 11; ++c)
+    {
+      double const orig = double(r * 11 + c);
+      EXPECT_DOUBLE_EQ(v[r * 11 + c], r % 2 == 0 ? orig * 3 - 1 : orig);
+    }
+}
+
+TEST(ApplyUnaryInplace, ParallelFusesShortOuterDims)
+{
+  // 3×5×(37 of 40) sub-block: the two outer dimensions are too short to split alone, so the parallel range
+  // covers their product and each task runs the innermost loop
+  std::vector<double> v(3 * 5 * 40);
+  std::iota(v.begin(), v.end(), 0.0);
+  std::vector<double> expected = v;
+  auto m = make_mdspan_strided<3>(v, {3, 5, 37}, {200, 40, 1});
+  apply_unary_inplace(make_mdspan_strided<3>(expected, {3, 5, 37}, {200, 40, 1}), [](double x) { return x * x; });
+
+  oneapi::tbb::task_arena arena(4);
+  apply_unary_inplace(par.on(arena).with_min_size(0), m, [](double x) { return x * x; });
+  EXPECT_EQ(v, expected);
+}
+
+TEST(ApplyUnaryInplace, ParallelBelowThresholdIsSerial)
+{
+  std::vector<double> v(10);
+  std::iota(v.begin(), v.end(), 0.0);
+  auto m = make_reversed_1d(v);
+
+  int calls = 0;
+  apply_unary_inplace(par, m, [&calls](double x) {
+    ++calls; // safe only because a span this small never leaves the calling thread
+    return x + 1;
+  });
+
+  EXPECT_EQ(calls, 10);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    EXPECT_EQ(v[i], double(i) + 1);
+}
@@ -1,8 +1,11 @@
 #include "../helpers.hpp"
 #include <uni20/level1/assign.hpp>
+#include <uni20/level1/sum.hpp>
 #include <uni20/level1/zip_transform.hpp>
+#include <uni20/mdspan/broadcast.hpp>
 #include "gtest/gtest.h"
 #include <numeric>
+#include <oneapi/tbb/task_arena.h>
 
 using namespace uni20;
 
@@ -81,6 +84,135 @@ TEST(MultiIterationPlanTest, AllStridesFlippedWhenOutputIsNegative)
   EXPECT_EQ(offsets[1], 12);         // (5-1) * -3
 }
 
+TEST(MultiIterationPlanTest, CostModelFollowsMostOperands)
+{
+  // a column-major output written from two row-major inputs: the inputs' unit-stride dimension goes innermost
+  auto out = make_mapping(std::array<std::size_t, 2>{6, 7}, std::array<index_t, 2>{1, 6});
+  auto x = make_mapping(std::array<std::size_t, 2>{6, 7}, std::array<index_t, 2>{7, 1});
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{out, x, x});
+
+  ASSERT_EQ(plan.size(), 2);
+  EXPECT_EQ(plan[1].extent, 7);
+  EXPECT_EQ(plan[1].strides[0], 6);
+  EXPECT_EQ(plan[1].strides[1], 1);
+  EXPECT_EQ(plan[1].strides[2], 1);
+}
+
+TEST(MultiIterationPlanTest, ElementSizesWeightTheOrder)
+{
+  // float output against a transposed 16-byte input: streaming the wider input is cheaper
+  auto out = make_mapping(std::array<std::size_t, 2>{5, 9}, std::array<index_t, 2>{9, 1});
+  auto in = make_mapping(std::array<std::size_t, 2>{5, 9}, std::array<index_t, 2>{1, 5});
+
+  auto [equal, equal_offsets] = make_multi_iteration_plan_with_offset(std::array{out, in});
+  EXPECT_EQ(equal[1].strides[0], 1); // a tie, broken in favour of the first mapping
+
+  auto [weighted, weighted_offsets] =
+      make_multi_iteration_plan_with_offset(std::array{out, in}, std::array<std::size_t, 2>{4, 16});
+  ASSERT_EQ(weighted.size(), 2);
+  EXPECT_EQ(weighted[1].strides[1], 1);
+  EXPECT_EQ(weighted[1].extent, 5);
+}
+
+TEST(MultiIterationPlanTest, TransposeIsTiled)
+{
+  auto row = make_mapping(std::array<std::size_t, 2>{256, 256}, std::array<index_t, 2>{256, 1});
+  auto col = make_mapping(std::array<std::size_t, 2>{256, 256}, std::array<index_t, 2>{1, 256});
+  std::array<std::size_t, 2> const sizes{8, 8};
+
+  auto [transpose, t_offsets] = make_multi_iteration_plan_with_offset(std::array{row, col}, sizes);
+  EXPECT_EQ(detail::plan_tile_extent(transpose, sizes), 32); // 32×32 tiles of two doubles fill 16 KiB
+
+  auto [copy, c_offsets] = make_multi_iteration_plan_with_offset(std::array{row, row}, sizes);
+  EXPECT_EQ(detail::plan_tile_extent(copy, sizes), 0);
+
+  // a small transpose stays within a few cache lines and is not tiled
+  auto small_row = make_mapping(std::array<std::size_t, 2>{4, 4}, std::array<index_t, 2>{4, 1});
+  auto small_col = make_mapping(std::array<std::size_t, 2>{4, 4}, std::array<index_t, 2>{1, 4});
+  auto [small, s_offsets] = make_multi_iteration_plan_with_offset(std::array{small_row, small_col}, sizes);
+  EXPECT_EQ(detail::plan_tile_extent(small, sizes), 0);
+}
+
+TEST(MultiIterationPlanTest, TilesCoverEveryElementOnce)
+{
+  auto a = make_mapping(std::array<std::size_t, 3>{3, 70, 45}, std::array<index_t, 3>{70 * 45, 45, 1});
+  auto b = make_mapping(std::array<std::size_t, 3>{3, 70, 45}, std::array<index_t, 3>{70 * 45, 1, 70});
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{a, b});
+  ASSERT_EQ(plan.size(), 3);
+
+  std::vector<int> seen_a(3 * 70 * 45), seen_b(3 * 70 * 45);
+  detail::for_each_tile(plan, offsets, 16, [&](auto const& sub, auto o) {
+    ASSERT_EQ(sub.size(), 2);
+    EXPECT_LE(sub[0].extent, 16);
+    EXPECT_LE(sub[1].extent, 16);
+    detail::for_each_offset(sub, o, [&](auto const& e) {
+      ++seen_a[e[0]];
+      ++seen_b[e[1]];
+    });
+  });
+  EXPECT_EQ(seen_a, std::vector<int>(seen_a.size(), 1));
+  EXPECT_EQ(seen_b, std::vector<int>(seen_b.size(), 1));
+}
+
+TEST(MultiIterationPlanTest, BroadcastOperandIsHoisted)
+{
+  // c[i, j] = a[i, j] * v[i] with row-major c and a: v is reused across the innermost loop and nothing is tiled
+  auto c = make_mapping(std::array<std::size_t, 2>{300, 300}, std::array<index_t, 2>{300, 1});
+  auto v = make_mapping(std::array<std::size_t, 2>{300, 300}, std::array<index_t, 2>{1, 0});
+  std::array<std::size_t, 3> const sizes{8, 8, 8};
+  auto [plan, offsets] = make_multi_iteration_plan_with_offset(std::array{c, c, v}, sizes);
+
+  ASSERT_EQ(plan.size(), 2);
+  EXPECT_EQ(plan[1].strides[0], 1);
+  EXPECT_EQ(plan[1].strides[2], 0);
+  EXPECT_EQ(plan[0].strides[2], 1);
+  EXPECT_EQ(detail::plan_tile_extent(plan, sizes), 0);
+
+  // broadcast along both dimensions: the zero strides merge with each other
+  auto s = make_mapping(std::array<std::size_t, 2>{300, 300}, std::array<index_t, 2>{0, 0});
+  auto [merged, m_offsets] = make_multi_iteration_plan_with_offset(std::array{c, s}, std::array<std::size_t, 2>{8, 8});
+  ASSERT_EQ(merged.size(), 1);
+  EXPECT_EQ(merged[0].extent, 90000);
+  EXPECT_EQ(merged[0].strides[1], 0);
+}
+
+TEST(Assign, BroadcastVectorAlongEachLeg)
+{
+  std::array<std::size_t, 3> const extents{4, 7, 19};
+  std::vector<double> a(4 * 7 * 19), out(a.size());
+  std::iota(a.begin(), a.end(), 0.0);
+  auto A = make_mdspan_strided(a, extents, std::array<index_t, 3>{7 * 19, 19, 1});
+  auto Out = make_mdspan_strided(out, extents, std::array<index_t, 3>{7 * 19, 19, 1});
+
+  for (std::size_t leg = 0; leg < 3; ++leg)
+  {
+    std::vector<double> w(extents[leg]);
+    std::iota(w.begin(), w.end(), 1.0);
+    std::array<std::size_t, 3> shape{1, 1, 1};
+    shape[leg] = extents[leg];
+    std::array<index_t, 3> strides{0, 0, 0};
+    strides[leg] = 1;
+    auto W = broadcast_to(make_mdspan_strided(w, shape, strides), A.extents());
+
+    assign(zip_transform(simd::simd_op{[](auto x, auto y) { return x * y; }}, A, W), Out);
+    for (index_t i = 0; i < 4; ++i)
+      for (index_t j = 0; j < 7; ++j)
+        for (index_t k = 0; k < 19; ++k)
+        {
+          std::array<index_t, 3> idx{i, j, k};
+          EXPECT_EQ((Out[i, j, k]), (A[i, j, k]) * double(idx[leg] + 1)) << leg;
+        }
+  }
+
+  // a broadcast source assigned on its own fills every row
+  std::vector<double> row{1, 2, 3}, m(12);
+  auto Row = make_mdspan_strided(row, std::array<std::size_t, 1>{3}, std::array<index_t, 1>{1});
+  auto M = make_mdspan_2d(m, 4, 3);
+  assign(broadcast_to(Row, M.extents()), M);
+  for (std::size_t i = 0; i < 12; ++i)
+    EXPECT_EQ(m[i], row[i % 3]);
+}
+
 TEST(Assign, Simple1D)
 {
   std::vector<double> src_data = {1, 2, 3, 4};
@@ -226,3 +358,109 @@ TEST(Assign, ZeroExtentNoOp)
 
   EXPECT_EQ(dst_data, baseline);
 }
+
+TEST(AssignTest, ContiguousSimdWithRemainder)
+{
+  std::vector<double> src(5 * 13), dst(5 * 13, -1.0);
+  std::iota(src.begin(), src.end(), 0.5);
+  uni20::assign(make_mdspan_2d(src, 5, 13), make_mdspan_2d(dst, 5, 13));
+  EXPECT_EQ(src, dst);
+}
+
+TEST(AssignTest, TiledTransposeWithRemainders)
+{
+  std::size_t const R = 300, C = 257;
+  std::vector<double> src(R * C), dst(R * C, -1.0);
+  std::iota(src.begin(), src.end(), 0.0);
+
+  uni20::assign(make_mdspan_2d(src, R, C), make_mdspan_2d(dst, R, C, {1, index_t(R)}));
+
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t j = 0; j < C; ++j)
+      ASSERT_EQ(dst[i + j * R], src[i * C + j]) << i << ", " << j;
+}
+
+TEST(ParallelAssign, TransposeMatchesSerial)
+{
+  // column-major source into a row-major destination: the plan keeps both dimensions, and the split runs over
+  // the outer one
+  std::size_t const R = 300, C = 257;
+  std::vector<double> v(R * C);
+  std::iota(v.begin(), v.end(), 0.0);
+  std::vector<double> expected(R * C, 0), out(R * C, 0);
+
+  auto src = make_mdspan_2d(v, R, C, {1, std::ptrdiff_t(R)});
+  uni20::assign(src, make_mdspan_2d(expected, R, C));
+
+  oneapi::tbb::task_arena arena(4);
+  uni20::assign(par.on(arena), src, make_mdspan_2d(out, R, C));
+  EXPECT_EQ(out, expected);
+}
+
+TEST(ParallelAssign, MaterialisesZipTransformInChunks)
+{
+  // a single merged dimension of 1001 elements, forced parallel so the range is cut inside that dimension
+  std::vector<double> v(1001);
+  std::iota(v.begin(), v.end(), 0.0);
+  std::vector<double> out(1001, 0);
+
+  auto expr = zip_transform([](double x) { return 2 * x + 1; }, make_reversed_1d(v));
+
+  oneapi::tbb::task_arena arena(4);
+  auto policy = par.on(arena).with_min_size(0);
+  policy.grain = 16;
+  uni20::assign(policy, expr, make_mdspan_1d(out));
+
+  for (std::size_t i = 0; i < out.size(); ++i)
+    EXPECT_EQ(out[i], 2 * v[1000 - i] + 1);
+}
+
+TEST(FusedAssign, FlattensNestedTreeIntoLeaves)
+{
+  std::vector<double> x{1, 2, 3}, y{10, 20, 30}, z{100, 200, 300};
+  auto X = make_mdspan_1d(x), Y = make_mdspan_1d(y), Z = make_mdspan_1d(z);
+
+  // -(x + y + z) + 2·x·y: a unary node over a sum, and a binary node, under a binary root
+  auto expr = zip_transform([](double p, double q) { return p + q; },
+                            zip_transform([](double s) { return -s; }, sum_view(X, Y, Z)),
+                            zip_transform([](double a, double b) { return 2 * a * b; }, X, Y));
+
+  auto [leaves, eval] = detail::flatten_expression(expr);
+  EXPECT_EQ(std::tuple_size_v<decltype(leaves)>, 5);
+  EXPECT_EQ(eval(std::tuple{1.0, 10.0, 100.0, 1.0, 10.0}), expr[0]);
+
+  std::vector<double> out(3, 0);
+  uni20::assign(expr, make_mdspan_1d(out));
+  for (std::size_t i = 0; i < 3; ++i)
+    EXPECT_EQ(out[i], -(x[i] + y[i] + z[i]) + 2 * x[i] * y[i]);
+}
+
+TEST(FusedAssign, AxpbyWithMixedLayouts)
+{
+  // a*x + b*y + z over a row-major x, a column-major y and a reversed-row z
+  std::size_t const R = 37, C = 23;
+  std::vector<double> x(R * C), y(R * C), z(R * C), out(R * C), expected(R * C);
+  std::iota(x.begin(), x.end(), 0.0);
+  std::iota(y.begin(), y.end(), 0.5);
+  std::iota(z.begin(), z.end(), -3.0);
+  auto X = make_mdspan_2d(x, R, C);
+  auto Y = make_mdspan_2d(y, R, C, {1, std::ptrdiff_t(R)});
+  auto Z = stdex::mdspan(z.data() + (R - 1) * C, make_mapping<2>(std::array<std::size_t, 2>{R, C},
+                                                                   std::array<index_t, 2>{-index_t(C), 1}));
+  double const a = 1.5, b = -0.25;
+
+  auto expr = zip_transform([](double p, double q) { return p + q; },
+                            zip_transform([a, b](double u, double v) { return a * u + b * v; }, X, Y), Z);
+  static_assert(detail::is_flattenable<decltype(expr)>);
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t j = 0; j < C; ++j)
+      expected[i * C + j] = a * x[i * C + j] + b * y[j * R + i] + z[(R - 1 - i) * C + j];
+
+  uni20::assign(expr, make_mdspan_2d(out, R, C));
+  EXPECT_EQ(out, expected);
+
+  std::vector<double> parallel_out(R * C);
+  oneapi::tbb::task_arena arena(4);
+  uni20::assign(par.on(arena).with_min_size(0), expr, make_mdspan_2d(parallel_out, R, C));
+  EXPECT_EQ(parallel_out, expected);
+}
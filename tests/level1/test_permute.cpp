@@ -0,0 +1,218 @@
+#include "../helpers.hpp"
+#include <uni20/level1/permute.hpp>
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <oneapi/tbb/task_arena.h>
+
+using namespace uni20;
+
+namespace
+{
+
+/// Row-major strides of the given extents, each multiplied by \p step.
+template <std::size_t R> std::array<index_t, R> row_major(std::array<std::size_t, R> const& extents, index_t step = 1)
+{
+  std::array<index_t, R> strides{};
+  index_t s = step;
+  for (std::size_t d = R; d-- > 0;)
+  {
+    strides[d] = s;
+    s *= index_t(extents[d]);
+  }
+  return strides;
+}
+
+template <typename T, std::size_t R>
+auto make_view(std::vector<T>& v, std::array<std::size_t, R> const& extents, std::array<index_t, R> const& strides)
+{
+  using extents_t = stdex::dextents<index_t, R>;
+  return stdex::mdspan<T, extents_t, stdex::layout_stride>(v.data(), make_mapping(extents, strides));
+}
+
+/// Check dst[i...] == alpha·src[j...] + beta·old[i...] with axis k of dst being axis perm[k] of src, by visiting
+/// every multi-index of dst.
+template <typename S, typename D, std::size_t R, typename T = typename D::value_type>
+void expect_permuted(S const& src, D const& dst, std::array<std::size_t, R> const& perm,
+                     std::type_identity_t<T> alpha = T(1), std::vector<T> const* old = nullptr,
+                     std::type_identity_t<T> beta = T{})
+{
+  std::array<index_t, R> idx{};
+  std::size_t flat = 0;
+  for (bool more = dst.size() > 0; more; ++flat)
+  {
+    std::array<index_t, R> sidx{};
+    for (std::size_t k = 0; k < R; ++k)
+      sidx[perm[k]] = idx[k];
+    T expected = alpha * src.accessor().access(src.data_handle(), std::apply(src.mapping(), sidx));
+    if (old) expected += beta * (*old)[std::size_t(std::apply(dst.mapping(), idx))];
+    ASSERT_EQ(dst.accessor().access(dst.data_handle(), std::apply(dst.mapping(), idx)), expected)
+        << "at element " << flat;
+
+    more = false;
+    for (std::size_t d = R; d-- > 0;)
+    {
+      if (++idx[d] < index_t(dst.extent(d)))
+      {
+        more = true;
+        break;
+      }
+      idx[d] = 0;
+    }
+  }
+}
+
+template <std::size_t R>
+std::array<std::size_t, R> permuted_extents(std::array<std::size_t, R> const& extents,
+                                            std::array<std::size_t, R> const& perm)
+{
+  std::array<std::size_t, R> out{};
+  for (std::size_t k = 0; k < R; ++k)
+    out[k] = extents[perm[k]];
+  return out;
+}
+
+} // namespace
+
+TEST(Permute, MatrixTransposeWithRemainders)
+{
+  // extents that are not multiples of the micro or macro tile
+  for (auto [m, n] : {std::pair<std::size_t, std::size_t>{37, 53}, {130, 67}, {8, 8}, {3, 100}})
+  {
+    std::vector<double> a(m * n);
+    std::iota(a.begin(), a.end(), 0.0);
+    std::vector<double> b(m * n, -1);
+    auto src = make_view(a, std::array{m, n}, row_major(std::array{m, n}));
+    auto dst = make_view(b, std::array{n, m}, row_major(std::array{n, m}));
+
+    permute(src, std::array<std::size_t, 2>{1, 0}, dst);
+    expect_permuted(src, dst, std::array<std::size_t, 2>{1, 0});
+  }
+}
+
+TEST(Permute, EveryPermutationOfRank4)
+{
+  std::array<std::size_t, 4> const extents{9, 10, 11, 17};
+  std::vector<double> a(9 * 10 * 11 * 17);
+  std::iota(a.begin(), a.end(), 0.0);
+  auto src = make_view(a, extents, row_major(extents));
+
+  std::array<std::size_t, 4> perm{0, 1, 2, 3};
+  do
+  {
+    auto out_extents = permuted_extents(extents, perm);
+    std::vector<double> b(a.size(), -1);
+    auto dst = make_view(b, out_extents, row_major(out_extents));
+    permute(src, perm, dst);
+    expect_permuted(src, dst, perm);
+  } while (std::next_permutation(perm.begin(), perm.end()));
+}
+
+TEST(Permute, AlphaAndBeta)
+{
+  std::array<std::size_t, 3> const extents{20, 3, 24};
+  std::array<std::size_t, 3> const perm{2, 1, 0};
+  auto const out_extents = permuted_extents(extents, perm);
+  std::vector<double> a(20 * 3 * 24);
+  std::iota(a.begin(), a.end(), 1.0);
+  std::vector<double> b(a.size());
+  std::iota(b.begin(), b.end(), -100.0);
+  auto const old = b;
+
+  auto src = make_view(a, extents, row_major(extents));
+  auto dst = make_view(b, out_extents, row_major(out_extents));
+  permute(2.0, src, perm, -0.5, dst);
+  expect_permuted(src, dst, perm, 2.0, &old, -0.5);
+}
+
+TEST(Permute, ZeroBetaDoesNotReadDestination)
+{
+  std::array<std::size_t, 2> const extents{40, 33};
+  std::vector<double> a(40 * 33);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::vector<double> b(a.size(), std::numeric_limits<double>::quiet_NaN());
+
+  auto src = make_view(a, extents, row_major(extents));
+  auto dst = make_view(b, std::array<std::size_t, 2>{33, 40}, row_major(std::array<std::size_t, 2>{33, 40}));
+  permute(3.0, src, std::array<std::size_t, 2>{1, 0}, 0.0, dst);
+  expect_permuted(src, dst, std::array<std::size_t, 2>{1, 0}, 3.0);
+}
+
+TEST(Permute, FloatAndComplex)
+{
+  std::array<std::size_t, 3> const extents{33, 5, 40};
+  std::array<std::size_t, 3> const perm{2, 0, 1};
+  auto const out_extents = permuted_extents(extents, perm);
+
+  std::vector<float> af(33 * 5 * 40), bf(af.size());
+  std::iota(af.begin(), af.end(), 0.0f);
+  auto srcf = make_view(af, extents, row_major(extents));
+  auto dstf = make_view(bf, out_extents, row_major(out_extents));
+  permute(srcf, perm, dstf);
+  expect_permuted(srcf, dstf, perm);
+
+  using C = std::complex<double>;
+  std::vector<C> ac(af.size()), bc(af.size());
+  for (std::size_t i = 0; i < ac.size(); ++i)
+    ac[i] = C(double(i), -double(i % 7));
+  auto srcc = make_view(ac, extents, row_major(extents));
+  auto dstc = make_view(bc, out_extents, row_major(out_extents));
+  permute(C(0, 1), srcc, perm, C{}, dstc);
+  expect_permuted(srcc, dstc, perm, C(0, 1));
+}
+
+TEST(Permute, NonUnitStrides)
+{
+  // every other element of the destination, and a source transposed in memory
+  std::array<std::size_t, 2> const extents{45, 38};
+  std::vector<double> a(45 * 38);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::vector<double> b(2 * a.size(), -1);
+
+  auto src = make_view(a, extents, std::array<index_t, 2>{1, 45});
+  auto dst = make_view(b, std::array<std::size_t, 2>{38, 45}, row_major(std::array<std::size_t, 2>{38, 45}, 2));
+  permute(src, std::array<std::size_t, 2>{1, 0}, dst);
+  expect_permuted(src, dst, std::array<std::size_t, 2>{1, 0});
+  for (std::size_t i = 1; i < b.size(); i += 2)
+    EXPECT_EQ(b[i], -1);
+}
+
+TEST(Permute, IdentityStreams)
+{
+  std::array<std::size_t, 3> const extents{4, 5, 6};
+  std::vector<double> a(4 * 5 * 6);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::vector<double> b(a.size(), -1);
+  permute(make_view(a, extents, row_major(extents)), std::array<std::size_t, 3>{0, 1, 2},
+          make_view(b, extents, row_major(extents)));
+  EXPECT_EQ(a, b);
+}
+
+TEST(Permute, ParallelWithScaling)
+{
+  std::array<std::size_t, 3> const extents{70, 6, 90};
+  std::array<std::size_t, 3> const perm{2, 1, 0};
+  auto const out_extents = permuted_extents(extents, perm);
+  std::vector<double> a(70 * 6 * 90);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::vector<double> b(a.size(), 1.0);
+  auto const old = b;
+
+  oneapi::tbb::task_arena arena(4);
+  auto src = make_view(a, extents, row_major(extents));
+  auto dst = make_view(b, out_extents, row_major(out_extents));
+  permute(par.on(arena).with_min_size(1), 0.5, src, perm, 2.0, dst);
+  expect_permuted(src, dst, perm, 0.5, &old, 2.0);
+}
+
+TEST(PermuteDeathTest, InvalidPermutation)
+{
+  std::vector<double> a(6), b(6);
+  auto src = make_mdspan_2d(a, 2, 3);
+  EXPECT_DEATH(permute(src, std::array<std::size_t, 2>{1, 1}, make_mdspan_2d(b, 3, 2)), "not a permutation");
+  EXPECT_DEATH(permute(src, std::array<std::size_t, 2>{0, 1}, make_mdspan_2d(b, 3, 2)), "shape mismatch");
+}
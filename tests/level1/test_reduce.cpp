@@ -0,0 +1,151 @@
+#include "../helpers.hpp"
+#include <uni20/level1/reduce.hpp>
+#include "gtest/gtest.h"
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <oneapi/tbb/task_arena.h>
+#include <random>
+
+using namespace uni20;
+
+TEST(Reduce, StridedSumMatchesNaive)
+{
+  // every other column of a 7×10 block, walked through a negative row stride
+  std::vector<double> v(7 * 10);
+  std::iota(v.begin(), v.end(), 1.0);
+  auto m = make_mdspan_2d(v, 7, 5, {-10, 2});
+  auto view = stdex::mdspan(v.data() + 60, m.mapping());
+
+  double expected = 0;
+  for (std::size_t r = 0; r < 7; ++r)
+    for (std::size_t c = 0; c < 10; c += 2)
+      expected += v[r * 10 + c];
+
+  EXPECT_EQ(reduce(view), expected);
+  EXPECT_EQ(reduce(view, 0.0, [](double x, double y) { return x < y ? y : x; }), 70.0 - 1);
+}
+
+TEST(Reduce, PairwiseSummationIsAccurate)
+{
+  // 2²⁰ copies of 0.1f: a running float sum drifts by about 1%, a pairwise sum stays within a few ulps
+  std::vector<float> v(std::size_t(1) << 20, 0.1f);
+  stdex::mdspan<float, stdex::dextents<index_t, 1>> m(v.data(), v.size());
+
+  float naive = 0;
+  for (float x : v)
+    naive += x;
+  double const exact = double(0.1f) * double(v.size());
+
+  EXPECT_GT(std::abs(naive - exact) / exact, 1e-3);
+  EXPECT_LT(std::abs(reduce(m) - exact) / exact, 1e-6);
+}
+
+TEST(Reduce, DotAndVdotComplex)
+{
+  using C = std::complex<double>;
+  std::vector<C> a{{1, 2}, {3, -1}, {0, 4}};
+  std::vector<C> b{{2, 0}, {1, 1}, {-1, 3}};
+  stdex::mdspan<C, stdex::dextents<index_t, 1>> A(a.data(), 3);
+  stdex::mdspan<C, stdex::dextents<index_t, 1>> B(b.data(), 3);
+
+  C d{}, vd{};
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    d += a[i] * b[i];
+    vd += std::conj(a[i]) * b[i];
+  }
+  EXPECT_EQ(dot(A, B), d);
+  EXPECT_EQ(vdot(A, B), vd);
+  EXPECT_EQ(vdot(A, A), C(std::norm(a[0]) + std::norm(a[1]) + std::norm(a[2])));
+}
+
+TEST(Reduce, DotMixesLayouts)
+{
+  // row-major layout_right operand against a transposed layout_stride operand
+  std::size_t const R = 13, Cols = 9;
+  std::vector<double> a(R * Cols), b(R * Cols);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::iota(b.begin(), b.end(), 0.5);
+  stdex::mdspan<double, stdex::dextents<index_t, 2>> A(a.data(), R, Cols);
+  auto B = make_mdspan_2d(b, R, Cols, {1, index_t(R)});
+
+  double expected = 0;
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t j = 0; j < Cols; ++j)
+      expected += a[i * Cols + j] * b[j * R + i];
+  EXPECT_EQ(dot(A, B), expected);
+}
+
+TEST(Reduce, Norms)
+{
+  std::vector<double> v{3, -12, 4, 0, -1, 2};
+  auto m = make_mdspan_2d(v, 2, 2, {3, 2}); // {3, 4, 0, 2}
+  EXPECT_DOUBLE_EQ(norm2(m), std::sqrt(9.0 + 16 + 0 + 4));
+  EXPECT_EQ(norm_inf(m), 4.0);
+  EXPECT_EQ(norm_inf(make_mdspan_1d(v)), 12.0);
+
+  std::vector<std::complex<float>> z{{3, 4}, {0, -1}};
+  stdex::mdspan<std::complex<float>, stdex::dextents<index_t, 1>> Z(z.data(), 2);
+  EXPECT_FLOAT_EQ(norm2(Z), std::sqrt(26.0f));
+  EXPECT_FLOAT_EQ(norm_inf(Z), 5.0f);
+}
+
+TEST(Reduce, Norm2AvoidsOverflowAndUnderflow)
+{
+  std::vector<double> big{3e160, -4e160}, tiny{3e-170, 4e-170};
+  EXPECT_DOUBLE_EQ(norm2(make_mdspan_1d(big)), 5e160);
+  EXPECT_DOUBLE_EQ(norm2(make_mdspan_1d(tiny)), 5e-170);
+
+  // many leaves, with magnitudes spanning the whole range and the largest in the last leaf
+  std::vector<double> mixed(4000, 1e-200);
+  mixed.back() = 1e200;
+  mixed[1000] = 1.0;
+  EXPECT_DOUBLE_EQ(norm2(make_mdspan_1d(mixed)), 1e200);
+  EXPECT_DOUBLE_EQ(norm2(par.with_min_size(500), make_mdspan_1d(mixed)), 1e200);
+
+  std::vector<std::complex<double>> z{{3e200, 4e200}, {0, 0}};
+  stdex::mdspan<std::complex<double>, stdex::dextents<index_t, 1>> Z(z.data(), 2);
+  EXPECT_DOUBLE_EQ(norm2(Z), 5e200);
+
+  std::vector<double> inf{1.0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+  EXPECT_EQ(norm2(make_mdspan_1d(inf)), std::numeric_limits<double>::infinity());
+}
+
+TEST(Reduce, EmptyAndRankZero)
+{
+  std::vector<double> v{2.5};
+  stdex::mdspan<double, stdex::dextents<index_t, 2>> empty(v.data(), 3, 0);
+  EXPECT_EQ(reduce(empty), 0.0);
+  EXPECT_EQ(norm_inf(empty), 0.0);
+
+  stdex::mdspan<double, stdex::dextents<index_t, 0>> scalar(v.data());
+  EXPECT_EQ(reduce(scalar), 2.5);
+  EXPECT_EQ(norm2(scalar), 2.5);
+}
+
+TEST(Reduce, ParallelIsBitwiseDeterministic)
+{
+  std::size_t const R = 300, Cols = 701;
+  std::vector<double> a(R * Cols), b(R * Cols);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (auto& x : a)
+    x = dist(rng);
+  for (auto& x : b)
+    x = dist(rng);
+  auto A = make_mdspan_2d(a, R, Cols);
+  auto B = make_mdspan_2d(b, R, Cols, {1, index_t(R)});
+
+  double const serial = dot(A, B);
+  double const norm = norm2(A);
+  for (int threads : {2, 3, 4})
+  {
+    oneapi::tbb::task_arena arena(threads);
+    auto policy = par.on(arena).with_min_size(1000);
+    EXPECT_EQ(dot(policy, A, B), serial) << threads << " threads";
+    EXPECT_EQ(norm2(policy, A), norm) << threads << " threads";
+  }
+  EXPECT_EQ(dot(par, A, B), serial);
+}
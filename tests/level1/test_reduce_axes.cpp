@@ -0,0 +1,174 @@
+#include "../helpers.hpp"
+#include <uni20/level1/reduce_axes.hpp>
+#include "gtest/gtest.h"
+#include <numeric>
+#include <oneapi/tbb/task_arena.h>
+
+using namespace uni20;
+
+TEST(ReductionPlan, SeparatesKeptAndReducedDims)
+{
+  // a[i,j,k] row-major 4×5×6 summed over j into a row-major out[i,k]
+  auto a = make_mapping(std::array<std::size_t, 3>{4, 5, 6}, std::array<index_t, 3>{30, 6, 1});
+  auto out = make_mapping(std::array<std::size_t, 2>{4, 6}, std::array<index_t, 2>{6, 1});
+  auto plan = make_reduction_plan_with_offset(out, a, std::array<std::ptrdiff_t, 3>{0, -1, 1});
+
+  ASSERT_EQ(plan.kept.size(), 2);
+  EXPECT_EQ(plan.kept[0].extent, 4);
+  EXPECT_EQ(plan.kept[0].strides[0], 6);
+  EXPECT_EQ(plan.kept[0].strides[1], 30);
+  EXPECT_EQ(plan.kept[1].extent, 6);
+  EXPECT_EQ(plan.kept[1].strides[1], 1);
+  ASSERT_EQ(plan.reduced.size(), 1);
+  EXPECT_EQ(plan.reduced[0].extent, 5);
+  EXPECT_EQ(plan.reduced[0].strides[0], 6);
+}
+
+TEST(ReductionPlan, TracedDimsShareOneDiagonal)
+{
+  auto a = make_mapping(std::array<std::size_t, 3>{3, 2, 3}, std::array<index_t, 3>{6, 3, 1});
+  auto out = make_mapping(std::array<std::size_t, 1>{2}, std::array<index_t, 1>{1});
+  auto plan = make_reduction_plan_with_offset(out, a, std::array<std::ptrdiff_t, 3>{-1, 0, -1});
+
+  ASSERT_EQ(plan.reduced.size(), 1);
+  EXPECT_EQ(plan.reduced[0].extent, 3);
+  EXPECT_EQ(plan.reduced[0].strides[0], 7);
+}
+
+TEST(ReduceAxes, SumInnermostAxis)
+{
+  std::vector<double> v(3 * 4 * 5);
+  std::iota(v.begin(), v.end(), 0.0);
+  std::vector<double> out(3 * 4, -1);
+  auto a = make_mdspan_3d(v, 3, 4, 5);
+
+  reduce_axes(a, std::array<std::size_t, 1>{2}, make_mdspan_2d(out, 3, 4));
+
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      double expected = 0;
+      for (std::size_t k = 0; k < 5; ++k)
+        expected += v[i * 20 + j * 5 + k];
+      EXPECT_EQ(out[i * 4 + j], expected);
+    }
+}
+
+TEST(ReduceAxes, SumOutermostAxisStreams)
+{
+  // the unit-stride dimension is kept, so the output is built up one input row at a time
+  std::vector<double> v(6 * 7);
+  std::iota(v.begin(), v.end(), 1.0);
+  std::vector<double> out(7, -1);
+
+  reduce_axes(make_mdspan_2d(v, 6, 7), std::array<std::size_t, 1>{0}, make_mdspan_1d(out));
+
+  for (std::size_t j = 0; j < 7; ++j)
+  {
+    double expected = 0;
+    for (std::size_t i = 0; i < 6; ++i)
+      expected += v[i * 7 + j];
+    EXPECT_EQ(out[j], expected);
+  }
+}
+
+TEST(ReduceAxes, TwoAxesIntoColumnMajorOutput)
+{
+  // a[i,j,k,l] with extents 3×4×5×2 stored with permuted strides; sum over j and l into out[i,k] column-major
+  std::vector<double> v(3 * 4 * 5 * 2);
+  std::iota(v.begin(), v.end(), 0.0);
+  std::array<index_t, 4> const st{2, 30, 6, 1};
+  auto a = make_mdspan_strided<4>(v, {3, 4, 5, 2}, st);
+  std::vector<double> out(3 * 5, -1);
+
+  reduce_axes(a, std::array<std::size_t, 2>{3, 1}, make_mdspan_2d(out, 3, 5, {1, 3}));
+
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t k = 0; k < 5; ++k)
+    {
+      double expected = 0;
+      for (std::size_t j = 0; j < 4; ++j)
+        for (std::size_t l = 0; l < 2; ++l)
+          expected += v[i * st[0] + j * st[1] + k * st[2] + l * st[3]];
+      EXPECT_EQ(out[i + 3 * k], expected);
+    }
+}
+
+TEST(ReduceAxes, EmptyReducedAxisZeroesOutput)
+{
+  std::vector<double> v(1);
+  std::vector<double> out(4, -1);
+  auto a = make_mdspan_strided<2>(v, {4, 0}, {1, 4});
+
+  reduce_axes(a, std::array<std::size_t, 1>{1}, make_mdspan_1d(out));
+  EXPECT_EQ(out, std::vector<double>(4, 0));
+}
+
+TEST(PartialTrace, SinglePair)
+{
+  // out[j,k] = Σ_i a[i,j,k,i] for a 3×2×4×3 row-major tensor
+  std::vector<double> v(3 * 2 * 4 * 3);
+  std::iota(v.begin(), v.end(), 0.0);
+  auto a = make_mdspan_strided<4>(v, {3, 2, 4, 3}, {24, 12, 3, 1});
+  std::vector<double> out(2 * 4, -1);
+
+  partial_trace(a, 0, 3, make_mdspan_2d(out, 2, 4));
+
+  for (std::size_t j = 0; j < 2; ++j)
+    for (std::size_t k = 0; k < 4; ++k)
+    {
+      double expected = 0;
+      for (std::size_t i = 0; i < 3; ++i)
+        expected += v[i * 24 + j * 12 + k * 3 + i];
+      EXPECT_EQ(out[j * 4 + k], expected);
+    }
+}
+
+TEST(PartialTrace, TwoPairsToScalar)
+{
+  // full trace of a 3×2×3×2 tensor over the pairs (0,2) and (1,3)
+  std::vector<double> v(36);
+  std::iota(v.begin(), v.end(), 0.0);
+  auto a = make_mdspan_strided<4>(v, {3, 2, 3, 2}, {12, 6, 2, 1});
+  double result = -1;
+  stdex::mdspan<double, stdex::dextents<index_t, 0>, stdex::layout_stride> out(
+      &result, stdex::layout_stride::mapping<stdex::dextents<index_t, 0>>());
+
+  partial_trace(a, std::array{std::array<std::size_t, 2>{0, 2}, std::array<std::size_t, 2>{1, 3}}, out);
+
+  double expected = 0;
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = 0; j < 2; ++j)
+      expected += v[i * 12 + j * 6 + i * 2 + j];
+  EXPECT_EQ(result, expected);
+}
+
+TEST(ReduceAxes, ParallelMatchesSerial)
+{
+  std::size_t const I = 40, J = 30, K = 50;
+  std::vector<double> v(I * J * K);
+  std::iota(v.begin(), v.end(), 0.25);
+  auto a = make_mdspan_3d(v, I, J, K);
+  oneapi::tbb::task_arena arena(4);
+  auto policy = par.on(arena).with_min_size(0);
+
+  // register path over the innermost axis, then the streaming path over the outermost axis
+  for (std::size_t axis : {std::size_t(2), std::size_t(0)})
+  {
+    std::size_t const n = axis == 2 ? I * J : J * K;
+    std::vector<double> serial(n), parallel(n);
+    auto make_out = [&](std::vector<double>& o) {
+      return axis == 2 ? make_mdspan_2d(o, I, J) : make_mdspan_2d(o, J, K);
+    };
+    reduce_axes(a, std::array{axis}, make_out(serial));
+    reduce_axes(policy, a, std::array{axis}, make_out(parallel));
+    EXPECT_EQ(parallel, serial) << "axis " << axis;
+  }
+}
+
+TEST(ReduceAxesDeathTest, RepeatedAxis)
+{
+  std::vector<double> v(12), out(1);
+  auto a = make_mdspan_3d(v, 2, 2, 3);
+  EXPECT_DEATH(reduce_axes(a, std::array<std::size_t, 2>{1, 1}, make_mdspan_1d(out)), "repeated axis");
+}
@@ -1,7 +1,10 @@
 #include "../helpers.hpp"
+#include <uni20/level1/assign.hpp>
 #include <uni20/level1/sum.hpp>
+#include <uni20/mdspan/broadcast.hpp>
 #include "gtest/gtest.h"
 #include <numeric>
+#include <oneapi/tbb/task_arena.h>
 
 using namespace uni20;
 
@@ -143,3 +146,35 @@ TEST(SumViewNested, CombinedAndNested)
     EXPECT_DOUBLE_EQ(S[i], exp);
   }
 }
+
+TEST(SumViewParallel, MaterialiseMatchesSerial)
+{
+  std::size_t const R = 256, C = 200;
+  std::vector<double> a(R * C), b(R * C), expected(R * C), out(R * C);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::iota(b.begin(), b.end(), 0.5);
+
+  auto S = sum_view(make_mdspan_2d(a, R, C), make_mdspan_2d(b, R, C, {1, std::ptrdiff_t(R)}));
+  assign(seq, S, make_mdspan_2d(expected, R, C));
+
+  oneapi::tbb::task_arena arena(4);
+  assign(par.on(arena), S, make_mdspan_2d(out, R, C));
+  EXPECT_EQ(out, expected);
+}
+
+TEST(SumViewBroadcast, AddRowToEveryRow)
+{
+  std::size_t R = 37, C = 45;
+  std::vector<double> a(R * C), row(C), out(R * C);
+  std::iota(a.begin(), a.end(), 0.0);
+  std::iota(row.begin(), row.end(), 1000.0);
+  auto A = make_mdspan_2d(a, R, C);
+  auto Row = make_mdspan_2d(row, 1, C);
+  auto Out = make_mdspan_2d(out, R, C);
+
+  oneapi::tbb::task_arena arena(4);
+  assign(par.on(arena).with_min_size(1), sum_view(A, broadcast_to(Row, A.extents())), Out);
+  for (std::size_t i = 0; i < R; ++i)
+    for (std::size_t j = 0; j < C; ++j)
+      EXPECT_EQ(out[i * C + j], a[i * C + j] + row[j]);
+}
@@ -1,13 +1,25 @@
 #include <uni20/linalg/linalg.hpp>
+#include <uni20/storage/mmapstorage.hpp>
 #include <uni20/tensor/basic_tensor.hpp>
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
 namespace
 {
 using index_t = uni20::index_type;
 using extents_2d = stdex::dextents<index_t, 2>;
 using tensor_type = uni20::BasicTensor<double, extents_2d, uni20::VectorStorage>;
+using shared_tensor = uni20::BasicTensor<double, extents_2d, uni20::SharedStorage>;
+using shared_view = uni20::TensorView<double, uni20::mutable_tensor_traits<extents_2d, uni20::SharedStorage>>;
+using mmap_tensor = uni20::BasicTensor<double, extents_2d, uni20::MmapStorage>;
+using mmap_view = uni20::TensorView<double, uni20::mutable_tensor_traits<extents_2d, uni20::MmapStorage>>;
 } // namespace
 
 TEST(CpuOpsTest, FillIdentity)
@@ -27,6 +39,49 @@ TEST(CpuOpsTest, FillIdentity)
   }
 }
 
+TEST(CpuOpsTest, FillIdentityOnSharedCopyDetaches)
+{
+  // a copy-on-write tensor only reaches a mutable view through view(), which detaches it first
+  static_assert(!std::is_convertible_v<shared_tensor&, shared_view&>);
+  static_assert(!std::is_convertible_v<shared_tensor&, shared_view>);
+
+  shared_tensor a(extents_2d{3, 3});
+  shared_tensor b = a;
+  EXPECT_EQ(std::as_const(a).storage().use_count(), 2u);
+
+  uni20::linalg::fill_identity(b.view());
+
+  EXPECT_EQ(std::as_const(a).storage().use_count(), 1u);
+  EXPECT_NE(std::as_const(a).handle(), std::as_const(b).handle());
+  for (index_t i = 0; i < 3; ++i)
+  {
+    for (index_t j = 0; j < 3; ++j)
+    {
+      EXPECT_DOUBLE_EQ((std::as_const(a)[i, j]), 0.0);
+      EXPECT_DOUBLE_EQ((std::as_const(b)[i, j]), (i == j) ? 1.0 : 0.0);
+    }
+  }
+}
+
+TEST(CpuOpsTest, CopyIntoReadOnlyMappingIsPreconditionFailure)
+{
+  // a mapped tensor only reaches a mutable view through view(), which checks that the mapping is writable
+  static_assert(!std::is_convertible_v<mmap_tensor&, mmap_view&>);
+  static_assert(!std::is_convertible_v<mmap_tensor&, mmap_view>);
+
+  auto const path =
+      std::filesystem::temp_directory_path() / ("uni20_linalg_mmap_" + std::to_string(::getpid()) + ".bin");
+  {
+    mmap_tensor created(uni20::mmap_buffer<double>::create(path, 4), extents_2d{2, 2});
+  }
+
+  tensor_type x(extents_2d{2, 2});
+  mmap_tensor t(uni20::mmap_buffer<double>::open(path), extents_2d{2, 2});
+  EXPECT_DEATH(uni20::linalg::copy(x.const_view(), t.view()), "read-only mapping");
+  EXPECT_DOUBLE_EQ((std::as_const(t)[0, 0]), 0.0);
+  std::filesystem::remove(path);
+}
+
 TEST(CpuOpsTest, Multiply)
 {
   extents_2d lhs_exts{2, 3};
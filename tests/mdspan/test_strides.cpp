@@ -239,3 +239,44 @@ TEST(ExtractStrides, ContractsAndMergesGroups)
   EXPECT_EQ(Kgroup[0].strides[0], 1);
   EXPECT_EQ(Kgroup[0].strides[1], 30);
 }
+
+TEST(ExtractStrides, BatchedGroups)
+{
+  using AExtents = stdex::extents<std::size_t, 3, 2, 4>; // (b, i, k)
+  using BExtents = stdex::extents<std::size_t, 4, 3, 5>; // (k, b, j)
+  using CExtents = stdex::extents<std::size_t, 3, 2, 5>; // (b, i, j)
+
+  std::array<double, 3 * 2 * 4> Adata{};
+  std::array<double, 4 * 3 * 5> Bdata{};
+  std::array<double, 3 * 2 * 5> Cdata{};
+
+  stdex::mdspan<double, AExtents> A(Adata.data());
+  stdex::mdspan<double, BExtents> B(Bdata.data());
+  stdex::mdspan<double, CExtents> C(Cdata.data());
+
+  std::array<std::pair<std::size_t, std::size_t>, 1> contract{{{2, 0}}};
+  std::array<std::pair<std::size_t, std::size_t>, 1> batch{{{0, 1}}};
+
+  auto [Bgroup, Mgroup, Ngroup, Kgroup] = extract_strides_batched(A, B, contract, batch, C);
+
+  ASSERT_EQ(Bgroup.size(), 1);
+  EXPECT_EQ(Bgroup[0].extent, 3);
+  EXPECT_EQ(Bgroup[0].strides[0], 8);
+  EXPECT_EQ(Bgroup[0].strides[1], 5);
+  EXPECT_EQ(Bgroup[0].strides[2], 10);
+
+  ASSERT_EQ(Mgroup.size(), 1);
+  EXPECT_EQ(Mgroup[0].extent, 2);
+  EXPECT_EQ(Mgroup[0].strides[0], 4);
+  EXPECT_EQ(Mgroup[0].strides[1], 5);
+
+  ASSERT_EQ(Ngroup.size(), 1);
+  EXPECT_EQ(Ngroup[0].extent, 5);
+  EXPECT_EQ(Ngroup[0].strides[0], 1);
+  EXPECT_EQ(Ngroup[0].strides[1], 1);
+
+  ASSERT_EQ(Kgroup.size(), 1);
+  EXPECT_EQ(Kgroup[0].extent, 4);
+  EXPECT_EQ(Kgroup[0].strides[0], 1);
+  EXPECT_EQ(Kgroup[0].strides[1], 15);
+}
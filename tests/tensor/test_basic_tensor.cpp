@@ -3,8 +3,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <concepts>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -176,4 +181,162 @@ TEST(BasicTensorTest, ViewsShareStorageAndRespectConstness)
   EXPECT_EQ(const_view_from_const.handle(), static_cast<int const*>(tensor.handle()));
 }
 
+TEST(BasicTensorTest, UninitializedTagSkipsInitialisation)
+{
+  using buffer_tensor = BasicTensor<double, extents_2d, UninitializedStorage>;
+  static_assert(std::is_same_v<buffer_tensor::storage_type, heap_buffer<double>>);
+
+  buffer_tensor zeroed(extents_2d{3, 5});
+  for (double x : zeroed.storage())
+    EXPECT_EQ(x, 0.0);
+
+  buffer_tensor out(uninitialized, extents_2d{3, 5});
+  EXPECT_EQ(out.storage().size(), 15u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(out.storage().data()) % 64, 0u);
+  EXPECT_EQ(out.handle(), out.storage().data());
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 5; ++j)
+      out[i, j] = double(10 * i + j);
+  EXPECT_EQ((out[2, 4]), 24.0);
+  EXPECT_EQ(out.storage()[14], 24.0);
+
+  buffer_tensor strided(uninitialized, extents_2d{2, 3}, std::array<index_t, 2>{1, 4});
+  EXPECT_EQ(strided.storage().size(), 10u);
+
+  // storage policies that cannot skip the initialisation ignore the tag
+  tensor_type vec(uninitialized, extents_2d{2, 2});
+  for (int x : vec.storage())
+    EXPECT_EQ(x, 0);
+}
+
+TEST(BasicTensorTest, HeapBufferCopiesAreDeep)
+{
+  heap_buffer<int> a(4);
+  a[2] = 7;
+  heap_buffer<int> b = a;
+  b[2] = 8;
+  EXPECT_EQ(a[2], 7);
+  EXPECT_NE(a.data(), b.data());
+
+  heap_buffer<int> c = std::move(b);
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(c[2], 8);
+  a = c;
+  EXPECT_EQ(a[2], 8);
+  EXPECT_EQ(heap_buffer<int>(0).data(), nullptr);
+}
+
+TEST(BasicTensorTest, AlignedStorageAlignsFirstElement)
+{
+  using aligned_tensor = BasicTensor<double, extents_2d, AlignedStorage<128>>;
+  static_assert(aligned_tensor::alignment == 128);
+  static_assert(BasicTensor<double, extents_2d, AlignedStorage<>>::alignment == 64);
+  static_assert(std::is_same_v<UninitializedStorage, AlignedStorage<>>);
+  static_assert(tensor_type::alignment == alignof(int));
+  static_assert(storage_alignment_v<AlignedStorage<8>, long double> == alignof(long double));
+
+  for (index_t n : {1, 3, 40})
+  {
+    aligned_tensor t(extents_2d{n, 7});
+    // a buffer smaller than the alignment is aligned to the largest power of two that fits in it
+    auto const expected = std::bit_floor(std::min<std::size_t>(128, sizeof(double) * 7 * std::size_t(n)));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(t.storage().data()) % expected, 0u);
+    EXPECT_EQ(t.handle(), t.storage().data());
+    EXPECT_EQ((t[n - 1, 6]), 0.0);
+  }
+
+  aligned_tensor u(uninitialized, extents_2d{50, 50});
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(u.storage().data()) % 128, 0u);
+  u[49, 49] = 1.5;
+  EXPECT_EQ(u.storage()[2499], 1.5);
+}
+
+TEST(BasicTensorTest, CopiesOwnTheirElements)
+{
+  tensor_type a(extents_2d{2, 3});
+  a[1, 2] = 5;
+  tensor_type b = a;
+  EXPECT_EQ(b.handle(), b.storage().data());
+  EXPECT_NE(b.handle(), a.handle());
+  b[1, 2] = 6;
+  EXPECT_EQ((a[1, 2]), 5);
+
+  tensor_type c(extents_2d{1, 1});
+  c = b;
+  EXPECT_EQ(c.handle(), c.storage().data());
+  EXPECT_EQ((c[1, 2]), 6);
+
+  tensor_type d = std::move(c);
+  EXPECT_EQ(d.handle(), d.storage().data());
+  EXPECT_EQ((d[1, 2]), 6);
+}
+
+TEST(BasicTensorTest, SharedStorageCopiesShareUntilWritten)
+{
+  using shared_tensor = BasicTensor<double, extents_2d, SharedStorage>;
+  shared_tensor a(extents_2d{3, 4});
+  a[2, 3] = 1.0;
+  double const* original = std::as_const(a).handle();
+
+  shared_tensor b = a;
+  EXPECT_EQ(std::as_const(b).handle(), original);
+  EXPECT_EQ(std::as_const(a).storage().use_count(), 2u);
+  EXPECT_EQ((std::as_const(b)[2, 3]), 1.0);
+
+  // the first mutable access gives b its own copy of the elements
+  b[2, 3] = 2.0;
+  EXPECT_NE(std::as_const(b).handle(), original);
+  EXPECT_EQ(std::as_const(b).handle(), std::as_const(b).storage().data());
+  EXPECT_EQ(std::as_const(a).handle(), original);
+  EXPECT_EQ((std::as_const(a)[2, 3]), 1.0);
+  EXPECT_EQ((std::as_const(b)[2, 3]), 2.0);
+  EXPECT_EQ(std::as_const(a).storage().use_count(), 1u);
+
+  // a tensor that is not shared is written in place
+  a.mutable_mdspan()[0, 0] = 3.0;
+  EXPECT_EQ(std::as_const(a).handle(), original);
+
+  shared_tensor c = a;
+  auto m = c.mutable_mdspan();
+  m[0, 0] = 4.0;
+  EXPECT_EQ((std::as_const(a)[0, 0]), 3.0);
+  EXPECT_EQ(m.data_handle(), std::as_const(c).handle());
+}
+
+TEST(BasicTensorTest, SharedViewKeepsElementsAlive)
+{
+  using shared_tensor = BasicTensor<int, extents_2d, SharedStorage>;
+  auto t = std::make_unique<shared_tensor>(extents_2d{2, 2});
+  (*t)[1, 1] = 7;
+  auto v = std::as_const(*t).shared_view();
+  static_assert(std::is_const_v<decltype(v)::element_type>);
+
+  (*t)[1, 1] = 8;
+  EXPECT_EQ((v[1, 1]), 7);
+  EXPECT_EQ(((*t)[1, 1]), 8);
+
+  t.reset();
+  EXPECT_EQ((v[1, 1]), 7);
+  EXPECT_EQ(v.storage().use_count(), 1u);
+}
+
+TEST(BasicTensorTest, SharedTensorPassesToThreadByValue)
+{
+  using shared_tensor = BasicTensor<double, extents_2d, SharedStorage>;
+  shared_tensor t(extents_2d{64, 64});
+  for (index_t i = 0; i < 64; ++i)
+    t[i, i] = 1.0;
+
+  double const* seen = nullptr;
+  double trace = 0.0;
+  std::thread([copy = t, &seen, &trace] {
+    seen = copy.handle();
+    for (index_t i = 0; i < 64; ++i)
+      trace += (copy[i, i]);
+  }).join();
+  EXPECT_EQ(seen, std::as_const(t).handle());
+  EXPECT_EQ(trace, 64.0);
+  EXPECT_EQ(std::as_const(t).storage().use_count(), 1u);
+}
+
 } // namespace
@@ -0,0 +1,219 @@
+#include <uni20/storage/buffer_pool.hpp>
+#include <uni20/storage/workspace_arena.hpp>
+#include <uni20/tensor/basic_tensor.hpp>
+#include <uni20/tensor/expression.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+using namespace uni20;
+
+namespace
+{
+
+using extents_2d = stdex::dextents<index_type, 2>;
+using pooled_tensor = BasicTensor<double, extents_2d, PooledStorage>;
+
+bool is_aligned(void const* p, std::size_t align) { return reinterpret_cast<std::uintptr_t>(p) % align == 0; }
+
+/// Restores the default limits and empties the pool around each test.
+class BufferPoolTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+      pool.set_limits(buffer_pool_limits{});
+      pool.trim();
+      pool.reset_statistics();
+    }
+
+    void TearDown() override
+    {
+      pool.set_limits(buffer_pool_limits{});
+      pool.trim();
+    }
+
+    BufferPool& pool = BufferPool::global();
+};
+
+} // namespace
+
+TEST(BufferPoolSizeClass, FourClassesPerPowerOfTwo)
+{
+  EXPECT_EQ(BufferPool::size_class(1), 0u);
+  EXPECT_EQ(BufferPool::class_bytes(0), 64u);
+  EXPECT_EQ(BufferPool::class_bytes(BufferPool::size_class(65)), 80u);
+  EXPECT_EQ(BufferPool::class_bytes(BufferPool::size_class(128)), 128u);
+  EXPECT_EQ(BufferPool::class_bytes(BufferPool::size_class(129)), 160u);
+  EXPECT_EQ(BufferPool::class_bytes(BufferPool::size_class(1000)), 1024u);
+  EXPECT_EQ(BufferPool::class_bytes(BufferPool::size_class(1025)), 1280u);
+
+  for (std::size_t bytes = 1; bytes < 100000; bytes += 37)
+  {
+    std::size_t const block = BufferPool::class_bytes(BufferPool::size_class(bytes));
+    EXPECT_GE(block, bytes);
+    EXPECT_LE(block, bytes + bytes / 4 + BufferPool::min_block_bytes);
+  }
+}
+
+TEST_F(BufferPoolTest, ReleasedBlockIsReusedFromThreadCache)
+{
+  void* p = pool.allocate(1000);
+  EXPECT_TRUE(is_aligned(p, BufferPool::alignment));
+  EXPECT_EQ(pool.statistics().misses, 1u);
+
+  pool.deallocate(p, 1000);
+  EXPECT_EQ(pool.statistics().bytes_retained, 1024u);
+
+  // Any request in the same size class gets the same block back.
+  void* q = pool.allocate(1010);
+  EXPECT_EQ(q, p);
+  EXPECT_EQ(pool.statistics().hits, 1u);
+  EXPECT_EQ(pool.statistics().bytes_retained, 0u);
+  pool.deallocate(q, 1010);
+}
+
+TEST_F(BufferPoolTest, ZeroLimitsRetainNothing)
+{
+  pool.set_limits({0, 0, buffer_pool_limits{}.max_block_bytes});
+  void* p = pool.allocate(256);
+  pool.deallocate(p, 256);
+  EXPECT_EQ(pool.statistics().bytes_retained, 0u);
+
+  void* q = pool.allocate(256);
+  EXPECT_EQ(pool.statistics().hits, 0u);
+  EXPECT_EQ(pool.statistics().misses, 2u);
+  pool.deallocate(q, 256);
+}
+
+TEST_F(BufferPoolTest, BlocksAboveMaxBlockBytesAreNotPooled)
+{
+  pool.set_limits({buffer_pool_limits{}.max_thread_bytes, buffer_pool_limits{}.max_shared_bytes, 4096});
+  void* p = pool.allocate(8192);
+  pool.deallocate(p, 8192);
+  EXPECT_EQ(pool.statistics().bytes_retained, 0u);
+}
+
+TEST_F(BufferPoolTest, BlocksOfExitedThreadGoToSharedPool)
+{
+  void* p = nullptr;
+  std::thread([&] {
+    p = pool.allocate(4096);
+    pool.deallocate(p, 4096);
+  }).join();
+  EXPECT_EQ(pool.statistics().bytes_retained, 4096u);
+
+  void* q = pool.allocate(4096);
+  EXPECT_EQ(q, p);
+  EXPECT_EQ(pool.statistics().hits, 1u);
+  pool.deallocate(q, 4096);
+}
+
+TEST_F(BufferPoolTest, PooledTensorReusesBuffer)
+{
+  double const* first = nullptr;
+  {
+    pooled_tensor t(extents_2d{16, 16});
+    EXPECT_EQ((t[3, 4]), 0.0);
+    EXPECT_TRUE(is_aligned(t.storage().data(), PooledStorage::alignment));
+    first = t.storage().data();
+  }
+  pooled_tensor t(uninitialized, extents_2d{16, 16});
+  EXPECT_EQ(t.storage().data(), first);
+  EXPECT_EQ(pool.statistics().hits, 1u);
+}
+
+TEST_F(BufferPoolTest, ContractionIntoRecycledUninitializedTensor)
+{
+  // small sizes take the recursive loop and larger ones the blocked engine; both must ignore the old contents
+  for (index_type n : {4, 24})
+  {
+    pooled_tensor A(extents_2d{n, n}), B(extents_2d{n, n});
+    for (index_type i = 0; i < n; ++i)
+      for (index_type j = 0; j < n; ++j)
+      {
+        A[i, j] = double(i + 2 * j) / n;
+        B[i, j] = double(i - j) / n;
+      }
+
+    double const* recycled = nullptr;
+    {
+      pooled_tensor junk(extents_2d{n, n});
+      for (double& x : junk.storage())
+        x = std::numeric_limits<double>::quiet_NaN();
+      recycled = junk.storage().data();
+    }
+    pooled_tensor C(uninitialized, extents_2d{n, n});
+    ASSERT_EQ(C.storage().data(), recycled);
+    ASSERT_TRUE(std::isnan((C[0, 0])));
+
+    assign(contract(A, B, {{1, 0}}), C);
+    for (index_type i = 0; i < n; ++i)
+      for (index_type j = 0; j < n; ++j)
+      {
+        double expected = 0;
+        for (index_type k = 0; k < n; ++k)
+          expected += A[i, k] * B[k, j];
+        EXPECT_NEAR((C[i, j]), expected, 1e-12) << n;
+      }
+  }
+}
+
+TEST_F(BufferPoolTest, ArenaBumpsWithinChunk)
+{
+  {
+    WorkspaceArena arena(4096);
+    auto* a = arena.allocate<double>(3);
+    auto* b = arena.allocate<double>(5);
+    EXPECT_TRUE(is_aligned(a, BufferPool::alignment));
+    EXPECT_TRUE(is_aligned(b, BufferPool::alignment));
+    EXPECT_EQ(reinterpret_cast<std::byte*>(b) - reinterpret_cast<std::byte*>(a), 64);
+    EXPECT_EQ(arena.bytes_used(), 64u + 5 * sizeof(double));
+    EXPECT_EQ(arena.capacity(), 4096u);
+    EXPECT_EQ(pool.statistics().misses, 1u);
+
+    void* c = arena.allocate(3, 1);
+    EXPECT_EQ(static_cast<std::byte*>(c), reinterpret_cast<std::byte*>(b + 5));
+  }
+  EXPECT_EQ(pool.statistics().bytes_retained, 4096u);
+}
+
+TEST_F(BufferPoolTest, ArenaOverflowTakesNewChunkAndResetReturnsThem)
+{
+  WorkspaceArena arena(1024);
+  (void)arena.allocate(1000);
+  (void)arena.allocate(100);
+  EXPECT_EQ(arena.capacity(), 2048u);
+
+  // A request larger than a chunk gets a chunk of its own size.
+  (void)arena.allocate(10000);
+  EXPECT_EQ(arena.capacity(), 2048u + 10000u);
+
+  arena.reset();
+  EXPECT_EQ(arena.capacity(), 0u);
+  EXPECT_EQ(arena.bytes_used(), 0u);
+  EXPECT_GT(pool.statistics().bytes_retained, 2048u + 10000u);
+
+  // The next chunk comes back from the pool.
+  (void)arena.allocate(10);
+  EXPECT_EQ(pool.statistics().hits, 1u);
+}
+
+TEST_F(BufferPoolTest, ArenaViewIsRowMajor)
+{
+  WorkspaceArena arena;
+  auto v = arena.make_view<int>(std::array<index_type, 2>{3, 4});
+  static_assert(!std::is_const_v<typename decltype(v)::element_type>);
+  EXPECT_EQ(v.extents().extent(0), 3);
+  EXPECT_EQ(v.extents().extent(1), 4);
+  for (index_type i = 0; i < 3; ++i)
+    for (index_type j = 0; j < 4; ++j)
+      v[i, j] = int(10 * i + j);
+  EXPECT_EQ((v[2, 3]), 23);
+  EXPECT_EQ(&(v[1, 0]) - &(v[0, 0]), 4);
+}
@@ -0,0 +1,193 @@
+#include <uni20/tensor/expression.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <complex>
+#include <cstddef>
+
+using namespace uni20;
+
+namespace
+{
+
+using index_t = index_type;
+using extents_2d = stdex::dextents<index_t, 2>;
+using matrix = BasicTensor<double, extents_2d>;
+using cmatrix = BasicTensor<std::complex<double>, extents_2d>;
+
+template <typename Tensor> void fill(Tensor& t, double seed)
+{
+  for (index_t i = 0; i < t.extents().extent(0); ++i)
+    for (index_t j = 0; j < t.extents().extent(1); ++j)
+      t[i, j] = seed + 10 * i + j;
+}
+
+// evaluate an expression into dst the way assign() does, and return the number of temporaries allocated
+template <typename E, typename Dst> std::size_t temporaries(E const& e, Dst& dst)
+{
+  detail::expression_workspace ws;
+  detail::evaluate_into(seq, cpu_tag{}, as_expression(e), detail::as_dynamic_strided(dst.mutable_mdspan()), ws);
+  return ws.size();
+}
+
+TEST(TensorExpression, ConstructionIsLazy)
+{
+  matrix a(extents_2d{2, 3}), b(extents_2d{2, 3});
+  auto e = 2.0 * a - b;
+  static_assert(TensorExpression<decltype(e)>);
+  static_assert(std::is_same_v<decltype(e)::value_type, double>);
+  EXPECT_EQ(e.extents(), extents_2d(2, 3));
+
+  fill(a, 1);
+  fill(b, 0.5);
+  matrix d(extents_2d{2, 3});
+  assign(e, d);
+  EXPECT_EQ((d[1, 2]), 2.0 * (1 + 12) - (0.5 + 12));
+}
+
+TEST(TensorExpression, ElementwiseFusesWithoutTemporaries)
+{
+  matrix a(extents_2d{3, 4}), b(extents_2d{3, 4}), c(extents_2d{3, 4}), d(extents_2d{3, 4});
+  fill(a, 1);
+  fill(b, 2);
+  fill(c, -3);
+
+  auto e = 0.5 * a - b + hadamard(a, c) + (-c);
+  EXPECT_EQ(temporaries(e, d), 0u);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 4; ++j)
+      EXPECT_EQ((d[i, j]), (0.5 * a[i, j] - b[i, j] + a[i, j] * c[i, j] - c[i, j]));
+}
+
+TEST(TensorExpression, PermuteAndConj)
+{
+  cmatrix a(extents_2d{2, 3}), d(extents_2d{3, 2});
+  for (index_t i = 0; i < 2; ++i)
+    for (index_t j = 0; j < 3; ++j)
+      a[i, j] = {double(i), double(j + 1)};
+
+  assign(conj(permute(a, std::array<std::size_t, 2>{1, 0})), d);
+  for (index_t i = 0; i < 2; ++i)
+    for (index_t j = 0; j < 3; ++j)
+      EXPECT_EQ((d[j, i]), (std::conj(a[i, j])));
+}
+
+TEST(TensorExpression, UpdateFormulaCallsContractDirectly)
+{
+  // C = 0.5·C + 2·A·B lowers to a fused scaling of C followed by one contraction with beta = 1
+  matrix A(extents_2d{3, 4}), B(extents_2d{4, 2}), C(extents_2d{3, 2}), expected(extents_2d{3, 2});
+  fill(A, 1);
+  fill(B, -2);
+  fill(C, 0.25);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 2; ++j)
+    {
+      double ab = 0;
+      for (index_t k = 0; k < 4; ++k)
+        ab += A[i, k] * B[k, j];
+      expected[i, j] = 0.5 * C[i, j] + 2 * ab;
+    }
+
+  EXPECT_EQ(temporaries(0.5 * C + 2.0 * contract(A, B, {{1, 0}}), C), 0u);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 2; ++j)
+      EXPECT_DOUBLE_EQ((C[i, j]), (expected[i, j]));
+}
+
+TEST(TensorExpression, ContractionFoldsOperandScaleAndConj)
+{
+  using C = std::complex<double>;
+  cmatrix A(extents_2d{2, 3}), B(extents_2d{3, 2}), D(extents_2d{2, 2});
+  for (index_t i = 0; i < 2; ++i)
+    for (index_t k = 0; k < 3; ++k)
+    {
+      A[i, k] = {double(i + k), double(i - k)};
+      B[k, i] = {double(k), 1.0 + i};
+    }
+
+  EXPECT_EQ(temporaries(contract(conj(C(0, 2) * A), -B, {{1, 0}}), D), 0u);
+  for (index_t i = 0; i < 2; ++i)
+    for (index_t j = 0; j < 2; ++j)
+    {
+      C expected{};
+      for (index_t k = 0; k < 3; ++k)
+        expected += std::conj(C(0, 2) * A[i, k]) * -B[k, j];
+      EXPECT_NEAR(std::abs((D[i, j]) - expected), 0.0, 1e-12);
+    }
+}
+
+TEST(TensorExpression, PermutedContractionOutput)
+{
+  matrix A(extents_2d{3, 4}), B(extents_2d{4, 2}), D(extents_2d{2, 3});
+  fill(A, 1);
+  fill(B, 3);
+
+  assign(permute(contract(A, B, {{1, 0}}), std::array<std::size_t, 2>{1, 0}), D);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 2; ++j)
+    {
+      double ab = 0;
+      for (index_t k = 0; k < 4; ++k)
+        ab += A[i, k] * B[k, j];
+      EXPECT_EQ((D[j, i]), ab);
+    }
+}
+
+TEST(TensorExpression, TemporariesOnlyAtContractionBoundaries)
+{
+  matrix A(extents_2d{3, 3}), B(extents_2d{3, 3}), D(extents_2d{3, 3});
+  fill(A, 1);
+  fill(B, 2);
+
+  // a contraction inside an elementwise product, and a sum as a contraction operand
+  EXPECT_EQ(temporaries(hadamard(contract(A, B, {{1, 0}}), A), D), 1u);
+  auto nested = evaluate(hadamard(contract(A, B, {{1, 0}}), A));
+  EXPECT_EQ(temporaries(contract(A + B, B, {{1, 0}}), D), 1u);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 3; ++j)
+    {
+      double ab = 0, sum_b = 0;
+      for (index_t k = 0; k < 3; ++k)
+      {
+        ab += A[i, k] * B[k, j];
+        sum_b += (A[i, k] + B[i, k]) * B[k, j];
+      }
+      EXPECT_EQ((nested[i, j]), (ab * A[i, j]));
+      EXPECT_EQ((D[i, j]), sum_b);
+    }
+}
+
+TEST(TensorExpression, DestinationMayAppearInTheExpression)
+{
+  matrix A(extents_2d{3, 3}), B(extents_2d{3, 3}), original(extents_2d{3, 3});
+  fill(A, 1);
+  fill(B, 2);
+  assign(A, original);
+
+  // the transposed read of A overlaps the destination and is copied first
+  EXPECT_EQ(temporaries(A + permute(A, std::array<std::size_t, 2>{1, 0}), A), 1u);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 3; ++j)
+      EXPECT_EQ((A[i, j]), (original[i, j] + original[j, i]));
+
+  // A = A·B reads the old A as an operand of the kernel
+  assign(original, A);
+  assign(contract(A, B, {{1, 0}}), A);
+  for (index_t i = 0; i < 3; ++i)
+    for (index_t j = 0; j < 3; ++j)
+    {
+      double ab = 0;
+      for (index_t k = 0; k < 3; ++k)
+        ab += original[i, k] * B[k, j];
+      EXPECT_EQ((A[i, j]), ab);
+    }
+}
+
+TEST(TensorExpressionDeathTest, ShapeMismatch)
+{
+  matrix a(extents_2d{2, 3}), b(extents_2d{3, 2});
+  EXPECT_DEATH((void)(a + b), "shape mismatch");
+}
+
+} // namespace
@@ -0,0 +1,142 @@
+#include <uni20/storage/mmapstorage.hpp>
+#include <uni20/tensor/basic_tensor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace uni20;
+
+namespace
+{
+
+using extents_2d = stdex::dextents<index_type, 2>;
+using mmap_tensor = BasicTensor<double, extents_2d, MmapStorage>;
+
+/// Temporary file removed at the end of the test.
+class MmapStorageTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+      path = std::filesystem::temp_directory_path() /
+             ("uni20_mmap_" + std::to_string(::getpid()) + "_" +
+              ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin");
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    /// Write a 3×4 tensor with elements 10·i + j to the file.
+    void write_file()
+    {
+      mmap_tensor t(mmap_buffer<double>::create(path, 12), extents_2d{3, 4});
+      for (index_type i = 0; i < 3; ++i)
+        for (index_type j = 0; j < 4; ++j)
+          t[i, j] = double(10 * i + j);
+      std::as_const(t).storage().flush();
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_F(MmapStorageTest, CreateWritesThroughToFile)
+{
+  write_file();
+  EXPECT_EQ(std::filesystem::file_size(path), 12 * sizeof(double));
+
+  std::vector<double> contents(12);
+  std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(contents.data()), 12 * sizeof(double));
+  EXPECT_EQ(contents[0], 0.0);
+  EXPECT_EQ(contents[6], 12.0);
+  EXPECT_EQ(contents[11], 23.0);
+}
+
+TEST_F(MmapStorageTest, ReadOnlyMappingWorksWithMdspan)
+{
+  write_file();
+  mmap_tensor const t(mmap_buffer<double>::open(path), extents_2d{3, 4});
+  EXPECT_TRUE(t.storage().file_backed());
+  EXPECT_FALSE(t.storage().writable());
+  t.storage().advise(mmap_advice::sequential);
+  t.storage().advise(mmap_advice::willneed, 4, 4);
+
+  auto m = t.mdspan();
+  EXPECT_EQ((m[2, 3]), 23.0);
+  EXPECT_EQ(std::accumulate(t.storage().begin(), t.storage().end(), 0.0), 138.0);
+
+  // a second mapping of the same file sees the same contents
+  mmap_tensor const u(mmap_buffer<double>::open(path), extents_2d{4, 3});
+  EXPECT_EQ((u[3, 2]), 23.0);
+  u.storage().advise(mmap_advice::dontneed);
+  EXPECT_EQ((u[1, 0]), 3.0);
+}
+
+TEST_F(MmapStorageTest, ReadWriteAndCopyOnWriteModes)
+{
+  write_file();
+  {
+    mmap_tensor t(mmap_buffer<double>::open(path, mmap_mode::copy_on_write), extents_2d{3, 4});
+    t[0, 0] = -1.0;
+    EXPECT_EQ((std::as_const(t)[0, 0]), -1.0);
+  }
+  {
+    mmap_tensor t(mmap_buffer<double>::open(path, mmap_mode::read_write), extents_2d{3, 4});
+    EXPECT_EQ((std::as_const(t)[0, 0]), 0.0);
+    t[0, 1] = 99.0;
+    std::as_const(t).storage().flush(false);
+  }
+  mmap_tensor const t(mmap_buffer<double>::open(path), extents_2d{3, 4});
+  EXPECT_EQ((t[0, 0]), 0.0);
+  EXPECT_EQ((t[0, 1]), 99.0);
+}
+
+TEST_F(MmapStorageTest, CopiesAreIndependentOfFile)
+{
+  write_file();
+  mmap_tensor a(mmap_buffer<double>::open(path), extents_2d{3, 4});
+  mmap_tensor b = std::as_const(a);
+  EXPECT_FALSE(std::as_const(b).storage().file_backed());
+  b[1, 1] = 0.5;
+  EXPECT_EQ((std::as_const(a)[1, 1]), 11.0);
+  EXPECT_EQ((std::as_const(b)[2, 3]), 23.0);
+}
+
+TEST_F(MmapStorageTest, WriteToReadOnlyMappingIsPreconditionFailure)
+{
+  write_file();
+  mmap_tensor t(mmap_buffer<double>::open(path), extents_2d{3, 4});
+  EXPECT_DEATH((t[0, 0] = 1.0), "read-only");
+}
+
+TEST_F(MmapStorageTest, OpenMissingFileThrows)
+{
+  EXPECT_THROW((void)mmap_buffer<double>::open(path), std::system_error);
+}
+
+TEST(MmapStorage, DefaultTensorIsAnonymousAndZeroed)
+{
+  mmap_tensor t(extents_2d{100, 100});
+  EXPECT_FALSE(std::as_const(t).storage().file_backed());
+  EXPECT_EQ((std::as_const(t)[99, 99]), 0.0);
+  t[99, 99] = 2.0;
+  EXPECT_EQ((std::as_const(t)[99, 99]), 2.0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(std::as_const(t).handle()) % 4096, 0u);
+}
+
+TEST(BasicTensorAdoptStorage, StorageTooSmallIsPreconditionFailure)
+{
+  using tensor_type = BasicTensor<int, extents_2d>;
+  tensor_type t(std::vector<int>{1, 2, 3, 4, 5, 6}, extents_2d{2, 3});
+  EXPECT_EQ((std::as_const(t)[1, 0]), 4);
+  EXPECT_DEATH((tensor_type(std::vector<int>(5), extents_2d{2, 3})), "smaller than the layout");
+}
@@ -0,0 +1,73 @@
+#include <uni20/tensor/permute.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+using namespace uni20;
+
+namespace
+{
+
+using index_t = index_type;
+using extents_3d = stdex::dextents<index_t, 3>;
+using tensor3 = BasicTensor<double, extents_3d>;
+
+template <typename Tensor> void fill(Tensor& t)
+{
+  for (index_t i = 0; i < t.extents().extent(0); ++i)
+    for (index_t j = 0; j < t.extents().extent(1); ++j)
+      for (index_t k = 0; k < t.extents().extent(2); ++k)
+        t[i, j, k] = 10000 * i + 100 * j + k;
+}
+
+TEST(TensorPermute, PermutedReturnsRowMajorTensor)
+{
+  tensor3 a(extents_3d{12, 5, 33});
+  fill(a);
+
+  auto b = permuted(a, std::array<std::size_t, 3>{2, 0, 1});
+  static_assert(std::is_same_v<decltype(b)::storage_policy, UninitializedStorage>);
+  EXPECT_EQ(b.extents(), extents_3d(33, 12, 5));
+  EXPECT_EQ(b.mapping().stride(0), 60);
+  EXPECT_EQ(b.mapping().stride(2), 1);
+  for (index_t i = 0; i < 12; ++i)
+    for (index_t j = 0; j < 5; ++j)
+      for (index_t k = 0; k < 33; ++k)
+        EXPECT_EQ((b[k, i, j]), (a[i, j, k]));
+}
+
+TEST(TensorPermute, ScaledIntoViewInParallel)
+{
+  tensor3 a(extents_3d{40, 3, 50}), b(extents_3d{50, 3, 40});
+  fill(a);
+  for (index_t k = 0; k < 50; ++k)
+    for (index_t j = 0; j < 3; ++j)
+      for (index_t i = 0; i < 40; ++i)
+        b[k, j, i] = 1;
+
+  permute(par.with_min_size(1), 2.0, a.const_view(), std::array<std::size_t, 3>{2, 1, 0}, -1.0, b.view());
+  for (index_t i = 0; i < 40; ++i)
+    for (index_t j = 0; j < 3; ++j)
+      for (index_t k = 0; k < 50; ++k)
+        EXPECT_EQ((b[k, j, i]), (2 * a[i, j, k] - 1));
+}
+
+TEST(TensorPermute, AssignedLazyPermutationUsesKernel)
+{
+  using cmatrix = BasicTensor<std::complex<double>, stdex::dextents<index_t, 2>>;
+  cmatrix a(stdex::dextents<index_t, 2>{37, 70}), b(stdex::dextents<index_t, 2>{70, 37});
+  for (index_t i = 0; i < 37; ++i)
+    for (index_t j = 0; j < 70; ++j)
+      a[i, j] = {double(i), double(j)};
+
+  assign(permute(a, std::array<std::size_t, 2>{1, 0}), b);
+  for (index_t i = 0; i < 37; ++i)
+    for (index_t j = 0; j < 70; ++j)
+      EXPECT_EQ((b[j, i]), (a[i, j]));
+}
+
+} // namespace
@@ -0,0 +1,148 @@
+#include <uni20/tensor/basic_tensor.hpp>
+#include <uni20/tensor/view_ops.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <type_traits>
+
+using namespace uni20;
+
+namespace
+{
+
+using index_t = index_type;
+using extents_3d = stdex::dextents<index_t, 3>;
+using tensor3 = BasicTensor<double, extents_3d>;
+
+void fill(tensor3& t)
+{
+  for (index_t i = 0; i < t.extents().extent(0); ++i)
+    for (index_t j = 0; j < t.extents().extent(1); ++j)
+      for (index_t k = 0; k < t.extents().extent(2); ++k)
+        t[i, j, k] = 10000 * i + 100 * j + k;
+}
+
+} // namespace
+
+TEST(TensorViewOps, SubrangeWritesThroughToTheTensor)
+{
+  tensor3 a(extents_3d{4, 5, 6});
+  fill(a);
+
+  auto s = subrange(a, std::array<index_t, 3>{1, 2, 3}, std::array<index_t, 3>{3, 5, 6});
+  EXPECT_EQ(s.extents(), extents_3d(2, 3, 3));
+  EXPECT_EQ((s[0, 0, 0]), (a[1, 2, 3]));
+  EXPECT_EQ((s[1, 2, 2]), (a[2, 4, 5]));
+
+  s[1, 1, 1] = -1;
+  EXPECT_EQ((a[2, 3, 4]), -1);
+
+  auto t = subrange(a, 2, 1, 4);
+  EXPECT_EQ(t.extents(), extents_3d(4, 5, 3));
+  EXPECT_EQ((t[3, 4, 0]), (a[3, 4, 1]));
+}
+
+TEST(TensorViewOps, ConstTensorGivesReadOnlyViews)
+{
+  tensor3 a(extents_3d{4, 5, 6});
+  fill(a);
+  tensor3 const& c = a;
+
+  auto s = slice(c, 1, 2);
+  static_assert(std::is_const_v<std::remove_reference_t<decltype(s[0, 0])>>);
+  auto m = slice(a, 1, 2);
+  static_assert(!std::is_const_v<std::remove_reference_t<decltype(m[0, 0])>>);
+
+  EXPECT_EQ(s.extents(), (stdex::dextents<index_t, 2>(4, 6)));
+  for (index_t i = 0; i < 4; ++i)
+    for (index_t k = 0; k < 6; ++k)
+      EXPECT_EQ((s[i, k]), (a[i, 2, k]));
+}
+
+TEST(TensorViewOps, DiagonalSumsStrides)
+{
+  tensor3 a(extents_3d{5, 3, 5});
+  fill(a);
+
+  auto d = diagonal(a.view(), 2, 0);
+  EXPECT_EQ(d.extents(), (stdex::dextents<index_t, 2>(5, 3)));
+  EXPECT_EQ(d.mapping().stride(0), a.mapping().stride(0) + a.mapping().stride(2));
+  for (index_t i = 0; i < 5; ++i)
+    for (index_t j = 0; j < 3; ++j)
+      EXPECT_EQ((d[i, j]), (a[i, j, i]));
+}
+
+TEST(TensorViewOps, SplitAndFuseLegsRoundTrip)
+{
+  tensor3 a(extents_3d{4, 6, 5});
+  fill(a);
+
+  auto s = split_leg(a, 1, std::array<index_t, 2>{2, 3});
+  EXPECT_EQ(s.extents(), (stdex::dextents<index_t, 4>(4, 2, 3, 5)));
+  for (index_t j = 0; j < 6; ++j)
+    EXPECT_EQ((s[3, j / 3, j % 3, 4]), (a[3, j, 4]));
+
+  auto f = fuse_legs<2>(s, 1);
+  EXPECT_EQ(f.extents(), a.extents());
+  for (index_t j = 0; j < 6; ++j)
+    EXPECT_EQ((f[2, j, 1]), (a[2, j, 1]));
+
+  auto all = fuse_legs<3>(a, 0);
+  EXPECT_EQ(all.extents().extent(0), 120);
+  EXPECT_EQ((all[37]), (a[1, 1, 2]));
+}
+
+TEST(TensorViewOps, FusingNonContiguousLegsReportsCopy)
+{
+  tensor3 a(extents_3d{4, 6, 5});
+  fill(a);
+
+  // the last leg of a subrange no longer nests inside the one before it
+  auto s = subrange(a, 2, 0, 4);
+  EXPECT_FALSE(try_fuse_legs<2>(s, 1).has_value());
+  auto outer = try_fuse_legs<2>(s, 0);
+  ASSERT_TRUE(outer.has_value());
+  EXPECT_EQ(((*outer)[13, 2]), (a[2, 1, 2]));
+
+  EXPECT_DEATH(fuse_legs<2>(s, 1), "needs a copy");
+}
+
+TEST(TensorViewOps, ReshapeFollowsRowMajorOrder)
+{
+  tensor3 a(extents_3d{4, 6, 5});
+  fill(a);
+
+  auto r = reshape(a, std::array<index_t, 4>{2, 12, 1, 5});
+  for (index_t n = 0; n < 120; ++n)
+    EXPECT_EQ((r[n / 60, n / 5 % 12, 0, n % 5]), (a[n / 30, n / 5 % 6, n % 5]));
+
+  // a slice along the middle leg keeps the outer and inner legs separable but not fusable
+  auto m = slice(a, 1, 3);
+  EXPECT_TRUE(try_reshape(m, std::array<index_t, 3>{2, 2, 5}).has_value());
+  EXPECT_FALSE(try_reshape(m, std::array<index_t, 1>{20}).has_value());
+
+  auto e = subrange(a, 0, 2, 2);
+  EXPECT_TRUE(try_reshape(e, std::array<index_t, 2>{0, 7}).has_value());
+
+  EXPECT_DEATH(reshape(a, std::array<index_t, 2>{7, 7}), "number of elements");
+}
+
+TEST(TensorViewOps, BroadcastToRepeatsWithZeroStride)
+{
+  BasicTensor<double, stdex::dextents<index_t, 2>> v(stdex::dextents<index_t, 2>{5, 1});
+  for (index_t i = 0; i < 5; ++i)
+    v[i, 0] = i;
+
+  auto b = broadcast_to(v, std::array<index_t, 3>{3, 5, 4});
+  static_assert(std::is_const_v<std::remove_reference_t<decltype(b[0, 0, 0])>>);
+  EXPECT_EQ(b.extents(), extents_3d(3, 5, 4));
+  EXPECT_EQ(b.mapping().stride(0), 0);
+  EXPECT_EQ(b.mapping().stride(2), 0);
+  for (index_t n = 0; n < 3; ++n)
+    for (index_t i = 0; i < 5; ++i)
+      for (index_t k = 0; k < 4; ++k)
+        EXPECT_EQ((b[n, i, k]), i);
+
+  EXPECT_DEATH(broadcast_to(v, std::array<index_t, 2>{4, 4}), "incompatible extents");
+}